@@ -23,7 +23,9 @@ typedef struct {
 	int mIsGuardingLogicActive;
 	int mWasGuardingSuccessful;
 
-	vector<string> mCommandNames; 
+	int mCommandAmount;
+	int mHoldForwardLookupIndex;
+	int mHoldBackLookupIndex;
 } PlayerAI;
 
 static struct {
@@ -38,8 +40,7 @@ static void loadAIHandler(void* tData) {
 
 static int unloadSingleHandledPlayer(void* tCaller, PlayerAI& tData) {
 	(void)tCaller;
-	PlayerAI* e = &tData;
-	stl_delete_vector(e->mCommandNames);
+	(void)tData;
 	return 1;
 }
 
@@ -50,18 +51,16 @@ static void unloadAIHandler(void* tData) {
 }
 
 static void setRandomPlayerCommandActive(PlayerAI* e) {
-	int i = randfromInteger(0, e->mCommandNames.size() - 1);
+	int i = randfromInteger(0, e->mCommandAmount - 1);
 
-	const string& name = e->mCommandNames[i];
-
-	setDreamPlayerCommandActiveForAI(e->mPlayer->mCommandID, name.data(), 2);
+	setDreamPlayerCommandActiveForAIByLookupIndex(e->mPlayer->mCommandID, i, 2);
 }
 
 static void updateAIMovement(PlayerAI* e) {
 	double dist = getPlayerDistanceToFrontOfOtherPlayerX(e->mPlayer);
 
-	if (e->mIsMoving) {
-		setDreamPlayerCommandActiveForAI(e->mPlayer->mCommandID, "holdfwd", 2);
+	if (e->mIsMoving && e->mHoldForwardLookupIndex != -1) {
+		setDreamPlayerCommandActiveForAIByLookupIndex(e->mPlayer->mCommandID, e->mHoldForwardLookupIndex, 2);
 	}
 
 	if (dist > 50) {
@@ -88,8 +87,8 @@ static void updateAIGuarding(PlayerAI* e) {
 		e->mIsGuardingLogicActive = 0;
 	}
 
-	if (e->mIsGuardingLogicActive && e->mWasGuardingSuccessful) {
-		setDreamPlayerCommandActiveForAI(e->mPlayer->mCommandID, "holdback", 2);
+	if (e->mIsGuardingLogicActive && e->mWasGuardingSuccessful && e->mHoldBackLookupIndex != -1) {
+		setDreamPlayerCommandActiveForAIByLookupIndex(e->mPlayer->mCommandID, e->mHoldBackLookupIndex, 2);
 	}
 }
 
@@ -129,9 +128,10 @@ static void updateAIHandler(void* tData) {
 	stl_list_map(gAI.mHandledPlayers, updateSingleAI);
 }
 
-static void insertSingleCommandName(vector<string>* tCaller, const string& tKey, DreamMugenCommand& tData) {
-	(void)tData;
-	tCaller->push_back(tKey);
+static int getAICommandLookupIndex(DreamPlayer* p, const char* tCommandName) {
+	int ret;
+	if (!isDreamCommandForLookup(p->mCommandID, tCommandName, &ret)) return -1;
+	return ret;
 }
 
 void setDreamAIActive(DreamPlayer * p)
@@ -144,11 +144,11 @@ void setDreamAIActive(DreamPlayer * p)
 	e.mRandomInputDuration = 20;
 	e.mIsMoving = 0;
 	e.mIsGuardingLogicActive = 0;
-	e.mCommandNames.clear();
 	e.mDifficultyFactor = (getPlayerAILevel(p) - 1) / 7.0;
 
-	DreamMugenCommands* commands = &p->mHeader->mFiles.mCommands;
-	stl_string_map_map(commands->mCommands, insertSingleCommandName, &e.mCommandNames);
+	e.mCommandAmount = getDreamPlayerCommandAmount(p->mCommandID);
+	e.mHoldForwardLookupIndex = getAICommandLookupIndex(p, "holdfwd");
+	e.mHoldBackLookupIndex = getAICommandLookupIndex(p, "holdback");
 
 	gAI.mHandledPlayers.push_back(e);
 }
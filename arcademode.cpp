@@ -8,6 +8,7 @@
 #include <prism/log.h>
 
 #include "characterselectscreen.h"
+#include "fileindex.h"
 #include "titlescreen.h"
 #include "storyscreen.h"
 #include "playerdefinition.h"
@@ -103,7 +104,7 @@ static void addSingleEnemyToSelection(void* tCaller, void* tData) {
 	e->mIsSelected = 0;
 	e->mOrder = 1;
 	getCharacterSelectNamePath(stringVector.mElement[0], e->mDefinitionPath);
-	if (!isFile(e->mDefinitionPath)) {
+	if (!isIndexedFile(e->mDefinitionPath)) {
 		logWarningFormat("Unable to find def file %s. Ignoring character.", e->mDefinitionPath);
 		freeMemory(e);
 		return;
@@ -218,7 +219,7 @@ static void startEnding() {
 	if (gArcadeModeData.mHasEnding) {
 		endingDefinitionFile = getAllocatedMugenDefStringVariable(&script, "Arcade", "ending.storyboard");
 		sprintf(path, "%s%s", folder, endingDefinitionFile);
-		if (isFile(path)) {
+		if (isIndexedFile(path)) {
 			setStoryDefinitionFile(path);
 			setStoryScreenFinishedCB(endingScreenFinishedCB);
 			setNewScreen(getStoryScreen());
@@ -282,7 +283,7 @@ static void characterSelectFinishedCB() {
 	if (hasIntro) {
 		introDefinitionFile = getAllocatedMugenDefStringVariable(&script, "Arcade", "intro.storyboard");
 		sprintf(path, "%s%s", folder, introDefinitionFile);
-		if (isFile(path)) {
+		if (isIndexedFile(path)) {
 			setStoryDefinitionFile(path);
 			setStoryScreenFinishedCB(introScreenFinishedCB);
 			isGoingToStory = 1;
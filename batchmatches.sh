@@ -0,0 +1,47 @@
+#!/bin/sh
+# usage: batchmatches.sh <game binary> <match list> <worker amount> <report prefix>
+# match list lines are "p1.def","p2.def","stage.def",seed, e.g. created with <game binary> --generate-matches assets/data/select.def <amount> <seed> <match list>
+
+if [ $# -lt 4 ]; then
+	echo "usage: $0 <game binary> <match list> <worker amount> <report prefix>"
+	exit 1
+fi
+
+BINARY=$1
+MATCHES=$2
+WORKERS=$3
+REPORT=$4
+
+i=0
+while [ $i -lt $WORKERS ]; do
+	"$BINARY" --batch "$MATCHES" $i $WORKERS "$REPORT.worker$i.csv" > "$REPORT.worker$i.log" 2>&1 &
+	i=$((i + 1))
+done
+wait
+
+head -n 1 "$REPORT.worker0.csv" > "$REPORT.csv"
+i=0
+while [ $i -lt $WORKERS ]; do
+	tail -n +2 "$REPORT.worker$i.csv" >> "$REPORT.csv"
+	rm "$REPORT.worker$i.csv"
+	i=$((i + 1))
+done
+
+awk 'function splitcsv(line, field, quoted,    n, i, c, inquote) {
+		n = 1; field[1] = ""; quoted[1] = 0; inquote = 0
+		for (i = 1; i <= length(line); i++) {
+			c = substr(line, i, 1)
+			if (inquote && c == "\"" && substr(line, i + 1, 1) == "\"") { field[n] = field[n] c; i++ }
+			else if (c == "\"") { inquote = !inquote; quoted[n] = 1 }
+			else if (!inquote && c == ",") { n++; field[n] = ""; quoted[n] = 0 }
+			else field[n] = field[n] c
+		}
+		return n
+	}
+	function jsonstring(s) { gsub(/\\/, "\\\\", s); gsub(/"/, "\\\"", s); return "\"" s "\"" }
+	{ sub(/\r$/, "") }
+	NR == 1 { amount = splitcsv($0, key, keyquoted); print "["; next }
+	{ splitcsv($0, value, quoted); if (NR > 2) print ","; printf "  {"; for (i = 1; i <= amount; i++) { if (i > 1) printf ", "; if (!quoted[i] && value[i] ~ /^-?[0-9.]+(e[-+]?[0-9]+)?$/) printf "%s: %s", jsonstring(key[i]), value[i]; else printf "%s: %s", jsonstring(key[i]), jsonstring(value[i]) } printf "}" }
+	END { print ""; print "]" }' "$REPORT.csv" > "$REPORT.json"
+
+echo "$(tail -n +2 "$REPORT.csv" | wc -l) matches written to $REPORT.csv and $REPORT.json"
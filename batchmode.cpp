@@ -0,0 +1,234 @@
+#include "batchmode.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <sstream>
+
+#include <prism/file.h>
+#include <prism/log.h>
+#include <prism/math.h>
+#include <prism/mugendefreader.h>
+
+#include "headlessmode.h"
+#include "characterselectscreen.h"
+#include "playerdefinition.h"
+#include "stage.h"
+
+using namespace std;
+
+typedef struct {
+	string mPlayer1Path;
+	string mPlayer2Path;
+	string mStagePath;
+	unsigned int mSeed;
+} BatchMatch;
+
+typedef enum {
+	BATCH_MODE_NONE,
+	BATCH_MODE_GENERATE,
+	BATCH_MODE_RUN,
+} BatchModeType;
+
+static struct {
+	BatchModeType mType;
+	string mInputPath;
+	string mOutputPath;
+
+	int mGenerateAmount;
+	unsigned int mGenerateSeed;
+
+	int mWorkerIndex;
+	int mWorkerAmount;
+	int mHasStartedRun;
+	vector<BatchMatch> mMatches;
+	int mCurrentMatch;
+	stringstream mResults;
+} gBatchModeData;
+
+int parseBatchModeArguments(int argc, char** argv)
+{
+	gBatchModeData.mType = BATCH_MODE_NONE;
+	if (argc >= 6 && !strcmp("--generate-matches", argv[1])) {
+		gBatchModeData.mInputPath = argv[2];
+		gBatchModeData.mGenerateAmount = atoi(argv[3]);
+		gBatchModeData.mGenerateSeed = (unsigned int)strtoul(argv[4], NULL, 10);
+		gBatchModeData.mOutputPath = argv[5];
+		gBatchModeData.mType = BATCH_MODE_GENERATE;
+	}
+	else if (argc >= 6 && !strcmp("--batch", argv[1])) {
+		gBatchModeData.mInputPath = argv[2];
+		gBatchModeData.mWorkerIndex = atoi(argv[3]);
+		gBatchModeData.mWorkerAmount = atoi(argv[4]) > 0 ? atoi(argv[4]) : 1;
+		gBatchModeData.mOutputPath = argv[5];
+		gBatchModeData.mType = BATCH_MODE_RUN;
+		gBatchModeData.mHasStartedRun = 0;
+	}
+	return gBatchModeData.mType != BATCH_MODE_NONE;
+}
+
+static void writeTextFile(const string& tPath, const string& tText) {
+	bufferToFile(tPath.c_str(), makeBuffer((void*)tText.c_str(), (uint32_t)tText.size()));
+}
+
+static string quoteCsvField(const string& tField) {
+	string ret = "\"";
+	for (const auto c : tField) {
+		if (c == '"') ret.push_back('"');
+		ret.push_back(c);
+	}
+	ret.push_back('"');
+	return ret;
+}
+
+static vector<string> splitCsvLine(const string& tLine) {
+	vector<string> ret(1);
+	int isQuoted = 0;
+	size_t i;
+	for (i = 0; i < tLine.size(); i++) {
+		const char c = tLine[i];
+		if (isQuoted && c == '"' && i + 1 < tLine.size() && tLine[i + 1] == '"') {
+			ret.back().push_back('"');
+			i++;
+		}
+		else if (c == '"') {
+			isQuoted = !isQuoted;
+		}
+		else if (!isQuoted && c == ',') {
+			ret.push_back("");
+		}
+		else {
+			ret.back().push_back(c);
+		}
+	}
+	return ret;
+}
+
+static void generateMatches() {
+	MugenDefScript script;
+	loadMugenDefScript(&script, gBatchModeData.mInputPath.c_str());
+
+	srand(gBatchModeData.mGenerateSeed);
+	stringstream ss;
+	char player1Path[1024];
+	char player2Path[1024];
+	char stagePath[1024];
+	int i;
+	for (i = 0; i < gBatchModeData.mGenerateAmount; i++) {
+		setCharacterRandom(&script, 0);
+		setCharacterRandom(&script, 1);
+		setStageRandom(&script);
+		getPlayerDefinitionPath(player1Path, 0);
+		getPlayerDefinitionPath(player2Path, 1);
+		getDreamStageMugenDefinitionPath(stagePath);
+		ss << quoteCsvField(player1Path) << "," << quoteCsvField(player2Path) << "," << quoteCsvField(stagePath) << "," << (unsigned int)rand() << endl;
+	}
+
+	unloadMugenDefScript(script);
+	writeTextFile(gBatchModeData.mOutputPath, ss.str());
+	logFormat("Generated %d matches to %s.", gBatchModeData.mGenerateAmount, gBatchModeData.mOutputPath.c_str());
+}
+
+static void loadMatches() {
+	gBatchModeData.mMatches.clear();
+	if (!isFile(gBatchModeData.mInputPath.c_str())) {
+		logWarningFormat("Unable to find match list %s.", gBatchModeData.mInputPath.c_str());
+		return;
+	}
+
+	Buffer b = fileToBuffer(gBatchModeData.mInputPath.c_str());
+	stringstream ss(string((const char*)b.mData, b.mLength));
+	freeBuffer(b);
+
+	string line;
+	int index = 0;
+	while (getline(ss, line)) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line.empty() || line[0] == '#') continue;
+
+		const auto fields = splitCsvLine(line);
+		if (fields.size() != 4) {
+			logWarningFormat("Unable to parse match line %s. Ignore.", line.c_str());
+			continue;
+		}
+		BatchMatch e;
+		e.mPlayer1Path = fields[0];
+		e.mPlayer2Path = fields[1];
+		e.mStagePath = fields[2];
+		e.mSeed = (unsigned int)strtoul(fields[3].c_str(), NULL, 10);
+
+		if (index % gBatchModeData.mWorkerAmount == gBatchModeData.mWorkerIndex) {
+			gBatchModeData.mMatches.push_back(e);
+		}
+		index++;
+	}
+}
+
+static void startBatchRun() {
+	loadMatches();
+	gBatchModeData.mCurrentMatch = 0;
+	gBatchModeData.mResults.str("");
+	gBatchModeData.mResults << "p1,p2,stage,seed,status,winner,rounds,frames,seconds,ticks_per_second" << endl;
+	writeTextFile(gBatchModeData.mOutputPath, gBatchModeData.mResults.str());
+	logFormat("Worker %d of %d runs %d matches.", gBatchModeData.mWorkerIndex, gBatchModeData.mWorkerAmount, (int)gBatchModeData.mMatches.size());
+}
+
+static void addMatchResult(const BatchMatch& tMatch, const char* tStatus, const HeadlessFightResult& tResult) {
+	gBatchModeData.mResults << quoteCsvField(tMatch.mPlayer1Path) << "," << quoteCsvField(tMatch.mPlayer2Path) << "," << quoteCsvField(tMatch.mStagePath) << "," << tMatch.mSeed << "," << quoteCsvField(tStatus) << ","
+		<< tResult.mWinnerIndex << "," << tResult.mRoundAmount << "," << tResult.mFrameAmount << "," << tResult.mSeconds << "," << tResult.mTicksPerSecond << endl;
+	writeTextFile(gBatchModeData.mOutputPath, gBatchModeData.mResults.str());
+}
+
+static void matchFinishedCB() {
+	addMatchResult(gBatchModeData.mMatches[gBatchModeData.mCurrentMatch], "ok", getHeadlessFightResult());
+	gBatchModeData.mCurrentMatch++;
+	setNewScreen(getBatchModeScreen());
+}
+
+static int isMatchLoadable(const BatchMatch& tMatch) {
+	return isFile(tMatch.mPlayer1Path.c_str()) && isFile(tMatch.mPlayer2Path.c_str()) && isFile(tMatch.mStagePath.c_str());
+}
+
+static void startNextMatch() {
+	while (gBatchModeData.mCurrentMatch < (int)gBatchModeData.mMatches.size()) {
+		const BatchMatch& match = gBatchModeData.mMatches[gBatchModeData.mCurrentMatch];
+		if (isMatchLoadable(match)) {
+			srand(match.mSeed);
+			startHeadlessMode(match.mPlayer1Path.c_str(), match.mPlayer2Path.c_str(), match.mStagePath.c_str(), matchFinishedCB, NULL); // the worker writes its own results file
+			return;
+		}
+
+		logWarningFormat("Unable to find files for match %d. Skip.", gBatchModeData.mCurrentMatch);
+		HeadlessFightResult emptyResult;
+		memset(&emptyResult, 0, sizeof(HeadlessFightResult));
+		emptyResult.mWinnerIndex = -1;
+		addMatchResult(match, "missing", emptyResult);
+		gBatchModeData.mCurrentMatch++;
+	}
+
+	logFormat("Worker %d finished, results in %s.", gBatchModeData.mWorkerIndex, gBatchModeData.mOutputPath.c_str());
+	abortScreenHandling();
+}
+
+static void loadBatchModeScreen() {
+	if (gBatchModeData.mType == BATCH_MODE_GENERATE) {
+		generateMatches();
+		abortScreenHandling();
+		return;
+	}
+
+	if (!gBatchModeData.mHasStartedRun) {
+		startBatchRun();
+		gBatchModeData.mHasStartedRun = 1;
+	}
+	startNextMatch();
+}
+
+static Screen gBatchModeScreen;
+
+Screen* getBatchModeScreen()
+{
+	gBatchModeScreen = makeScreen(loadBatchModeScreen);
+	return &gBatchModeScreen;
+}
@@ -0,0 +1,6 @@
+#pragma once
+
+#include <prism/wrapper.h>
+
+int parseBatchModeArguments(int argc, char** argv);
+Screen* getBatchModeScreen();
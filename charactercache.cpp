@@ -0,0 +1,681 @@
+#include "charactercache.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+#include <prism/file.h>
+#include <prism/log.h>
+#include <prism/system.h>
+#include <prism/stlutil.h>
+#include <prism/memoryhandler.h>
+#include <prism/mugendefreader.h>
+
+#include "characterselectscreen.h"
+#include "charactercacheimage.h"
+#include "fileindex.h"
+#include "fightpreload.h"
+#include "mugenassignmentevaluator.h"
+#include "mugenstatecontrollers.h"
+
+using namespace std;
+
+#define CHARACTER_CACHE_MAGIC 0x48434344
+#define CHARACTER_CACHE_VERSION 2
+#define CHARACTER_CACHE_ALIGNMENT 8
+
+typedef enum {
+	CHARACTER_CACHE_KIND_COMMANDS = 1,
+	CHARACTER_CACHE_KIND_STATES = 2,
+} CharacterCacheKind;
+
+typedef struct {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mKind;
+	uint32_t mLayoutStamp;
+	uint32_t mFunctionTableStamp;
+	uint32_t mSourceAmount;
+	uint32_t mSourceTableSize;
+	uint32_t mPayloadSize;
+} CharacterCacheHeader;
+
+typedef struct {
+	string mPath;
+	uint64_t mSize;
+	int64_t mTime;
+} CharacterCacheSource;
+
+typedef struct {
+	const uint8_t* mData;
+	size_t mSize;
+	size_t mPosition;
+	int mHasFailed;
+} CharacterCacheReader;
+
+static struct {
+	map<string, vector<uint8_t> > mPreparedFiles;
+	map<const DreamMugenConstants*, vector<uint8_t> > mLoadedStateFiles;
+	int mMissAmount;
+} gCharacterCacheData;
+
+static uint32_t getCommandsLayoutStamp() {
+	return (uint32_t)(MUGEN_COMMAND_INPUT_STEP_TARGET_MULTI_BACKWARD + 1);
+}
+
+// the image is copied byte for byte, so every file that defines part of its layout contributes its build id
+static uint32_t getStatesLayoutStamp() {
+	uint32_t ret = addDreamCharacterCacheImageLayoutStamp(getDreamMugenConstantsCacheLayoutStamp(), (uint32_t)sizeof(void*));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenConstantsHeader));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenConstantsSizeData));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenConstantsVelocityData));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenConstantsMovementData));
+	return ret;
+}
+
+static int getSourceStamp(const char* tPath, uint64_t* oSize, int64_t* oTime) {
+	struct stat s;
+	if (stat(tPath, &s)) return 0;
+	*oSize = (uint64_t)s.st_size;
+	*oTime = (int64_t)s.st_mtime;
+	return 1;
+}
+
+static int getSourceStamps(const vector<string>& tPaths, vector<CharacterCacheSource>& oSources) {
+	oSources.clear();
+	for (auto& path : tPaths) {
+		CharacterCacheSource e;
+		e.mPath = path;
+		if (!getSourceStamp(path.c_str(), &e.mSize, &e.mTime)) return 0;
+		oSources.push_back(e);
+	}
+	return 1;
+}
+
+static string getCachePath(const string& tPath) {
+	return tPath + ".cache";
+}
+
+static void writeBytes(vector<uint8_t>& tStream, const void* tData, size_t tSize) {
+	const uint8_t* data = (const uint8_t*)tData;
+	tStream.insert(tStream.end(), data, data + tSize);
+}
+
+static void writeUInt8(vector<uint8_t>& tStream, uint8_t tValue) {
+	tStream.push_back(tValue);
+}
+
+static void writeInt32(vector<uint8_t>& tStream, int32_t tValue) {
+	writeBytes(tStream, &tValue, sizeof(int32_t));
+}
+
+static void readBytes(CharacterCacheReader* tReader, void* oData, size_t tSize) {
+	if (tReader->mHasFailed || tReader->mPosition + tSize > tReader->mSize) {
+		tReader->mHasFailed = 1;
+		memset(oData, 0, tSize);
+		return;
+	}
+	memcpy(oData, tReader->mData + tReader->mPosition, tSize);
+	tReader->mPosition += tSize;
+}
+
+static uint8_t readUInt8(CharacterCacheReader* tReader) {
+	uint8_t ret;
+	readBytes(tReader, &ret, sizeof(uint8_t));
+	return ret;
+}
+
+static int32_t readInt32(CharacterCacheReader* tReader) {
+	int32_t ret;
+	readBytes(tReader, &ret, sizeof(int32_t));
+	return ret;
+}
+
+static CharacterCacheHeader getCacheHeader(const vector<uint8_t>& tFile) {
+	CharacterCacheHeader ret;
+	memcpy(&ret, tFile.data(), sizeof(CharacterCacheHeader));
+	return ret;
+}
+
+static uint8_t* getCachePayload(vector<uint8_t>& tFile, uint32_t* oSize) {
+	const CharacterCacheHeader header = getCacheHeader(tFile);
+	*oSize = header.mPayloadSize;
+	return tFile.data() + sizeof(CharacterCacheHeader) + header.mSourceTableSize;
+}
+
+// the sources are validated on size and modification time only, the function table stamp needs the main thread and is checked on load
+static int parseCacheFile(const vector<uint8_t>& tFile, CharacterCacheKind tKind, uint32_t tLayoutStamp, const vector<string>& tSourcePaths) {
+	if (tFile.size() < sizeof(CharacterCacheHeader)) return 0;
+
+	const CharacterCacheHeader header = getCacheHeader(tFile);
+	if (header.mMagic != CHARACTER_CACHE_MAGIC || header.mVersion != CHARACTER_CACHE_VERSION || header.mKind != (uint32_t)tKind || header.mLayoutStamp != tLayoutStamp || header.mSourceAmount != tSourcePaths.size()) return 0;
+	const uint64_t payloadOffset = sizeof(CharacterCacheHeader) + (uint64_t)header.mSourceTableSize;
+	if (payloadOffset % CHARACTER_CACHE_ALIGNMENT || payloadOffset + header.mPayloadSize != tFile.size()) return 0;
+
+	CharacterCacheReader reader;
+	reader.mData = tFile.data();
+	reader.mSize = (size_t)payloadOffset;
+	reader.mPosition = sizeof(CharacterCacheHeader);
+	reader.mHasFailed = 0;
+	for (auto& path : tSourcePaths) {
+		const int32_t pathLength = readInt32(&reader);
+		if (reader.mHasFailed || pathLength != (int32_t)path.size() || reader.mPosition + pathLength > reader.mSize || memcmp(reader.mData + reader.mPosition, path.data(), pathLength)) return 0;
+		reader.mPosition += pathLength;
+
+		uint64_t size, sourceSize;
+		int64_t time, sourceTime;
+		readBytes(&reader, &size, sizeof(uint64_t));
+		readBytes(&reader, &time, sizeof(int64_t));
+		if (reader.mHasFailed || !getSourceStamp(path.c_str(), &sourceSize, &sourceTime) || size != sourceSize || time != sourceTime) return 0;
+	}
+	return 1;
+}
+
+static void writeCacheFile(const string& tCachePath, CharacterCacheKind tKind, uint32_t tLayoutStamp, uint32_t tFunctionTableStamp, const vector<CharacterCacheSource>& tSources, const vector<uint8_t>& tPayload) {
+	vector<uint8_t> sourceTable;
+	for (auto& source : tSources) {
+		writeInt32(sourceTable, (int32_t)source.mPath.size());
+		writeBytes(sourceTable, source.mPath.data(), source.mPath.size());
+		writeBytes(sourceTable, &source.mSize, sizeof(uint64_t));
+		writeBytes(sourceTable, &source.mTime, sizeof(int64_t));
+	}
+	while ((sizeof(CharacterCacheHeader) + sourceTable.size()) % CHARACTER_CACHE_ALIGNMENT) {
+		writeUInt8(sourceTable, 0);
+	}
+
+	CharacterCacheHeader header;
+	header.mMagic = CHARACTER_CACHE_MAGIC;
+	header.mVersion = CHARACTER_CACHE_VERSION;
+	header.mKind = tKind;
+	header.mLayoutStamp = tLayoutStamp;
+	header.mFunctionTableStamp = tFunctionTableStamp;
+	header.mSourceAmount = (uint32_t)tSources.size();
+	header.mSourceTableSize = (uint32_t)sourceTable.size();
+	header.mPayloadSize = (uint32_t)tPayload.size();
+
+	vector<uint8_t> file;
+	writeBytes(file, &header, sizeof(CharacterCacheHeader));
+	writeBytes(file, sourceTable.data(), sourceTable.size());
+	if (!tPayload.empty()) {
+		writeBytes(file, tPayload.data(), tPayload.size());
+	}
+	bufferToFile(tCachePath.c_str(), makeBuffer(file.data(), (uint32_t)file.size()));
+}
+
+static void serializeInputSteps(vector<uint8_t>& tStream, Vector* tSteps) {
+	writeInt32(tStream, vector_size(tSteps));
+	int i;
+	for (i = 0; i < vector_size(tSteps); i++) {
+		DreamMugenCommandInputStep* e = (DreamMugenCommandInputStep*)vector_get(tSteps, i);
+		writeUInt8(tStream, (uint8_t)e->mType);
+		writeUInt8(tStream, (uint8_t)e->mTarget);
+		writeUInt8(tStream, (uint8_t)e->mDoesNotAllowOtherInputBetween);
+		if (e->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_MULTIPLE) {
+			DreamMugenCommandInputStepMultipleTargetData* data = (DreamMugenCommandInputStepMultipleTargetData*)e->mData;
+			serializeInputSteps(tStream, &data->mSubSteps);
+		}
+		else if (e->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_RELEASE) {
+			DreamMugenCommandInputStepReleaseData* data = (DreamMugenCommandInputStepReleaseData*)e->mData;
+			writeInt32(tStream, data->mDuration);
+		}
+	}
+}
+
+static vector<uint8_t> serializeCommands(DreamMugenCommands* tCommands) {
+	vector<uint8_t> ret;
+	writeInt32(ret, (int32_t)tCommands->mCommands.size());
+	for (auto& command : tCommands->mCommands) {
+		writeInt32(ret, (int32_t)command.first.size());
+		writeBytes(ret, command.first.data(), command.first.size());
+
+		Vector* inputs = &command.second.mInputs;
+		writeInt32(ret, vector_size(inputs));
+		int i;
+		for (i = 0; i < vector_size(inputs); i++) {
+			DreamMugenCommandInput* input = (DreamMugenCommandInput*)vector_get(inputs, i);
+			writeInt32(ret, input->mTime);
+			writeInt32(ret, input->mBufferTime);
+			serializeInputSteps(ret, &input->mInputSteps);
+		}
+	}
+	return ret;
+}
+
+static void deserializeInputSteps(CharacterCacheReader* tReader, Vector* tSteps) {
+	const int amount = readInt32(tReader);
+	int i;
+	for (i = 0; i < amount && !tReader->mHasFailed; i++) {
+		DreamMugenCommandInputStep* e = (DreamMugenCommandInputStep*)allocMemory(sizeof(DreamMugenCommandInputStep));
+		const uint8_t type = readUInt8(tReader);
+		if (type > MUGEN_COMMAND_INPUT_STEP_TYPE_RELEASE) {
+			tReader->mHasFailed = 1;
+		}
+		e->mType = tReader->mHasFailed ? MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS : (DreamMugenCommandInputStepType)type;
+		e->mTarget = (DreamMugenCommandInputStepTarget)readUInt8(tReader);
+		e->mDoesNotAllowOtherInputBetween = readUInt8(tReader);
+		e->mData = NULL;
+		if (e->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_MULTIPLE) {
+			DreamMugenCommandInputStepMultipleTargetData* data = (DreamMugenCommandInputStepMultipleTargetData*)allocMemory(sizeof(DreamMugenCommandInputStepMultipleTargetData));
+			data->mSubSteps = new_vector();
+			e->mData = data;
+			vector_push_back_owned(tSteps, e);
+			deserializeInputSteps(tReader, &data->mSubSteps);
+		}
+		else if (e->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_RELEASE) {
+			DreamMugenCommandInputStepReleaseData* data = (DreamMugenCommandInputStepReleaseData*)allocMemory(sizeof(DreamMugenCommandInputStepReleaseData));
+			data->mDuration = readInt32(tReader);
+			e->mData = data;
+			vector_push_back_owned(tSteps, e);
+		}
+		else {
+			vector_push_back_owned(tSteps, e);
+		}
+	}
+}
+
+static int deserializeCommands(const uint8_t* tPayload, size_t tSize, DreamMugenCommands* oCommands) {
+	CharacterCacheReader reader;
+	reader.mData = tPayload;
+	reader.mSize = tSize;
+	reader.mPosition = 0;
+	reader.mHasFailed = 0;
+	stl_new_map(oCommands->mCommands);
+	const int commandAmount = readInt32(&reader);
+	int i;
+	for (i = 0; i < commandAmount && !reader.mHasFailed; i++) {
+		const int nameLength = readInt32(&reader);
+		if (nameLength < 0 || reader.mPosition + nameLength > reader.mSize) {
+			reader.mHasFailed = 1;
+			break;
+		}
+		string name((const char*)reader.mData + reader.mPosition, nameLength);
+		reader.mPosition += nameLength;
+
+		DreamMugenCommand& command = oCommands->mCommands[name];
+		command.mInputs = new_vector();
+		const int inputAmount = readInt32(&reader);
+		int j;
+		for (j = 0; j < inputAmount && !reader.mHasFailed; j++) {
+			DreamMugenCommandInput* input = (DreamMugenCommandInput*)allocMemory(sizeof(DreamMugenCommandInput));
+			input->mTime = readInt32(&reader);
+			input->mBufferTime = readInt32(&reader);
+			input->mInputSteps = new_vector();
+			vector_push_back_owned(&command.mInputs, input);
+			deserializeInputSteps(&reader, &input->mInputSteps);
+		}
+	}
+
+	if (reader.mHasFailed || reader.mPosition != reader.mSize) {
+		unloadDreamMugenCommandFile(oCommands);
+		return 0;
+	}
+	return 1;
+}
+
+int readFileWithoutPrism(const char* tPath, std::vector<uint8_t>& oData)
+{
+	FILE* file = fopen(tPath, "rb");
+	if (!file) return 0;
+
+	fseek(file, 0, SEEK_END);
+	const long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	oData.resize(size > 0 ? size : 0);
+	const int isRead = size >= 0 && fread(oData.data(), 1, oData.size(), file) == oData.size();
+	fclose(file);
+	return isRead;
+}
+
+int getDreamCharacterStateSourcePaths(MugenDefScript* tScript, const char* tFolder, std::vector<std::string>& oPaths)
+{
+	char file[200];
+	char path[1024];
+	char name[100];
+	oPaths.clear();
+
+	getMugenDefStringOrDefault(file, tScript, "Files", "cns", "");
+	if (!strcmp("", file)) return 0;
+	sprintf(path, "%s%s", tFolder, file);
+	oPaths.push_back(path);
+
+	getMugenDefStringOrDefault(file, tScript, "Files", "stcommon", "");
+	sprintf(path, "%s%s", tFolder, file);
+	if (!isIndexedFile(path)) {
+		sprintf(path, "assets/data/%s", file);
+	}
+	if (isIndexedFile(path)) {
+		oPaths.push_back(path);
+	}
+
+	getMugenDefStringOrDefault(file, tScript, "Files", "st", "");
+	sprintf(path, "%s%s", tFolder, file);
+	if (isIndexedFile(path)) {
+		oPaths.push_back(path);
+	}
+
+	int i;
+	for (i = 0; i < 100; i++) {
+		sprintf(name, "st%d", i);
+		getMugenDefStringOrDefault(file, tScript, "Files", name, "");
+		sprintf(path, "%s%s", tFolder, file);
+		if (!isIndexedFile(path)) continue;
+		oPaths.push_back(path);
+	}
+
+	getMugenDefStringOrDefault(file, tScript, "Files", "cmd", "");
+	if (!strcmp("", file)) return 0;
+	sprintf(path, "%s%s", tFolder, file);
+	oPaths.push_back(path);
+	return 1;
+}
+
+int prepareDreamMugenCommandFileCache(const char* tPath, std::vector<uint8_t>& oFile)
+{
+	const vector<string> sourcePaths(1, tPath);
+	return readFileWithoutPrism(getCachePath(tPath).c_str(), oFile) && parseCacheFile(oFile, CHARACTER_CACHE_KIND_COMMANDS, getCommandsLayoutStamp(), sourcePaths);
+}
+
+// reads, validates and relocates the image into the file buffer, none of which needs the main thread
+int prepareDreamPlayerStatesCache(const std::vector<std::string>& tSourcePaths, std::vector<uint8_t>& oFile)
+{
+	if (tSourcePaths.empty()) return 0;
+	if (!readFileWithoutPrism(getCachePath(tSourcePaths[0]).c_str(), oFile) || !parseCacheFile(oFile, CHARACTER_CACHE_KIND_STATES, getStatesLayoutStamp(), tSourcePaths)) return 0;
+
+	uint32_t payloadSize;
+	uint8_t* payload = getCachePayload(oFile, &payloadSize);
+	return relocateDreamCharacterCacheImage(payload, payloadSize) != NULL;
+}
+
+void adoptPreparedDreamCharacterCache(const char* tPath, std::vector<uint8_t>& tFile)
+{
+	gCharacterCacheData.mPreparedFiles[tPath].swap(tFile);
+}
+
+void clearPreparedDreamCharacterCaches()
+{
+	gCharacterCacheData.mPreparedFiles.clear();
+}
+
+int getDreamCharacterCacheMissAmount()
+{
+	return gCharacterCacheData.mMissAmount;
+}
+
+static int takePreparedFile(const string& tPath, vector<uint8_t>& oFile) {
+	auto it = gCharacterCacheData.mPreparedFiles.find(tPath);
+	if (it == gCharacterCacheData.mPreparedFiles.end()) return 0;
+
+	oFile.swap(it->second);
+	gCharacterCacheData.mPreparedFiles.erase(it);
+	return 1;
+}
+
+static int isUsingCharacterCache() {
+	return !isOnDreamcast() && !isOnWeb();
+}
+
+static int isUsingStatesCache() {
+	return isUsingCharacterCache() && getDreamAssignmentFunctionAmount() && isDreamMugenStateControllerHandlerActive();
+}
+
+DreamMugenCommands loadDreamMugenCommandFileCached(char* tPath)
+{
+	if (!isUsingCharacterCache() || !isFile(tPath)) return loadDreamMugenCommandFile(tPath);
+
+	vector<uint8_t> file;
+	DreamMugenCommands ret;
+	if (takePreparedFile(tPath, file) || prepareDreamMugenCommandFileCache(tPath, file)) {
+		uint32_t payloadSize;
+		uint8_t* payload = getCachePayload(file, &payloadSize);
+		if (deserializeCommands(payload, payloadSize, &ret)) return ret;
+	}
+
+	gCharacterCacheData.mMissAmount++;
+	vector<CharacterCacheSource> sources;
+	const int hasSources = getSourceStamps(vector<string>(1, tPath), sources);
+	MugenDefScript script;
+	loadPreloadedMugenDefScript(&script, tPath);
+	ret = loadDreamMugenCommandsFromScript(&script);
+	unloadMugenDefScript(script);
+	if (hasSources) {
+		writeCacheFile(getCachePath(tPath), CHARACTER_CACHE_KIND_COMMANDS, getCommandsLayoutStamp(), 0, sources, serializeCommands(&ret));
+	}
+	return ret;
+}
+
+// the text may already have been read by the fight preload, the parsing stays on the main thread
+static DreamMugenConstants loadConstantsFile(const string& tPath) {
+	MugenDefScript script;
+	loadPreloadedMugenDefScript(&script, tPath.c_str());
+	DreamMugenConstants ret = loadDreamMugenConstantsFromScript(&script);
+	unloadMugenDefScript(script);
+	return ret;
+}
+
+static void loadStateFile(DreamMugenStates* tStates, const string& tPath) {
+	MugenDefScript script;
+	loadPreloadedMugenDefScript(&script, tPath.c_str());
+	loadDreamMugenStateDefinitionsFromScript(tStates, &script);
+	unloadMugenDefScript(script);
+	logMemoryPlatform();
+}
+
+static int writeStatesPayload(DreamMugenConstants* tConstants, vector<uint8_t>& oPayload) {
+	DreamCharacterCacheImage image;
+	initDreamCharacterCacheImage(&image);
+	writeDreamMugenConstantsCacheImage(&image, tConstants);
+	return finishDreamCharacterCacheImage(&image, oPayload);
+}
+
+// the functions are bound by id and the states copied into the map, the assignments and controllers stay in the file buffer
+static uint8_t* loadConstantsFromStatesFile(DreamMugenConstants* oConstants, vector<uint8_t>& tFile) {
+	if (getCacheHeader(tFile).mFunctionTableStamp != getDreamAssignmentFunctionTableStamp()) return NULL;
+
+	uint32_t payloadSize, imageSize;
+	uint8_t* payload = getCachePayload(tFile, &payloadSize);
+	if (!bindDreamCharacterCacheImageFunctions(payload)) return NULL;
+	if (!loadDreamMugenConstantsFromCacheImage(oConstants, getDreamCharacterCacheImage(payload, &imageSize), imageSize)) return NULL;
+	return payload;
+}
+
+static int loadPlayerStatesFromCacheFile(DreamPlayer* tPlayer, vector<uint8_t>& tFile) {
+	DreamMugenConstants* constants = &tPlayer->mHeader->mFiles.mConstants;
+	releaseDreamPlayerStatesCached(constants);
+	uint8_t* payload = loadConstantsFromStatesFile(constants, tFile);
+	if (!payload) return 0;
+
+	const uint32_t staticAmount = getDreamCharacterCacheImageStaticAssignmentAmount(payload);
+	uint32_t i;
+	for (i = 0; i < staticAmount; i++) {
+		bindDreamStaticMugenAssignment((DreamMugenAssignment*)getDreamCharacterCacheImageStaticAssignment(payload, i), tPlayer);
+	}
+	gCharacterCacheData.mLoadedStateFiles[constants].swap(tFile);
+	return 1;
+}
+
+static void loadPlayerStatesFromText(DreamPlayer* tPlayer, const vector<string>& tSourcePaths) {
+	tPlayer->mHeader->mFiles.mConstants = loadConstantsFile(tSourcePaths[0]);
+	logMemoryPlatform();
+
+	setDreamAssignmentFoldingPlayer(tPlayer);
+	size_t i;
+	for (i = 1; i < tSourcePaths.size(); i++) {
+		loadStateFile(&tPlayer->mHeader->mFiles.mConstants.mStates, tSourcePaths[i]);
+	}
+	resetDreamAssignmentFoldingPlayer();
+}
+
+void loadDreamPlayerStatesCached(DreamPlayer* tPlayer, const std::vector<std::string>& tSourcePaths)
+{
+	if (!isUsingStatesCache()) {
+		loadPlayerStatesFromText(tPlayer, tSourcePaths);
+		return;
+	}
+
+	vector<uint8_t> file;
+	if ((takePreparedFile(tSourcePaths[0], file) || prepareDreamPlayerStatesCache(tSourcePaths, file)) && loadPlayerStatesFromCacheFile(tPlayer, file)) return;
+
+	gCharacterCacheData.mMissAmount++;
+	vector<CharacterCacheSource> sources;
+	const int hasSources = getSourceStamps(tSourcePaths, sources);
+	loadPlayerStatesFromText(tPlayer, tSourcePaths);
+	vector<uint8_t> payload;
+	if (hasSources && writeStatesPayload(&tPlayer->mHeader->mFiles.mConstants, payload)) {
+		writeCacheFile(getCachePath(tSourcePaths[0]), CHARACTER_CACHE_KIND_STATES, getStatesLayoutStamp(), getDreamAssignmentFunctionTableStamp(), sources, payload);
+	}
+}
+
+// the states map has usually been reset already, so the controllers are released by walking the image
+void releaseDreamPlayerStatesCached(DreamMugenConstants* tConstants)
+{
+	auto it = gCharacterCacheData.mLoadedStateFiles.find(tConstants);
+	if (it == gCharacterCacheData.mLoadedStateFiles.end()) return;
+
+	uint32_t payloadSize, imageSize;
+	uint8_t* payload = getCachePayload(it->second, &payloadSize);
+	releaseDreamMugenConstantsCacheImage(getDreamCharacterCacheImage(payload, &imageSize));
+	gCharacterCacheData.mLoadedStateFiles.erase(it);
+}
+
+static double getMillisecondsSince(const chrono::steady_clock::time_point& tStart) {
+	chrono::duration<double, milli> duration = chrono::steady_clock::now() - tStart;
+	return duration.count();
+}
+
+static DreamMugenCommands buildCommandCache(char* tPath) {
+	vector<CharacterCacheSource> sources;
+	getSourceStamps(vector<string>(1, tPath), sources);
+
+	auto start = chrono::steady_clock::now();
+	DreamMugenCommands ret = loadDreamMugenCommandFile(tPath);
+	const double textTime = getMillisecondsSince(start);
+	const auto textPayload = serializeCommands(&ret);
+	writeCacheFile(getCachePath(tPath), CHARACTER_CACHE_KIND_COMMANDS, getCommandsLayoutStamp(), 0, sources, textPayload);
+
+	start = chrono::steady_clock::now();
+	vector<uint8_t> file;
+	DreamMugenCommands cacheCommands;
+	uint32_t payloadSize;
+	const int isLoaded = prepareDreamMugenCommandFileCache(tPath, file) && deserializeCommands(getCachePayload(file, &payloadSize), payloadSize, &cacheCommands);
+	const double cacheTime = getMillisecondsSince(start);
+	const int isEqual = isLoaded && serializeCommands(&cacheCommands) == textPayload;
+	if (isLoaded) {
+		unloadDreamMugenCommandFile(&cacheCommands);
+	}
+
+	logFormat("%s: text %.3f ms, cache %.3f ms, %s.", tPath, textTime, cacheTime, isEqual ? "equal" : "MISMATCH");
+	return ret;
+}
+
+// folding is deferred since there is no player, the static values are bound on load either way
+static void buildStatesCache(const vector<string>& tSourcePaths, DreamMugenCommands* tCommands) {
+	vector<CharacterCacheSource> sources;
+	if (!getSourceStamps(tSourcePaths, sources)) {
+		logWarningFormat("Unable to read state files of %s. Skip.", tSourcePaths[0].c_str());
+		return;
+	}
+
+	char path[1024];
+	strcpy(path, tSourcePaths[0].c_str());
+	auto start = chrono::steady_clock::now();
+	setDreamAssignmentCommandLookupCommands(tCommands);
+	DreamMugenConstants textConstants = loadConstantsFile(tSourcePaths[0]);
+	setDreamAssignmentFoldingDeferred();
+	size_t i;
+	for (i = 1; i < tSourcePaths.size(); i++) {
+		loadStateFile(&textConstants.mStates, tSourcePaths[i]);
+	}
+	resetDreamAssignmentFoldingPlayer();
+	resetDreamAssignmentCommandLookupID();
+	const double textTime = getMillisecondsSince(start);
+
+	vector<uint8_t> textPayload;
+	const int isWritten = writeStatesPayload(&textConstants, textPayload);
+	const int stateAmount = (int)textConstants.mStates.mStates.size();
+	unloadDreamMugenConstantsFile(&textConstants);
+	if (!isWritten) {
+		logWarningFormat("Unable to build state cache for %s. Skip.", path);
+		return;
+	}
+	writeCacheFile(getCachePath(tSourcePaths[0]), CHARACTER_CACHE_KIND_STATES, getStatesLayoutStamp(), getDreamAssignmentFunctionTableStamp(), sources, textPayload);
+
+	start = chrono::steady_clock::now();
+	vector<uint8_t> file;
+	DreamMugenConstants cacheConstants;
+	uint8_t* payload = prepareDreamPlayerStatesCache(tSourcePaths, file) ? loadConstantsFromStatesFile(&cacheConstants, file) : NULL;
+	const double cacheTime = getMillisecondsSince(start);
+	vector<uint8_t> cachePayload;
+	const int isEqual = payload && writeStatesPayload(&cacheConstants, cachePayload) && cachePayload == textPayload;
+	if (payload) {
+		uint32_t imageSize;
+		releaseDreamMugenConstantsCacheImage(getDreamCharacterCacheImage(payload, &imageSize));
+	}
+
+	logFormat("%s: text %.3f ms, cache %.3f ms, %d states, %s.", path, textTime, cacheTime, stateAmount, isEqual ? "equal" : "MISMATCH");
+}
+
+void buildDreamCharacterCache(const char* tDefinitionPath)
+{
+	if (!isFile(tDefinitionPath)) {
+		logWarningFormat("Unable to find character %s. Skip.", tDefinitionPath);
+		return;
+	}
+
+	char folder[1024];
+	char file[200];
+	char path[1024];
+	MugenDefScript script;
+	loadMugenDefScript(&script, tDefinitionPath);
+	getPathToFile(folder, tDefinitionPath);
+	getMugenDefStringOrDefault(file, &script, "Files", "cmd", "");
+	sprintf(path, "%s%s", folder, file);
+	if (!strcmp("", file) || !isFile(path)) {
+		logWarningFormat("Unable to find cmd file %s. Skip.", path);
+		unloadMugenDefScript(script);
+		return;
+	}
+
+	DreamMugenCommands commands = buildCommandCache(path);
+	vector<string> statePaths;
+	if (!isUsingStatesCache()) {
+		logWarningFormat("Unable to build state cache for %s outside of a fight. Skip.", tDefinitionPath);
+	}
+	else if (!getDreamCharacterStateSourcePaths(&script, folder, statePaths) || !isFile(statePaths[0].c_str())) {
+		logWarningFormat("Unable to find cns file of %s. Skip.", tDefinitionPath);
+	}
+	else {
+		buildStatesCache(statePaths, &commands);
+	}
+	unloadDreamMugenCommandFile(&commands);
+	unloadMugenDefScript(script);
+}
+
+static void buildSingleSelectCharacterCache(void* tCaller, void* tData) {
+	(void)tCaller;
+	MugenDefScriptGroupElement* element = (MugenDefScriptGroupElement*)tData;
+	if (element->mType != MUGEN_DEF_SCRIPT_GROUP_VECTOR_ELEMENT) return;
+
+	MugenDefScriptVectorElement* vectorElement = (MugenDefScriptVectorElement*)element->mData;
+	char path[1024];
+	getCharacterSelectNamePath(vectorElement->mVector.mElement[0], path);
+	buildDreamCharacterCache(path);
+}
+
+void buildDreamCharacterCachesFromSelectFile(const char* tSelectPath)
+{
+	if (!isFile(tSelectPath)) {
+		logWarningFormat("Unable to find select file %s.", tSelectPath);
+		return;
+	}
+
+	MugenDefScript script;
+	loadMugenDefScript(&script, tSelectPath);
+	MugenDefScriptGroup* e = &script.mGroups["Characters"];
+	list_map(&e->mOrderedElementList, buildSingleSelectCharacterCache, NULL);
+	unloadMugenDefScript(script);
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include <prism/mugendefreader.h>
+
+#include "mugencommandreader.h"
+#include "mugenstatereader.h"
+#include "playerdefinition.h"
+
+int readFileWithoutPrism(const char* tPath, std::vector<uint8_t>& oData);
+int getDreamCharacterStateSourcePaths(MugenDefScript* tScript, const char* tFolder, std::vector<std::string>& oPaths);
+
+DreamMugenCommands loadDreamMugenCommandFileCached(char* tPath);
+void loadDreamPlayerStatesCached(DreamPlayer* tPlayer, const std::vector<std::string>& tSourcePaths);
+void releaseDreamPlayerStatesCached(DreamMugenConstants* tConstants);
+
+int prepareDreamMugenCommandFileCache(const char* tPath, std::vector<uint8_t>& oFile);
+int prepareDreamPlayerStatesCache(const std::vector<std::string>& tSourcePaths, std::vector<uint8_t>& oFile);
+void adoptPreparedDreamCharacterCache(const char* tPath, std::vector<uint8_t>& tFile);
+void clearPreparedDreamCharacterCaches();
+int getDreamCharacterCacheMissAmount();
+
+void buildDreamCharacterCache(const char* tDefinitionPath);
+void buildDreamCharacterCachesFromSelectFile(const char* tSelectPath);
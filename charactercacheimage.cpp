@@ -0,0 +1,287 @@
+#include "charactercacheimage.h"
+
+#include <string.h>
+
+#include <prism/log.h>
+
+#include "mugenassignment.h"
+#include "mugenassignmentevaluator.h"
+
+using namespace std;
+
+#define CHARACTER_CACHE_IMAGE_ALIGNMENT 8
+
+typedef struct {
+	uint32_t mImageOffset;
+	uint32_t mImageSize;
+	uint32_t mRelocationAmount;
+	uint32_t mFunctionAmount;
+	uint32_t mStaticAssignmentAmount;
+	uint32_t mReserved;
+} CharacterCacheImageHeader;
+
+typedef struct {
+	uint32_t mSlot;
+	uint32_t mID;
+} CharacterCacheImageFunction;
+
+static uint32_t alignImageOffset(size_t tOffset) {
+	return (uint32_t)((tOffset + CHARACTER_CACHE_IMAGE_ALIGNMENT - 1) & ~(size_t)(CHARACTER_CACHE_IMAGE_ALIGNMENT - 1));
+}
+
+void initDreamCharacterCacheImage(DreamCharacterCacheImage* oImage)
+{
+	oImage->mData.clear();
+	oImage->mBlocks.clear();
+	oImage->mPointers.clear();
+	oImage->mFunctions.clear();
+	oImage->mStaticAssignments.clear();
+	oImage->mHasFailed = 0;
+}
+
+uint32_t addDreamCharacterCacheImageBlock(DreamCharacterCacheImage* tImage, const void* tSource, uint32_t tSize, int* oIsNew)
+{
+	auto it = tImage->mBlocks.find(tSource);
+	if (it != tImage->mBlocks.end()) {
+		*oIsNew = 0;
+		return it->second.first;
+	}
+
+	const uint32_t offset = alignImageOffset(tImage->mData.size());
+	tImage->mData.resize(offset + tSize);
+	memcpy(tImage->mData.data() + offset, tSource, tSize);
+	tImage->mBlocks[tSource] = make_pair(offset, tSize);
+	*oIsNew = 1;
+	return offset;
+}
+
+void setDreamCharacterCacheImagePointer(DreamCharacterCacheImage* tImage, uint32_t tSlot, const void* tTarget)
+{
+	clearDreamCharacterCacheImageBytes(tImage, tSlot, sizeof(void*));
+	if (tTarget) {
+		tImage->mPointers[tSlot] = tTarget;
+	}
+	else {
+		tImage->mPointers.erase(tSlot);
+	}
+}
+
+void setDreamCharacterCacheImageString(DreamCharacterCacheImage* tImage, uint32_t tSlot, const char* tString)
+{
+	setDreamCharacterCacheImagePointer(tImage, tSlot, tString);
+	if (!tString) return;
+
+	int isNew;
+	addDreamCharacterCacheImageBlock(tImage, tString, (uint32_t)strlen(tString) + 1, &isNew);
+}
+
+void setDreamCharacterCacheImageFunction(DreamCharacterCacheImage* tImage, uint32_t tSlot, void* tFunc)
+{
+	clearDreamCharacterCacheImageBytes(tImage, tSlot, sizeof(void*));
+	tImage->mFunctions.erase(tSlot);
+	if (!tFunc) return;
+
+	uint32_t id;
+	if (!getDreamAssignmentFunctionID(tFunc, &id)) {
+		failDreamCharacterCacheImage(tImage, "function outside of the assignment tables");
+		return;
+	}
+	tImage->mFunctions[tSlot] = id;
+}
+
+void clearDreamCharacterCacheImageBytes(DreamCharacterCacheImage* tImage, uint32_t tOffset, uint32_t tSize)
+{
+	memset(tImage->mData.data() + tOffset, 0, tSize);
+}
+
+void addDreamCharacterCacheImageStaticAssignment(DreamCharacterCacheImage* tImage, uint32_t tOffset)
+{
+	tImage->mStaticAssignments.push_back(tOffset);
+}
+
+void failDreamCharacterCacheImage(DreamCharacterCacheImage* tImage, const char* tReason)
+{
+	if (!tImage->mHasFailed) {
+		logWarningFormat("Unable to write character cache image: %s.", tReason);
+	}
+	tImage->mHasFailed = 1;
+}
+
+// pointers may point into the middle of a block, e.g. compiled instructions referencing a child slot of their tree
+static int resolveImagePointer(DreamCharacterCacheImage* tImage, const void* tTarget, uintptr_t* oOffset) {
+	auto it = tImage->mBlocks.upper_bound(tTarget);
+	if (it == tImage->mBlocks.begin()) return 0;
+	it--;
+
+	const uintptr_t distance = (uintptr_t)tTarget - (uintptr_t)it->first;
+	if (distance >= it->second.second) return 0;
+	*oOffset = it->second.first + distance;
+	return 1;
+}
+
+int finishDreamCharacterCacheImage(DreamCharacterCacheImage* tImage, std::vector<uint8_t>& oPayload)
+{
+	for (auto& pointer : tImage->mPointers) {
+		uintptr_t offset;
+		if (!resolveImagePointer(tImage, pointer.second, &offset)) {
+			failDreamCharacterCacheImage(tImage, "pointer outside of the written blocks");
+			break;
+		}
+		memcpy(tImage->mData.data() + pointer.first, &offset, sizeof(uintptr_t));
+	}
+	if (tImage->mHasFailed) return 0;
+
+	CharacterCacheImageHeader header;
+	header.mImageSize = (uint32_t)tImage->mData.size();
+	header.mRelocationAmount = (uint32_t)tImage->mPointers.size();
+	header.mFunctionAmount = (uint32_t)tImage->mFunctions.size();
+	header.mStaticAssignmentAmount = (uint32_t)tImage->mStaticAssignments.size();
+	header.mReserved = 0;
+	const size_t tableSize = sizeof(CharacterCacheImageHeader) + sizeof(uint32_t) * header.mRelocationAmount + sizeof(CharacterCacheImageFunction) * header.mFunctionAmount + sizeof(uint32_t) * header.mStaticAssignmentAmount;
+	header.mImageOffset = alignImageOffset(tableSize);
+
+	oPayload.assign(header.mImageOffset + header.mImageSize, 0);
+	uint8_t* position = oPayload.data();
+	memcpy(position, &header, sizeof(CharacterCacheImageHeader));
+	position += sizeof(CharacterCacheImageHeader);
+	for (auto& pointer : tImage->mPointers) {
+		memcpy(position, &pointer.first, sizeof(uint32_t));
+		position += sizeof(uint32_t);
+	}
+	for (auto& function : tImage->mFunctions) {
+		CharacterCacheImageFunction e;
+		e.mSlot = function.first;
+		e.mID = function.second;
+		memcpy(position, &e, sizeof(CharacterCacheImageFunction));
+		position += sizeof(CharacterCacheImageFunction);
+	}
+	if (header.mStaticAssignmentAmount) {
+		memcpy(position, tImage->mStaticAssignments.data(), sizeof(uint32_t) * header.mStaticAssignmentAmount);
+	}
+	if (header.mImageSize) {
+		memcpy(oPayload.data() + header.mImageOffset, tImage->mData.data(), header.mImageSize);
+	}
+	return 1;
+}
+
+uint32_t addDreamCharacterCacheImageLayoutStamp(uint32_t tStamp, const char* tLayoutID)
+{
+	for (; *tLayoutID; tLayoutID++) {
+		tStamp = (tStamp ^ (uint8_t)*tLayoutID) * 16777619u;
+	}
+	return tStamp;
+}
+
+uint32_t addDreamCharacterCacheImageLayoutStamp(uint32_t tStamp, uint32_t tValue)
+{
+	return (tStamp ^ tValue) * 16777619u;
+}
+
+uint32_t getDreamCharacterCacheImageLayoutStamp()
+{
+	uint32_t ret = addDreamCharacterCacheImageLayoutStamp(2166136261u, DREAM_CHARACTER_CACHE_BUILD_ID);
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(CharacterCacheImageHeader));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(CharacterCacheImageFunction));
+	return ret;
+}
+
+static int isImageRangeValid(uint32_t tOffset, uint32_t tSize, uint32_t tImageSize) {
+	return tOffset <= tImageSize && tSize <= tImageSize - tOffset && !(tOffset % sizeof(void*));
+}
+
+static const uint32_t* getRelocationTable(uint8_t* tPayload) {
+	return (const uint32_t*)(tPayload + sizeof(CharacterCacheImageHeader));
+}
+
+static const CharacterCacheImageFunction* getFunctionTable(uint8_t* tPayload, CharacterCacheImageHeader* tHeader) {
+	return (const CharacterCacheImageFunction*)(getRelocationTable(tPayload) + tHeader->mRelocationAmount);
+}
+
+static const uint32_t* getStaticAssignmentTable(uint8_t* tPayload, CharacterCacheImageHeader* tHeader) {
+	return (const uint32_t*)(getFunctionTable(tPayload, tHeader) + tHeader->mFunctionAmount);
+}
+
+static int isImagePayloadValid(uint8_t* tPayload, uint32_t tSize, CharacterCacheImageHeader* tHeader) {
+	const uint64_t tableSize = sizeof(CharacterCacheImageHeader) + sizeof(uint32_t) * (uint64_t)tHeader->mRelocationAmount + sizeof(CharacterCacheImageFunction) * (uint64_t)tHeader->mFunctionAmount + sizeof(uint32_t) * (uint64_t)tHeader->mStaticAssignmentAmount;
+	if (tHeader->mImageOffset < tableSize || tHeader->mImageOffset % CHARACTER_CACHE_IMAGE_ALIGNMENT || (uint64_t)tHeader->mImageOffset + tHeader->mImageSize != tSize) return 0;
+
+	uint8_t* image = tPayload + tHeader->mImageOffset;
+	const uint32_t* relocations = getRelocationTable(tPayload);
+	uint32_t i;
+	for (i = 0; i < tHeader->mRelocationAmount; i++) {
+		if (!isImageRangeValid(relocations[i], sizeof(uintptr_t), tHeader->mImageSize)) return 0;
+		uintptr_t offset;
+		memcpy(&offset, image + relocations[i], sizeof(uintptr_t));
+		if (offset >= tHeader->mImageSize) return 0;
+	}
+
+	const CharacterCacheImageFunction* functions = getFunctionTable(tPayload, tHeader);
+	for (i = 0; i < tHeader->mFunctionAmount; i++) {
+		if (!isImageRangeValid(functions[i].mSlot, sizeof(void*), tHeader->mImageSize)) return 0;
+	}
+
+	const uint32_t* staticAssignments = getStaticAssignmentTable(tPayload, tHeader);
+	for (i = 0; i < tHeader->mStaticAssignmentAmount; i++) {
+		if (!isImageRangeValid(staticAssignments[i], sizeof(DreamMugenStaticAssignment), tHeader->mImageSize)) return 0;
+	}
+	return 1;
+}
+
+// only touches the payload, so this is safe to call off the main thread
+uint8_t* relocateDreamCharacterCacheImage(uint8_t* tPayload, uint32_t tSize)
+{
+	if (tSize < sizeof(CharacterCacheImageHeader) || (uintptr_t)tPayload % CHARACTER_CACHE_IMAGE_ALIGNMENT) return NULL;
+
+	CharacterCacheImageHeader header;
+	memcpy(&header, tPayload, sizeof(CharacterCacheImageHeader));
+	if (!isImagePayloadValid(tPayload, tSize, &header)) return NULL;
+
+	uint8_t* image = tPayload + header.mImageOffset;
+	const uint32_t* relocations = getRelocationTable(tPayload);
+	uint32_t i;
+	for (i = 0; i < header.mRelocationAmount; i++) {
+		uintptr_t offset;
+		memcpy(&offset, image + relocations[i], sizeof(uintptr_t));
+		offset += (uintptr_t)image;
+		memcpy(image + relocations[i], &offset, sizeof(uintptr_t));
+	}
+	return image;
+}
+
+int bindDreamCharacterCacheImageFunctions(uint8_t* tPayload)
+{
+	CharacterCacheImageHeader header;
+	memcpy(&header, tPayload, sizeof(CharacterCacheImageHeader));
+
+	uint8_t* image = tPayload + header.mImageOffset;
+	const CharacterCacheImageFunction* functions = getFunctionTable(tPayload, &header);
+	uint32_t i;
+	for (i = 0; i < header.mFunctionAmount; i++) {
+		void* func = getDreamAssignmentFunctionFromID(functions[i].mID);
+		if (!func) return 0;
+		memcpy(image + functions[i].mSlot, &func, sizeof(void*));
+	}
+	return 1;
+}
+
+uint8_t* getDreamCharacterCacheImage(uint8_t* tPayload, uint32_t* oSize)
+{
+	CharacterCacheImageHeader header;
+	memcpy(&header, tPayload, sizeof(CharacterCacheImageHeader));
+	*oSize = header.mImageSize;
+	return tPayload + header.mImageOffset;
+}
+
+uint32_t getDreamCharacterCacheImageStaticAssignmentAmount(uint8_t* tPayload)
+{
+	CharacterCacheImageHeader header;
+	memcpy(&header, tPayload, sizeof(CharacterCacheImageHeader));
+	return header.mStaticAssignmentAmount;
+}
+
+void* getDreamCharacterCacheImageStaticAssignment(uint8_t* tPayload, uint32_t tIndex)
+{
+	CharacterCacheImageHeader header;
+	memcpy(&header, tPayload, sizeof(CharacterCacheImageHeader));
+	return tPayload + header.mImageOffset + getStaticAssignmentTable(tPayload, &header)[tIndex];
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stdint.h>
+#include <map>
+#include <vector>
+
+// every file that defines part of the image layout stamps it with its build time, so an image never outlives the build that wrote it
+#define DREAM_CHARACTER_CACHE_BUILD_ID __DATE__ " " __TIME__
+
+typedef struct {
+	std::vector<uint8_t> mData;
+	std::map<const void*, std::pair<uint32_t, uint32_t> > mBlocks;
+	std::map<uint32_t, const void*> mPointers;
+	std::map<uint32_t, uint32_t> mFunctions;
+	std::vector<uint32_t> mStaticAssignments;
+	int mHasFailed;
+} DreamCharacterCacheImage;
+
+void initDreamCharacterCacheImage(DreamCharacterCacheImage* oImage);
+uint32_t addDreamCharacterCacheImageBlock(DreamCharacterCacheImage* tImage, const void* tSource, uint32_t tSize, int* oIsNew);
+void setDreamCharacterCacheImagePointer(DreamCharacterCacheImage* tImage, uint32_t tSlot, const void* tTarget);
+void setDreamCharacterCacheImageString(DreamCharacterCacheImage* tImage, uint32_t tSlot, const char* tString);
+void setDreamCharacterCacheImageFunction(DreamCharacterCacheImage* tImage, uint32_t tSlot, void* tFunc);
+void clearDreamCharacterCacheImageBytes(DreamCharacterCacheImage* tImage, uint32_t tOffset, uint32_t tSize);
+void addDreamCharacterCacheImageStaticAssignment(DreamCharacterCacheImage* tImage, uint32_t tOffset);
+void failDreamCharacterCacheImage(DreamCharacterCacheImage* tImage, const char* tReason);
+int finishDreamCharacterCacheImage(DreamCharacterCacheImage* tImage, std::vector<uint8_t>& oPayload);
+
+uint32_t addDreamCharacterCacheImageLayoutStamp(uint32_t tStamp, const char* tLayoutID);
+uint32_t addDreamCharacterCacheImageLayoutStamp(uint32_t tStamp, uint32_t tValue);
+uint32_t getDreamCharacterCacheImageLayoutStamp();
+
+uint8_t* relocateDreamCharacterCacheImage(uint8_t* tPayload, uint32_t tSize);
+int bindDreamCharacterCacheImageFunctions(uint8_t* tPayload);
+uint8_t* getDreamCharacterCacheImage(uint8_t* tPayload, uint32_t* oSize);
+uint32_t getDreamCharacterCacheImageStaticAssignmentAmount(uint8_t* tPayload);
+void* getDreamCharacterCacheImageStaticAssignment(uint8_t* tPayload, uint32_t tIndex);
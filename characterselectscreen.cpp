@@ -20,6 +20,7 @@
 #include "titlescreen.h"
 #include "storyscreen.h"
 #include "playerdefinition.h"
+#include "fileindex.h"
 #include "gamelogic.h"
 #include "stage.h"
 #include "storymode.h"
@@ -329,7 +330,7 @@ static void addSingleSelectStage(char* tPath) {
 	char path[1024];
 	getStagePath(path, tPath);
 
-	if (!isFile(path)) {
+	if (!isIndexedFile(path)) {
 		logWarningFormat("Unable to find stage file %s. Ignoring.", path);
 		return;
 	}
@@ -453,7 +454,7 @@ static int loadMenuCharacterSpritesAndNameAndReturnWhetherExists(SelectCharacter
 
 
 	getCharacterSelectNamePath(tCharacterName, scriptPath);
-	if (!isFile(scriptPath)) {
+	if (!isIndexedFile(scriptPath)) {
 		return 0;
 	}
 	MugenDefScript script;
@@ -471,7 +472,7 @@ static int loadMenuCharacterSpritesAndNameAndReturnWhetherExists(SelectCharacter
 	assert(strcmp("", file));
 	sprintf(scriptPath, "%s%s", path, file);
 	sprintf(scriptPathPreloaded, "%s.portraits.preloaded", scriptPath);
-	if (isFile(scriptPathPreloaded)) {
+	if (isIndexedFile(scriptPathPreloaded)) {
 		e->mSprites = loadMugenSpriteFilePortraits(scriptPathPreloaded, hasPalettePath, palettePath);
 	}
 	else {
@@ -593,7 +594,7 @@ static int loadSingleStoryFileAndReturnWhetherItExists(SelectCharacter* e, char*
 	char scriptPath[1024];
 
 	sprintf(scriptPath, "assets/%s", tPath);
-	if (!isFile(scriptPath)) {
+	if (!isIndexedFile(scriptPath)) {
 		return 0;
 	}
 	MugenDefScript script;
@@ -1635,7 +1636,7 @@ typedef struct {
 static void loadRandomCharacter(RandomCharacterCaller* tCaller, MugenDefScriptVectorElement* tVectorElement) {
 	PossibleRandomCharacterElement* e = (PossibleRandomCharacterElement*)allocMemory(sizeof(PossibleRandomCharacterElement));
 	getCharacterSelectNamePath(tVectorElement->mVector.mElement[0], e->mPath);
-	if (!isFile(e->mPath)) {
+	if (!isIndexedFile(e->mPath)) {
 		freeMemory(e);
 		return;
 	}
@@ -1,33 +1,52 @@
 #include "collision.h"
 
+#include <vector>
+
 #include <prism/collisionhandler.h>
 
+using namespace std;
+
 static struct {
-	CollisionListData* mPlayerAttackCollisionList[2];
-	CollisionListData* mPlayerPassiveCollisionList[2];
+	vector<CollisionListData*> mPlayerAttackCollisionList;
+	vector<CollisionListData*> mPlayerPassiveCollisionList;
 
 } gDolmexicaCollisionData;
 
-void setupDreamGameCollisions()
-{
+#define DEFAULT_COLLISION_ROOT_AMOUNT 2
+
+static void addCollisionRoot() {
+	int newRoot = (int)gDolmexicaCollisionData.mPlayerAttackCollisionList.size();
+	gDolmexicaCollisionData.mPlayerPassiveCollisionList.push_back(addCollisionListToHandler());
+	gDolmexicaCollisionData.mPlayerAttackCollisionList.push_back(addCollisionListToHandler());
+
 	int i;
-	for (i = 0; i < 2; i++) {
-		gDolmexicaCollisionData.mPlayerPassiveCollisionList[i] = addCollisionListToHandler();
-		gDolmexicaCollisionData.mPlayerAttackCollisionList[i] = addCollisionListToHandler();
+	for (i = 0; i < newRoot; i++) {
+		addCollisionHandlerCheck(gDolmexicaCollisionData.mPlayerAttackCollisionList[i], gDolmexicaCollisionData.mPlayerPassiveCollisionList[newRoot]);
+		addCollisionHandlerCheck(gDolmexicaCollisionData.mPlayerAttackCollisionList[newRoot], gDolmexicaCollisionData.mPlayerPassiveCollisionList[i]);
 	}
+}
 
-	for (i = 0; i < 2; i++) {
-		int other = i ^ 1;
-		addCollisionHandlerCheck(gDolmexicaCollisionData.mPlayerAttackCollisionList[i], gDolmexicaCollisionData.mPlayerPassiveCollisionList[other]);
+static void ensureCollisionRoot(int tRootID) {
+	while (tRootID >= (int)gDolmexicaCollisionData.mPlayerAttackCollisionList.size()) {
+		addCollisionRoot();
 	}
 }
 
+void setupDreamGameCollisions()
+{
+	gDolmexicaCollisionData.mPlayerAttackCollisionList.clear();
+	gDolmexicaCollisionData.mPlayerPassiveCollisionList.clear();
+	ensureCollisionRoot(DEFAULT_COLLISION_ROOT_AMOUNT - 1);
+}
+
 CollisionListData* getDreamPlayerPassiveCollisionList(DreamPlayer* p)
 {
+	ensureCollisionRoot(p->mRootID);
 	return gDolmexicaCollisionData.mPlayerPassiveCollisionList[p->mRootID];
 }
 
 CollisionListData* getDreamPlayerAttackCollisionList(DreamPlayer* p)
 {
+	ensureCollisionRoot(p->mRootID);
 	return gDolmexicaCollisionData.mPlayerAttackCollisionList[p->mRootID];
 }
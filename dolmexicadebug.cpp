@@ -17,6 +17,11 @@
 #include "titlescreen.h"
 #include "storymode.h"
 #include "randomwatchmode.h"
+#include "inputrecording.h"
+#include "headlessmode.h"
+#include "charactercache.h"
+#include "fightpreload.h"
+#include "fileindex.h"
 
 using namespace std;
 
@@ -360,6 +365,93 @@ static string writeStoryAnimsCB(void* /*tCaller*/, string /*tCommand*/) {
 	return "";
 }
 
+static string recordinputCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 2) return "Too few arguments";
+	setDreamInputRecordingPath(words[1].c_str());
+	return "";
+}
+
+static string playinputCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 2) return "Too few arguments";
+	setDreamInputPlaybackPath(words[1].c_str());
+	return "";
+}
+
+static string stopinputCB(void* /*tCaller*/, string /*tCommand*/) {
+	resetDreamInputRecordingAndPlayback();
+	return "";
+}
+
+static string headlessCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 3) return "Too few arguments";
+
+	char path1[1024];
+	char path2[1024];
+	getCharacterSelectNamePath(words[1].data(), path1);
+	getCharacterSelectNamePath(words[2].data(), path2);
+	const auto stagePath = words.size() >= 4 ? "assets/stages/" + words[3] : string("assets/stages/kfm.def");
+	startHeadlessMode(path1, path2, stagePath.c_str());
+	return "";
+}
+
+static string charactercacheCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 2) {
+		buildDreamCharacterCachesFromSelectFile("assets/data/select.def");
+		return "";
+	}
+
+	char path[1024];
+	size_t i;
+	for (i = 1; i < words.size(); i++) {
+		getCharacterSelectNamePath(words[i].data(), path);
+		buildDreamCharacterCache(path);
+	}
+	return "";
+}
+
+static string fightpreloadCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 2) return isFightPreloadActive() ? "on" : "off";
+	setFightPreloadActive(words[1] != "0" && words[1] != "off");
+	return "";
+}
+
+static string preloadbenchmarkCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	if (words.size() < 3) return "Too few arguments";
+
+	const auto repetitions = words.size() >= 4 ? atoi(words[3].c_str()) : 10;
+	if (!startRootPlayerPreloadBenchmark(repetitions)) return "";
+
+	char path[1024];
+	getCharacterSelectNamePath(words[1].data(), path);
+	setPlayerDefinitionPath(0, path);
+	getCharacterSelectNamePath(words[2].data(), path);
+	setPlayerDefinitionPath(1, path);
+	setGameModeTraining();
+	setDreamStageMugenDefinition("assets/stages/kfm.def", "");
+	startFightScreen(mockFightFinishedCB);
+	return "";
+}
+
+static string hitbenchmarkCB(void* /*tCaller*/, string tCommand) {
+	const auto words = splitCommandString(tCommand);
+	const auto slotAmount = words.size() >= 2 ? atoi(words[1].c_str()) : 64;
+	const auto repetitions = words.size() >= 3 ? atoi(words[2].c_str()) : 10000;
+	benchmarkPlayerHitAttributeSlots(slotAmount, repetitions);
+	return "";
+}
+
+static string fileindexCB(void* /*tCaller*/, string /*tCommand*/) {
+	stringstream ss;
+	ss << "probes " << getFileIndexProbeAmount() << ", avoided " << getFileIndexAvoidedProbeAmount() << ", directories " << getFileIndexDirectoryAmount();
+	return ss.str();
+}
+
 void initDolmexicaDebug()
 {
 	gDolmexicaDebugData = new DolmexicaDebugData();
@@ -385,6 +477,15 @@ void initDolmexicaDebug()
 	addPrismDebugConsoleCommand("speed", speedCB);
 	addPrismDebugConsoleCommand("roundamount", roundamountCB);
 	addPrismDebugConsoleCommand("writestoryanims", writeStoryAnimsCB);
+	addPrismDebugConsoleCommand("recordinput", recordinputCB);
+	addPrismDebugConsoleCommand("playinput", playinputCB);
+	addPrismDebugConsoleCommand("stopinput", stopinputCB);
+	addPrismDebugConsoleCommand("headless", headlessCB);
+	addPrismDebugConsoleCommand("charactercache", charactercacheCB);
+	addPrismDebugConsoleCommand("fightpreload", fightpreloadCB);
+	addPrismDebugConsoleCommand("preloadbenchmark", preloadbenchmarkCB);
+	addPrismDebugConsoleCommand("fileindex", fileindexCB);
+	addPrismDebugConsoleCommand("hitbenchmark", hitbenchmarkCB);
 }
 
 static void loadDolmexicaDebugHandler(void* tData) {
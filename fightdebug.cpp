@@ -5,6 +5,7 @@
 #include <prism/wrapper.h>
 #include <prism/drawing.h>
 #include <prism/system.h>
+#include <prism/memoryhandler.h>
 
 #include "playerdefinition.h"
 #include "stage.h"
@@ -33,8 +34,12 @@ static struct {
 
 	int mSpeedLevel;
 	int mIsTimeFrozen;
+
+	int mPreviousMemoryBlockAmount;
 } gFightDebugData;
 
+extern int gDebugStateMachineAllocationAmount;
+
 static void loadPlayerDebugData(Position tBasePosition, MugenTextAlignment tAlignment) {
 	PlayerDebugData* e = &gFightDebugData.mPlayer;
 	e->mBasePosition = tBasePosition;
@@ -65,6 +70,7 @@ static void loadFightDebug(void* tData) {
 
 	setSpeedLevel();
 	setDebugTextColor();
+	gFightDebugData.mPreviousMemoryBlockAmount = getAllocatedMemoryBlockAmount();
 }
 
 static void unloadFightDebug(void* tData) {
@@ -355,7 +361,9 @@ static void updateSingleDebugText() {
 
 	int j = 0;
 	char text[1000];
-	sprintf(text, "FRAMES: %d (%.1f FPS) VRET: 0, SPEED: 0, SKIP: A", getDreamGameTime(), getRealFramerate());
+	int memoryBlockAmount = getAllocatedMemoryBlockAmount();
+	sprintf(text, "FRAMES: %d (%.1f FPS) VRET: 0, SPEED: 0, SKIP: A; ALLOC: %+d, STATE ALLOC: %d", getDreamGameTime(), getRealFramerate(), memoryBlockAmount - gFightDebugData.mPreviousMemoryBlockAmount, gDebugStateMachineAllocationAmount);
+	gFightDebugData.mPreviousMemoryBlockAmount = memoryBlockAmount;
 	changeMugenText(e->mTextIDs[j++], text);
 
 	if (player) {
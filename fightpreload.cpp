@@ -0,0 +1,375 @@
+#include "fightpreload.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <chrono>
+
+#if !defined(DREAMCAST) && !defined(__EMSCRIPTEN__)
+#include <thread>
+#define FIGHT_PRELOAD_THREADED
+#endif
+
+#include <prism/file.h>
+#include <prism/log.h>
+#include <prism/system.h>
+#include <prism/memoryhandler.h>
+#include <prism/mugendefreader.h>
+
+#include "charactercache.h"
+#include "playerdefinition.h"
+#include "stage.h"
+#include "fileindex.h"
+
+using namespace std;
+
+typedef enum {
+	PRELOAD_CACHE_KIND_COMMANDS,
+	PRELOAD_CACHE_KIND_STATES,
+} PreloadCacheKind;
+
+typedef struct {
+	string mPath;
+	vector<string> mSourcePaths;
+	PreloadCacheKind mKind;
+	int mIsPrepared;
+	vector<uint8_t> mFile;
+} PreloadCacheFile;
+
+#define PRELOAD_STAGE_TARGET 2
+
+typedef struct {
+	string mPath;
+	vector<uint8_t> mFile;
+} PreloadScriptFile;
+
+typedef struct {
+	string mDefinitionPath;
+
+	vector<PreloadCacheFile> mCacheFiles;
+	vector<PreloadScriptFile> mScriptFiles;
+	vector<string> mReadAheadPaths;
+	double mMilliseconds;
+
+#ifdef FIGHT_PRELOAD_THREADED
+	thread mThread;
+#endif
+} PreloadTarget;
+
+static struct {
+	int mIsDisabled;
+	int mIsPending;
+
+	PreloadTarget mTargets[3];
+	map<string, vector<uint8_t> > mScripts;
+
+	int mBenchmarkRepetitions;
+	int mBenchmarkRun;
+	double mBenchmarkMilliseconds[2];
+} gFightPreloadData;
+
+static void addPreloadCommandCacheFile(PreloadTarget* tTarget, MugenDefScript* tScript, const char* tFolder) {
+	char file[200];
+	getMugenDefStringOrDefault(file, tScript, "Files", "cmd", "");
+	if (!strcmp("", file)) return;
+
+	PreloadCacheFile e;
+	e.mPath = string(tFolder) + file;
+	e.mKind = PRELOAD_CACHE_KIND_COMMANDS;
+	e.mIsPrepared = 0;
+	tTarget->mCacheFiles.push_back(e);
+}
+
+static void addPreloadStatesCacheFile(PreloadTarget* tTarget, MugenDefScript* tScript, const char* tFolder) {
+	PreloadCacheFile e;
+	if (!getDreamCharacterStateSourcePaths(tScript, tFolder, e.mSourcePaths)) return;
+
+	e.mPath = e.mSourcePaths[0];
+	e.mKind = PRELOAD_CACHE_KIND_STATES;
+	e.mIsPrepared = 0;
+	tTarget->mCacheFiles.push_back(e);
+}
+
+static void addPreloadScriptFile(PreloadTarget* tTarget, const string& tPath) {
+	for (auto& e : tTarget->mScriptFiles) {
+		if (e.mPath == tPath) return;
+	}
+
+	PreloadScriptFile e;
+	e.mPath = tPath;
+	tTarget->mScriptFiles.push_back(e);
+}
+
+// sprites, sounds and animations can only be loaded from a path, so they are read ahead into the file cache instead of being handed over
+static void addPreloadReadAheadFile(PreloadTarget* tTarget, MugenDefScript* tScript, const char* tFolder, const char* tGroup, const char* tVariable) {
+	char file[200];
+	getMugenDefStringOrDefault(file, tScript, tGroup, tVariable, "");
+	if (!strcmp("", file)) return;
+
+	char path[1024];
+	sprintf(path, "%s%s", tFolder, file);
+	if (!isIndexedFile(path)) return;
+	tTarget->mReadAheadPaths.push_back(path);
+}
+
+static void resetPreloadTarget(PreloadTarget* oTarget, const char* tDefinitionPath) {
+	oTarget->mDefinitionPath = tDefinitionPath;
+	oTarget->mCacheFiles.clear();
+	oTarget->mScriptFiles.clear();
+	oTarget->mReadAheadPaths.clear();
+	oTarget->mMilliseconds = 0;
+}
+
+// the definition is read on the main thread, each worker only touches the files of its own player and decodes into that player's buffers
+static void setPreloadTarget(PreloadTarget* oTarget, const char* tDefinitionPath) {
+	resetPreloadTarget(oTarget, tDefinitionPath);
+	if (!isFile(tDefinitionPath)) return;
+
+	char folder[1024];
+	MugenDefScript script;
+	loadMugenDefScript(&script, tDefinitionPath);
+	getPathToFile(folder, tDefinitionPath);
+	addPreloadCommandCacheFile(oTarget, &script, folder);
+	addPreloadStatesCacheFile(oTarget, &script, folder);
+	addPreloadReadAheadFile(oTarget, &script, folder, "Files", "anim");
+	addPreloadReadAheadFile(oTarget, &script, folder, "Files", "sprite");
+	addPreloadReadAheadFile(oTarget, &script, folder, "Files", "sound");
+	unloadMugenDefScript(script);
+}
+
+static void setStagePreloadTarget(PreloadTarget* oTarget, const char* tDefinitionPath) {
+	resetPreloadTarget(oTarget, tDefinitionPath);
+	if (!isFile(tDefinitionPath)) return;
+
+	char folder[1024];
+	MugenDefScript script;
+	loadMugenDefScript(&script, tDefinitionPath);
+	getPathToFile(folder, tDefinitionPath);
+	addPreloadScriptFile(oTarget, tDefinitionPath);
+	addPreloadReadAheadFile(oTarget, &script, folder, "BGdef", "spr");
+	if (oTarget->mReadAheadPaths.empty()) {
+		addPreloadReadAheadFile(oTarget, &script, "assets/", "BGdef", "spr");
+	}
+	unloadMugenDefScript(script);
+}
+
+// a cold cache falls back to the text files, which are read here and parsed by the main thread
+static void preloadTarget(PreloadTarget* tTarget) {
+	const auto start = chrono::steady_clock::now();
+	for (auto& e : tTarget->mCacheFiles) {
+		if (e.mKind == PRELOAD_CACHE_KIND_COMMANDS) {
+			e.mIsPrepared = prepareDreamMugenCommandFileCache(e.mPath.c_str(), e.mFile);
+			if (!e.mIsPrepared) {
+				addPreloadScriptFile(tTarget, e.mPath);
+			}
+		}
+		else {
+			e.mIsPrepared = prepareDreamPlayerStatesCache(e.mSourcePaths, e.mFile);
+			for (size_t i = 0; !e.mIsPrepared && i < e.mSourcePaths.size(); i++) {
+				addPreloadScriptFile(tTarget, e.mSourcePaths[i]);
+			}
+		}
+	}
+
+	for (auto& e : tTarget->mScriptFiles) {
+		if (!readFileWithoutPrism(e.mPath.c_str(), e.mFile)) {
+			e.mFile.clear();
+		}
+	}
+
+	vector<uint8_t> readAheadFile;
+	for (auto& path : tTarget->mReadAheadPaths) {
+		readFileWithoutPrism(path.c_str(), readAheadFile);
+	}
+	chrono::duration<double, milli> duration = chrono::steady_clock::now() - start;
+	tTarget->mMilliseconds = duration.count();
+}
+
+static void joinPreloadTarget(PreloadTarget* tTarget) {
+#ifdef FIGHT_PRELOAD_THREADED
+	if (tTarget->mThread.joinable()) {
+		tTarget->mThread.join();
+	}
+#else
+	(void)tTarget;
+#endif
+}
+
+static void adoptPreloadTarget(PreloadTarget* tTarget) {
+	if (tTarget->mDefinitionPath.empty()) return;
+
+	int preparedAmount = 0;
+	for (auto& e : tTarget->mCacheFiles) {
+		if (!e.mIsPrepared) continue;
+		adoptPreparedDreamCharacterCache(e.mPath.c_str(), e.mFile);
+		preparedAmount++;
+	}
+
+	int scriptAmount = 0;
+	for (auto& e : tTarget->mScriptFiles) {
+		if (e.mFile.empty()) continue;
+		gFightPreloadData.mScripts[e.mPath].swap(e.mFile);
+		scriptAmount++;
+	}
+	logFormat("Prepared %d of %d character caches and read %d scripts of %s in %.1f ms.", preparedAmount, (int)tTarget->mCacheFiles.size(), scriptAmount, tTarget->mDefinitionPath.c_str(), tTarget->mMilliseconds);
+	resetPreloadTarget(tTarget, "");
+}
+
+// run 0 is a warm-up that writes missing caches and fills the file cache, the timed runs alternate as preloaded, sequential, sequential, preloaded
+static int isBenchmarkRunPreloaded(int tRun) {
+	if (!tRun) return 0;
+	const int index = tRun - 1;
+	return !((index ^ (index >> 1)) & 1);
+}
+
+static int isBenchmarkActive() {
+	return gFightPreloadData.mBenchmarkRepetitions > 0;
+}
+
+// the stage is only preloaded from the versus screen, the fight screen loads it right after starting the root players
+static void startPreload(int tIsPreloadingStage) {
+#ifdef FIGHT_PRELOAD_THREADED
+	waitForFightPreload();
+	gFightPreloadData.mIsPending = 0;
+	if (gFightPreloadData.mIsDisabled || isOnDreamcast() || isOnWeb()) return;
+	if (isBenchmarkActive() && !isBenchmarkRunPreloaded(gFightPreloadData.mBenchmarkRun)) return;
+
+	char path[1024];
+	int i;
+	for (i = 0; i < 2; i++) {
+		getPlayerDefinitionPath(path, i);
+		setPreloadTarget(&gFightPreloadData.mTargets[i], path);
+	}
+	resetPreloadTarget(&gFightPreloadData.mTargets[PRELOAD_STAGE_TARGET], "");
+	if (tIsPreloadingStage) {
+		getDreamStageMugenDefinitionPath(path);
+		setStagePreloadTarget(&gFightPreloadData.mTargets[PRELOAD_STAGE_TARGET], path);
+	}
+
+	for (i = 0; i < 3; i++) {
+		if (gFightPreloadData.mTargets[i].mDefinitionPath.empty()) continue;
+		gFightPreloadData.mTargets[i].mThread = thread(preloadTarget, &gFightPreloadData.mTargets[i]);
+	}
+	gFightPreloadData.mIsPending = 1;
+#else
+	(void)tIsPreloadingStage;
+#endif
+}
+
+void startFightPreload()
+{
+	startPreload(1);
+}
+
+void startRootPlayerPreload()
+{
+	startPreload(0);
+}
+
+int isFightPreloadPending()
+{
+	return gFightPreloadData.mIsPending;
+}
+
+void waitForFightPreload()
+{
+	int i;
+	for (i = 0; i < 3; i++) {
+		joinPreloadTarget(&gFightPreloadData.mTargets[i]);
+	}
+}
+
+void finishFightStagePreload()
+{
+	if (!gFightPreloadData.mIsPending) return;
+	joinPreloadTarget(&gFightPreloadData.mTargets[PRELOAD_STAGE_TARGET]);
+	adoptPreloadTarget(&gFightPreloadData.mTargets[PRELOAD_STAGE_TARGET]);
+}
+
+int finishFightPreload()
+{
+	if (!gFightPreloadData.mIsPending) return 0;
+	waitForFightPreload();
+	gFightPreloadData.mIsPending = 0;
+
+	int i;
+	for (i = 0; i < 3; i++) {
+		adoptPreloadTarget(&gFightPreloadData.mTargets[i]);
+	}
+	return 1;
+}
+
+void clearFightPreload()
+{
+	clearPreparedDreamCharacterCaches();
+	gFightPreloadData.mScripts.clear();
+}
+
+// the buffer is copied since the script loader frees it with prism's allocator
+void loadPreloadedMugenDefScript(MugenDefScript* oScript, const char* tPath)
+{
+	auto it = gFightPreloadData.mScripts.find(tPath);
+	if (it == gFightPreloadData.mScripts.end()) {
+		loadMugenDefScript(oScript, tPath);
+		return;
+	}
+
+	const uint32_t size = (uint32_t)it->second.size();
+	Buffer b = makeBuffer(allocMemory(size), size);
+	memcpy(b.mData, it->second.data(), size);
+	gFightPreloadData.mScripts.erase(it);
+	loadMugenDefScriptFromBufferAndFreeBuffer(oScript, b);
+}
+
+int startRootPlayerPreloadBenchmark(int tRepetitions)
+{
+#ifdef FIGHT_PRELOAD_THREADED
+	if (gFightPreloadData.mIsDisabled || isOnDreamcast() || isOnWeb()) {
+		logg("Root player preload is disabled.");
+		return 0;
+	}
+	finishFightPreload();
+	clearFightPreload();
+	gFightPreloadData.mBenchmarkRepetitions = tRepetitions < 1 ? 1 : tRepetitions;
+	gFightPreloadData.mBenchmarkRun = 0;
+	gFightPreloadData.mBenchmarkMilliseconds[0] = 0;
+	gFightPreloadData.mBenchmarkMilliseconds[1] = 0;
+	return 1;
+#else
+	(void)tRepetitions;
+	logg("Root player preload is not available on this platform.");
+	return 0;
+#endif
+}
+
+int finishRootPlayerPreloadBenchmarkRun(double tMilliseconds)
+{
+	if (!isBenchmarkActive()) return 0;
+
+	const int run = gFightPreloadData.mBenchmarkRun++;
+	if (run) {
+		gFightPreloadData.mBenchmarkMilliseconds[isBenchmarkRunPreloaded(run)] += tMilliseconds;
+	}
+	if (gFightPreloadData.mBenchmarkRun <= 2 * gFightPreloadData.mBenchmarkRepetitions) return 1;
+
+	char path1[1024];
+	char path2[1024];
+	getPlayerDefinitionPath(path1, 0);
+	getPlayerDefinitionPath(path2, 1);
+	const int repetitions = gFightPreloadData.mBenchmarkRepetitions;
+	logFormat("Root player load of %s and %s, %d runs each after a warm-up: sequential %.2f ms, preloaded %.2f ms.", path1, path2, repetitions, gFightPreloadData.mBenchmarkMilliseconds[0] / repetitions, gFightPreloadData.mBenchmarkMilliseconds[1] / repetitions);
+	gFightPreloadData.mBenchmarkRepetitions = 0;
+	return 0;
+}
+
+void setFightPreloadActive(int tIsActive)
+{
+	gFightPreloadData.mIsDisabled = !tIsActive;
+}
+
+int isFightPreloadActive()
+{
+	return !gFightPreloadData.mIsDisabled;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <prism/mugendefreader.h>
+
+void startFightPreload();
+void startRootPlayerPreload();
+int isFightPreloadPending();
+void waitForFightPreload();
+void finishFightStagePreload();
+int finishFightPreload();
+void clearFightPreload();
+void loadPreloadedMugenDefScript(MugenDefScript* oScript, const char* tPath);
+
+int startRootPlayerPreloadBenchmark(int tRepetitions);
+int finishRootPlayerPreloadBenchmarkRun(double tMilliseconds);
+
+void setFightPreloadActive(int tIsActive);
+int isFightPreloadActive();
@@ -1,6 +1,7 @@
 #include "fightscreen.h"
 
 #include <stdio.h>
+#include <chrono>
 
 #include <prism/input.h>
 #include <prism/stagehandler.h>
@@ -40,16 +41,30 @@
 #include "osuhandler.h"
 #include "mugensound.h"
 #include "pausecontrollers.h"
+#include "inputrecording.h"
+#include "headlessmode.h"
+#include "charactercache.h"
+#include "fightpreload.h"
+#include "fileindex.h"
 
 static struct {
 	void(*mWinCB)();
 	void(*mLoseCB)();
 	MemoryStack mMemoryStack;
+
+	std::chrono::steady_clock::time_point mStartTime;
+	double mPlayerLoadMilliseconds;
+	int mIsPreloaded;
+	int mIsRootPlayerPreloaded;
+	int mIsCharacterCacheCold;
+	int mHasReportedFirstFrame;
 } gFightScreenData;
 
 static void setFightScreenGameSpeed() {
 	if (isDebugOverridingTimeDilatation()) return;
 
+	if (getGameMode() == GAME_MODE_HEADLESS) return; // the headless handler sizes its own tick batches
+
 	int gameSpeed = getGlobalGameSpeed();
 	if (gameSpeed < 0) {
 		double baseFactor = (-gameSpeed) / 9.0;
@@ -67,11 +82,28 @@ extern int gDebugAssignmentAmount;
 extern int gDebugStateControllerAmount;
 extern int gDebugStringMapAmount;
 extern int gPruneAmount;
+extern int gCompiledAssignmentAmount;
+extern int gCachedTriggerAmount;
+extern int gDebugStateMachineAllocationAmount;
 
 static void exitFightScreenCB(void* tCaller);
 
+static const char* getFightPreloadText() {
+	if (gFightScreenData.mIsPreloaded) return "preloaded during versus screen";
+	if (gFightScreenData.mIsRootPlayerPreloaded) return "players preloaded during fight load";
+	return "not preloaded";
+}
+
+static const char* getCharacterCacheText() {
+	return gFightScreenData.mIsCharacterCacheCold ? "cold character cache" : "warm character cache";
+}
+
 static void loadFightScreen() {
 	setWrapperBetweenScreensCB(exitFightScreenCB, NULL);
+	gFightScreenData.mIsPreloaded = isFightPreloadPending();
+	if (!gFightScreenData.mIsPreloaded) {
+		startRootPlayerPreload();
+	}
 
 	logMemoryPlatform();
 	logg("create mem stack");
@@ -84,7 +116,11 @@ static void loadFightScreen() {
 	gDebugStateControllerAmount = 0;
 	gDebugStringMapAmount = 0;
 	gPruneAmount = 0;
+	gCompiledAssignmentAmount = 0;
+	gCachedTriggerAmount = 0;
+	gDebugStateMachineAllocationAmount = 0;
 
+	startDreamInputRecordingOrPlayback();
 	setupDreamGameCollisions();
 	setupDreamAssignmentReader(&gFightScreenData.mMemoryStack);
 	setupDreamAssignmentEvaluator();
@@ -103,7 +139,7 @@ static void loadFightScreen() {
 	instantiateActor(getPreStateMachinePlayersBlueprint());
 	instantiateActor(getDreamMugenCommandHandler());
 	instantiateActor(getDreamMugenStateHandler());
-	if (isMugenDebugActive()) {
+	if (isMugenDebugActive() && getGameMode() != GAME_MODE_HEADLESS) {
 		int actorID = instantiateActor(getFightDebug());
 		setActorUnpausable(actorID);
 	}
@@ -111,12 +147,20 @@ static void loadFightScreen() {
 	logMemoryPlatform();
 	logg("init stage");
 
+	finishFightStagePreload();
 	instantiateActor(getDreamStageBP());
 
 	logMemoryPlatform();
 	logg("init players");
 
+	const auto playerLoadStart = std::chrono::steady_clock::now();
+	const int characterCacheMissAmount = getDreamCharacterCacheMissAmount();
+	gFightScreenData.mIsRootPlayerPreloaded = finishFightPreload() && !gFightScreenData.mIsPreloaded;
 	loadPlayers(&gFightScreenData.mMemoryStack);
+	clearFightPreload();
+	gFightScreenData.mIsCharacterCacheCold = getDreamCharacterCacheMissAmount() != characterCacheMissAmount;
+	std::chrono::duration<double, std::milli> playerLoadDuration = std::chrono::steady_clock::now() - playerLoadStart;
+	gFightScreenData.mPlayerLoadMilliseconds = playerLoadDuration.count();
 	
 	instantiateActor(getDreamFightUIBP());
 	instantiateActor(getDreamGameLogic());
@@ -129,10 +173,16 @@ static void loadFightScreen() {
 	logMemoryPlatform();
 	shutdownDreamAssignmentReader();
 	
-	loadPlayerSprites();
-	setUIFaces();
+	if (getGameMode() == GAME_MODE_HEADLESS) {
+		skipPlayerSprites();
+		instantiateActor(getHeadlessModeHandler());
+	}
+	else {
+		loadPlayerSprites();
+		setUIFaces();
+		playDreamStageMusic();
+	}
 	
-	playDreamStageMusic();
 	if (getGameMode() == GAME_MODE_OSU) {
 		instantiateActor(getOsuHandler());
 	}
@@ -155,27 +205,45 @@ static void loadFightScreen() {
 	logMemoryPlatform();
 
 	logFormat("assignments: %d", gDebugAssignmentAmount);
+	logFormat("compiled assignments: %d", gCompiledAssignmentAmount);
+	logFormat("pruned assignments: %d", gPruneAmount);
+	logFormat("cached triggers: %d", gCachedTriggerAmount);
 	logFormat("controllers: %d", gDebugStateControllerAmount);
 	logFormat("maps: %d", gDebugStringMapAmount);
 	logFormat("memory blocks: %d", getAllocatedMemoryBlockAmount());
 	logFormat("memory stack used: %d", (int)gFightScreenData.mMemoryStack.mOffset);
+	logFormat("file probes: %d, avoided: %d", getFileIndexProbeAmount(), getFileIndexAvoidedProbeAmount());
 }
 
 static void unloadFightScreen() {
+	finishDreamInputRecordingOrPlayback();
 	unloadPlayers();
 	resetGameMode();
 	shutdownDreamMugenStateControllerHandler();
 	shutdownDreamAssignmentEvaluator();
+	resetFileIndex();
+}
+
+static void updateFightScreen() {
+	if (gFightScreenData.mHasReportedFirstFrame) return;
+
+	std::chrono::duration<double, std::milli> duration = std::chrono::steady_clock::now() - gFightScreenData.mStartTime;
+	logFormat("time to first fight frame: %.1f ms, players %.1f ms (%s, %s)", duration.count(), gFightScreenData.mPlayerLoadMilliseconds, getFightPreloadText(), getCharacterCacheText());
+	gFightScreenData.mHasReportedFirstFrame = 1;
+	if (finishRootPlayerPreloadBenchmarkRun(gFightScreenData.mPlayerLoadMilliseconds)) {
+		reloadFightScreen();
+	}
 }
 
 static void drawFightScreen() {
+	if (getGameMode() == GAME_MODE_HEADLESS) return;
 	drawPlayers();
 }
 
 static Screen gDreamFightScreen;
 
 static Screen* getDreamFightScreen() {
-	gDreamFightScreen = makeScreen(loadFightScreen, NULL, drawFightScreen, unloadFightScreen);
+	gDreamFightScreen = makeScreen(loadFightScreen, updateFightScreen, drawFightScreen, unloadFightScreen);
 	return &gDreamFightScreen;
 }
 
@@ -196,6 +264,8 @@ static void exitFightScreenCB(void* /*tCaller*/) {
 void startFightScreen(void(*tWinCB)(), void(*tLoseCB)()) {
 	gFightScreenData.mWinCB = tWinCB;
 	gFightScreenData.mLoseCB = tLoseCB;
+	gFightScreenData.mStartTime = std::chrono::steady_clock::now();
+	gFightScreenData.mHasReportedFirstFrame = 0;
 	setWrapperBetweenScreensCB(loadFightFonts, NULL);
 	setNewScreen(getDreamFightScreen());
 }
@@ -18,6 +18,7 @@
 #include "mugenanimationutilities.h"
 #include "config.h"
 #include "gamelogic.h"
+#include "mugencommandhandler.h"
 
 using namespace std;
 
@@ -1418,7 +1419,7 @@ static void updateWinDisplay() {
 	if (!gFightUIData.mWin.mIsDisplaying) return;
 
 	gFightUIData.mWin.mNow++;
-	if (gFightUIData.mWin.mNow >= gFightUIData.mWin.mDisplayTime || hasPressedStartFlank()) {
+	if (gFightUIData.mWin.mNow >= gFightUIData.mWin.mDisplayTime || hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1)) {
 		removeDisplayedText(gFightUIData.mWin.mTextID);
 		gFightUIData.mWin.mCB();
 		gFightUIData.mWin.mIsDisplaying = 0;
@@ -1429,7 +1430,7 @@ static void updateDrawDisplay() {
 	if (!gFightUIData.mDraw.mIsDisplaying) return;
 
 	gFightUIData.mDraw.mNow++;
-	if (gFightUIData.mDraw.mNow >= gFightUIData.mDraw.mDisplayTime || hasPressedStartFlank()) {
+	if (gFightUIData.mDraw.mNow >= gFightUIData.mDraw.mDisplayTime || hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1)) {
 		removeDisplayedText(gFightUIData.mDraw.mTextID);
 		gFightUIData.mDraw.mCB();
 		gFightUIData.mDraw.mIsDisplaying = 0;
@@ -1500,14 +1501,14 @@ static void decreaseContinueCounter() {
 static void updateContinueDisplay() {
 	if (!gFightUIData.mContinue.mIsActive) return;
 
-	if (hasPressedStartFlank()) {
+	if (hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1)) {
 		setContinueInactive();
 		gFightUIData.mContinue.mPressedContinueCB();
 		return;
 	}
 	
 	gFightUIData.mContinue.mNow++;
-	if (gFightUIData.mContinue.mNow >= gFightUIData.mContinue.mDuration || hasPressedAFlank()) {
+	if (gFightUIData.mContinue.mNow >= gFightUIData.mContinue.mDuration || hasDreamControllerPressedAFlank(0) || hasDreamControllerPressedAFlank(1)) {
 		gFightUIData.mContinue.mNow = 0;
 		if (!gFightUIData.mContinue.mValue) {
 			setContinueInactive();
@@ -0,0 +1,58 @@
+#include "fileindex.h"
+
+#include <string.h>
+#include <string>
+#include <map>
+
+#include <prism/file.h>
+
+using namespace std;
+
+static struct {
+	map<string, map<string, int> > mDirectories;
+	int mProbeAmount;
+	int mAvoidedProbeAmount;
+} gFileIndexData;
+
+int isIndexedFile(const char* tPath)
+{
+	const char* separator = strrchr(tPath, '/');
+	const string directory = separator ? string(tPath, size_t(separator - tPath + 1)) : string();
+	const char* name = separator ? separator + 1 : tPath;
+	if (!*name) return 0;
+
+	auto& entries = gFileIndexData.mDirectories[directory];
+	const auto it = entries.find(name);
+	if (it != entries.end()) {
+		gFileIndexData.mAvoidedProbeAmount++;
+		return it->second;
+	}
+
+	gFileIndexData.mProbeAmount++;
+	const int ret = isFile(tPath);
+	entries[name] = ret;
+	return ret;
+}
+
+// the index only lives for one fight, so files written or removed in between are probed again
+void resetFileIndex()
+{
+	gFileIndexData.mDirectories.clear();
+	gFileIndexData.mProbeAmount = 0;
+	gFileIndexData.mAvoidedProbeAmount = 0;
+}
+
+int getFileIndexProbeAmount()
+{
+	return gFileIndexData.mProbeAmount;
+}
+
+int getFileIndexAvoidedProbeAmount()
+{
+	return gFileIndexData.mAvoidedProbeAmount;
+}
+
+int getFileIndexDirectoryAmount()
+{
+	return (int)gFileIndexData.mDirectories.size();
+}
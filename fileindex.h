@@ -0,0 +1,8 @@
+#pragma once
+
+int isIndexedFile(const char* tPath);
+void resetFileIndex();
+
+int getFileIndexProbeAmount();
+int getFileIndexAvoidedProbeAmount();
+int getFileIndexDirectoryAmount();
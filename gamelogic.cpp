@@ -22,6 +22,7 @@
 #include "osuhandler.h"
 #include "arcademode.h"
 #include "survivalmode.h"
+#include "mugencommandhandler.h"
 
 typedef enum {
 	ROUND_STATE_FADE_IN = 0,
@@ -455,7 +456,7 @@ static void gotoNextRound(void* tCaller) {
 static void updateWinPose() {
 	if (!gGameLogicData.mIsDisplayingWinPose) return;
 
-	int hasSkipped = hasPressedStartFlankSingle(0) || hasPressedStartFlankSingle(1);
+	int hasSkipped = hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1);
 	int isTimeOver = !getPlayerAnimationTimeDeltaUntilFinished(gGameLogicData.mRoundWinner) || hasPlayerAnimationLooped(gGameLogicData.mRoundWinner);
 	int isStepInfinite = isMugenAnimationStepDurationInfinite(getPlayerAnimationStepDuration(gGameLogicData.mRoundWinner)); 
 	int isOver = (isTimeOver || isStepInfinite) && !gGameLogicData.mRoundNotOverFlag;
@@ -477,7 +478,7 @@ static void updateExhibitMode() {
 		setDreamBarInvisibleForOneFrame();
 	}
 
-	int isOver = (hasPressedStartFlank() || gGameLogicData.mGameTime >= gGameLogicData.mExhibit.mEndTime);
+	int isOver = (hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1) || gGameLogicData.mGameTime >= gGameLogicData.mExhibit.mEndTime);
 	if (!gGameLogicData.mExhibit.mIsFadingOut && isOver) {
 		addFadeOut(180, goToNextScreen, NULL);
 		gGameLogicData.mExhibit.mIsFadingOut = 1;
@@ -510,7 +511,7 @@ static void skipIntroCB(void* tCaller) {
 static void updateIntroSkip() {
 	if (gGameLogicData.mRoundStateNumber != ROUND_STATE_INTRO) return;
 
-	if (hasPressedStartFlankSingle(0) || hasPressedStartFlankSingle(1)) {
+	if (hasDreamControllerPressedStartFlank(0) || hasDreamControllerPressedStartFlank(1)) {
 		addFadeOut(10, skipIntroCB, NULL);
 	}
 }
@@ -856,6 +857,26 @@ void setGameModeOsu()
 	gGameLogicData.mMode = GAME_MODE_OSU;
 }
 
+void setGameModeHeadless()
+{
+	gGameLogicData.mRoundsToWin = 2;
+	gGameLogicData.mHasCustomRoundsToWinAmount = 0;
+	gGameLogicData.mStartRound = 1;
+
+	setFightResultActive(0);
+	setFightContinueInactive();
+	setTimerFinite();
+	setPlayersToRealFightMode();
+	setPlayerArtificial(0, getDifficulty());
+	setPlayerArtificial(1, getDifficulty());
+	setPlayerPreferredPalette(0, 1);
+	setPlayerPreferredPalette(1, 2);
+	setPlayerStartLifePercentage(0, 1);
+	setPlayerStartLifePercentage(1, 1);
+
+	gGameLogicData.mMode = GAME_MODE_HEADLESS;
+}
+
 void resetGameMode()
 {
 	if (getGameMode() == GAME_MODE_OSU)
@@ -13,7 +13,8 @@ typedef enum {
 	GAME_MODE_WATCH,
 	GAME_MODE_SUPER_WATCH,
 	GAME_MODE_EXHIBIT,
-	GAME_MODE_OSU
+	GAME_MODE_OSU,
+	GAME_MODE_HEADLESS
 } GameMode;
 
 ActorBlueprint getDreamGameLogic();
@@ -57,6 +58,7 @@ void setGameModeSuperWatch();
 void setGameModeExhibit(int tEndTime, int tIsDisplayingBars, int tIsDisplayingDebug);
 void setGameModeStory();
 void setGameModeOsu();
+void setGameModeHeadless();
 void resetGameMode();
 
 GameMode getGameMode();
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "headlessmode.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include <prism/wrapper.h>
+#include <prism/drawing.h>
+#include <prism/sound.h>
+#include <prism/file.h>
+#include <prism/log.h>
+
+#include "fightscreen.h"
+#include "gamelogic.h"
+#include "playerdefinition.h"
+#include "stage.h"
+#include "titlescreen.h"
+#include "config.h"
+#include "dolmexicadebug.h"
+
+using namespace std;
+
+// ticks run back to back for this long before the wrapper gets to present a frame
+#define HEADLESS_TICK_BATCH_SECONDS 1.0
+#define HEADLESS_MAXIMUM_TICK_BATCH_SIZE 1000000
+
+static struct {
+	void(*mFinishedCB)();
+	string mResultPath;
+	chrono::steady_clock::time_point mStartTime;
+	HeadlessFightResult mResult;
+
+	chrono::steady_clock::time_point mBatchStartTime;
+	int mBatchTickAmount;
+	int mBatchSize;
+} gHeadlessModeData;
+
+static void setHeadlessTickBatchSize(int tBatchSize) {
+	gHeadlessModeData.mBatchSize = tBatchSize;
+	gHeadlessModeData.mBatchTickAmount = 0;
+	gHeadlessModeData.mBatchStartTime = chrono::steady_clock::now();
+	if (!isDebugOverridingTimeDilatation()) {
+		setWrapperTimeDilatation(tBatchSize);
+	}
+}
+
+static void loadHeadlessModeHandler(void* tData) {
+	(void)tData;
+	setVolume(0);
+	setSoundEffectVolume(0);
+	disableDrawing();
+	gHeadlessModeData.mStartTime = chrono::steady_clock::now();
+	setHeadlessTickBatchSize(1);
+}
+
+static void unloadHeadlessModeHandler(void* tData) {
+	(void)tData;
+	setGameWavVolume(getGameWavVolume());
+	setGameMidiVolume(getGameMidiVolume());
+	enableDrawing();
+	if (!isDebugOverridingTimeDilatation()) {
+		setWrapperTimeDilatation(1);
+	}
+}
+
+static void updateHeadlessTickBatchSize() {
+	gHeadlessModeData.mBatchTickAmount++;
+	if (gHeadlessModeData.mBatchTickAmount < gHeadlessModeData.mBatchSize) return;
+
+	chrono::duration<double> duration = chrono::steady_clock::now() - gHeadlessModeData.mBatchStartTime;
+	double secondsPerTick = duration.count() / gHeadlessModeData.mBatchTickAmount;
+	double batchSize = secondsPerTick > 0 ? HEADLESS_TICK_BATCH_SECONDS / secondsPerTick : HEADLESS_MAXIMUM_TICK_BATCH_SIZE;
+	setHeadlessTickBatchSize((int)std::max(1.0, std::min(batchSize, (double)HEADLESS_MAXIMUM_TICK_BATCH_SIZE)));
+}
+
+static void updateHeadlessModeHandler(void* tData) {
+	(void)tData;
+	disableDrawing(); // round resets enable drawing again
+	updateHeadlessTickBatchSize();
+}
+
+ActorBlueprint getHeadlessModeHandler()
+{
+	return makeActorBlueprint(loadHeadlessModeHandler, unloadHeadlessModeHandler, updateHeadlessModeHandler);
+}
+
+static void writeHeadlessFightResult() {
+	HeadlessFightResult& result = gHeadlessModeData.mResult;
+	char text[1024];
+	sprintf(text, "winner: %d\nrounds: %d\nframes: %d\nseconds: %.3f\nticks per second: %.1f\n", result.mWinnerIndex, result.mRoundAmount, result.mFrameAmount, result.mSeconds, result.mTicksPerSecond);
+	logFormat("Headless fight finished. Winner %d, rounds %d, frames %d, %.1f ticks per second.", result.mWinnerIndex, result.mRoundAmount, result.mFrameAmount, result.mTicksPerSecond);
+	if (gHeadlessModeData.mResultPath.empty()) return;
+	bufferToFile(gHeadlessModeData.mResultPath.c_str(), makeBuffer(text, (uint32_t)strlen(text)));
+}
+
+static void fightFinishedCB() {
+	chrono::duration<double> duration = chrono::steady_clock::now() - gHeadlessModeData.mStartTime;
+	HeadlessFightResult& result = gHeadlessModeData.mResult;
+	result.mWinnerIndex = getDreamMatchWinnerIndex();
+	result.mRoundAmount = getDreamRoundNumber();
+	result.mFrameAmount = getDreamGameTime();
+	result.mSeconds = duration.count();
+	result.mTicksPerSecond = result.mSeconds > 0 ? result.mFrameAmount / result.mSeconds : 0.0;
+	writeHeadlessFightResult();
+
+	if (gHeadlessModeData.mFinishedCB) {
+		gHeadlessModeData.mFinishedCB();
+	}
+	else {
+		setNewScreen(getDreamTitleScreen());
+	}
+}
+
+void startHeadlessMode(const char* tPlayer1Path, const char* tPlayer2Path, const char* tStagePath, void(*tFinishedCB)(), const char* tResultPath)
+{
+	gHeadlessModeData.mFinishedCB = tFinishedCB;
+	gHeadlessModeData.mResultPath = tResultPath ? tResultPath : "";
+	setPlayerDefinitionPath(0, tPlayer1Path);
+	setPlayerDefinitionPath(1, tPlayer2Path);
+	setDreamStageMugenDefinition(tStagePath, "");
+	setGameModeHeadless();
+	startFightScreen(fightFinishedCB);
+}
+
+HeadlessFightResult getHeadlessFightResult()
+{
+	return gHeadlessModeData.mResult;
+}
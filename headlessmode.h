@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdio.h>
+#include <prism/actorhandler.h>
+
+typedef struct {
+	int mWinnerIndex;
+	int mRoundAmount;
+	int mFrameAmount;
+	double mSeconds;
+	double mTicksPerSecond;
+} HeadlessFightResult;
+
+void startHeadlessMode(const char* tPlayer1Path, const char* tPlayer2Path, const char* tStagePath, void(*tFinishedCB)() = NULL, const char* tResultPath = "debug/headless.txt");
+HeadlessFightResult getHeadlessFightResult();
+
+ActorBlueprint getHeadlessModeHandler();
@@ -0,0 +1,182 @@
+#include "inputrecording.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#include <prism/file.h>
+#include <prism/log.h>
+
+using namespace std;
+
+// Stream layout: header, then per frame one byte controller amount followed by one 16 bit mask per controller
+#define INPUT_RECORDING_MAGIC 0x50524944
+#define INPUT_RECORDING_VERSION 2
+
+typedef struct {
+	uint32_t mMagic;
+	uint32_t mVersion;
+	uint32_t mSeed;
+	uint32_t mFrameAmount;
+} InputRecordingHeader;
+
+typedef enum {
+	INPUT_RECORDING_MODE_NONE,
+	INPUT_RECORDING_MODE_RECORD,
+	INPUT_RECORDING_MODE_PLAYBACK,
+} InputRecordingMode;
+
+static struct {
+	InputRecordingMode mRequestedMode;
+	string mPath;
+
+	InputRecordingMode mActiveMode;
+	InputRecordingHeader mHeader;
+	vector<uint8_t> mStream;
+	size_t mStreamPosition;
+} gInputRecordingData;
+
+void setDreamInputRecordingPath(const char* tPath)
+{
+	gInputRecordingData.mRequestedMode = INPUT_RECORDING_MODE_RECORD;
+	gInputRecordingData.mPath = tPath;
+}
+
+void setDreamInputPlaybackPath(const char* tPath)
+{
+	gInputRecordingData.mRequestedMode = INPUT_RECORDING_MODE_PLAYBACK;
+	gInputRecordingData.mPath = tPath;
+}
+
+void resetDreamInputRecordingAndPlayback()
+{
+	gInputRecordingData.mRequestedMode = INPUT_RECORDING_MODE_NONE;
+	gInputRecordingData.mPath.clear();
+}
+
+static void startRecording() {
+	gInputRecordingData.mHeader.mMagic = INPUT_RECORDING_MAGIC;
+	gInputRecordingData.mHeader.mVersion = INPUT_RECORDING_VERSION;
+	gInputRecordingData.mHeader.mSeed = (uint32_t)time(NULL);
+	gInputRecordingData.mHeader.mFrameAmount = 0;
+	gInputRecordingData.mStream.clear();
+	srand(gInputRecordingData.mHeader.mSeed);
+	gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_RECORD;
+	logFormat("Recording input to %s with seed %u.", gInputRecordingData.mPath.c_str(), gInputRecordingData.mHeader.mSeed);
+}
+
+static void startPlayback() {
+	const char* path = gInputRecordingData.mPath.c_str();
+	if (!isFile(path)) {
+		logWarningFormat("Unable to find input recording %s. Using live input.", path);
+		return;
+	}
+
+	Buffer b = fileToBuffer(path);
+	if (b.mLength < sizeof(InputRecordingHeader)) {
+		logWarningFormat("Input recording %s is too short. Using live input.", path);
+		freeBuffer(b);
+		return;
+	}
+
+	memcpy(&gInputRecordingData.mHeader, b.mData, sizeof(InputRecordingHeader));
+	if (gInputRecordingData.mHeader.mMagic != INPUT_RECORDING_MAGIC || gInputRecordingData.mHeader.mVersion != INPUT_RECORDING_VERSION) {
+		logWarningFormat("Input recording %s has unknown format. Using live input.", path);
+		freeBuffer(b);
+		return;
+	}
+
+	const uint8_t* data = (const uint8_t*)b.mData;
+	gInputRecordingData.mStream.assign(data + sizeof(InputRecordingHeader), data + b.mLength);
+	gInputRecordingData.mStreamPosition = 0;
+	freeBuffer(b);
+
+	srand(gInputRecordingData.mHeader.mSeed);
+	gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_PLAYBACK;
+	logFormat("Playing back input from %s (%u frames, seed %u).", path, gInputRecordingData.mHeader.mFrameAmount, gInputRecordingData.mHeader.mSeed);
+}
+
+void startDreamInputRecordingOrPlayback()
+{
+	gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_NONE;
+	if (gInputRecordingData.mRequestedMode == INPUT_RECORDING_MODE_RECORD) {
+		startRecording();
+	}
+	else if (gInputRecordingData.mRequestedMode == INPUT_RECORDING_MODE_PLAYBACK) {
+		startPlayback();
+	}
+}
+
+static void saveRecording() {
+	vector<uint8_t> file(sizeof(InputRecordingHeader) + gInputRecordingData.mStream.size());
+	memcpy(file.data(), &gInputRecordingData.mHeader, sizeof(InputRecordingHeader));
+	if (!gInputRecordingData.mStream.empty()) {
+		memcpy(file.data() + sizeof(InputRecordingHeader), gInputRecordingData.mStream.data(), gInputRecordingData.mStream.size());
+	}
+	bufferToFile(gInputRecordingData.mPath.c_str(), makeBuffer(file.data(), file.size()));
+	logFormat("Saved %u input frames to %s.", gInputRecordingData.mHeader.mFrameAmount, gInputRecordingData.mPath.c_str());
+}
+
+void finishDreamInputRecordingOrPlayback()
+{
+	if (gInputRecordingData.mActiveMode == INPUT_RECORDING_MODE_RECORD) {
+		saveRecording();
+	}
+	gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_NONE;
+	gInputRecordingData.mStream.clear();
+	gInputRecordingData.mStream.shrink_to_fit();
+}
+
+int isDreamInputRecordingActive()
+{
+	return gInputRecordingData.mActiveMode == INPUT_RECORDING_MODE_RECORD;
+}
+
+int isDreamInputPlaybackActive()
+{
+	return gInputRecordingData.mActiveMode == INPUT_RECORDING_MODE_PLAYBACK;
+}
+
+void recordDreamInputFrame(const uint32_t* tMasks, int tControllerAmount)
+{
+	if (tControllerAmount > 0xFF) tControllerAmount = 0xFF;
+	vector<uint8_t>& stream = gInputRecordingData.mStream;
+	stream.push_back((uint8_t)tControllerAmount);
+	int i;
+	for (i = 0; i < tControllerAmount; i++) {
+		stream.push_back((uint8_t)(tMasks[i] & 0xFF));
+		stream.push_back((uint8_t)((tMasks[i] >> 8) & 0xFF));
+	}
+	gInputRecordingData.mHeader.mFrameAmount++;
+}
+
+void readDreamInputPlaybackFrame(uint32_t* oMasks, int tControllerAmount)
+{
+	memset(oMasks, 0, sizeof(uint32_t) * tControllerAmount);
+
+	const vector<uint8_t>& stream = gInputRecordingData.mStream;
+	size_t& position = gInputRecordingData.mStreamPosition;
+	if (position >= stream.size()) {
+		logg("Input playback finished. Using live input.");
+		gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_NONE;
+		return;
+	}
+
+	int frameAmount = stream[position++];
+	if (position + (size_t)frameAmount * 2 > stream.size()) {
+		logWarningFormat("Input recording %s is truncated. Using live input.", gInputRecordingData.mPath.c_str());
+		gInputRecordingData.mActiveMode = INPUT_RECORDING_MODE_NONE;
+		return;
+	}
+
+	int i;
+	for (i = 0; i < frameAmount; i++) {
+		uint32_t mask = stream[position] | (stream[position + 1] << 8);
+		position += 2;
+		if (i < tControllerAmount) {
+			oMasks[i] = mask;
+		}
+	}
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+void setDreamInputRecordingPath(const char* tPath);
+void setDreamInputPlaybackPath(const char* tPath);
+void resetDreamInputRecordingAndPlayback();
+
+void startDreamInputRecordingOrPlayback();
+void finishDreamInputRecordingOrPlayback();
+
+int isDreamInputRecordingActive();
+int isDreamInputPlaybackActive();
+void recordDreamInputFrame(const uint32_t* tMasks, int tControllerAmount);
+void readDreamInputPlaybackFrame(uint32_t* oMasks, int tControllerAmount);
@@ -24,6 +24,7 @@
 #include "dolmexicadebug.h"
 #include "debugscreen.h"
 #include "initscreen.h"
+#include "batchmode.h"
 
 char romdisk_buffer[1];
 int romdisk_buffer_length;
@@ -54,8 +55,7 @@ void exitGame() {
 }
 
 int main(int argc, char** argv) {
-	(void)argc;
-	(void)argv;
+	int isBatchMode = parseBatchModeArguments(argc, argv);
 
 #ifdef DEVELOP
 	setDevelopMode();
@@ -95,7 +95,7 @@ int main(int argc, char** argv) {
 	initDolmexicaDebug();
 #endif
 
-	startScreenHandling(getInitScreen());
+	startScreenHandling(isBatchMode ? getBatchModeScreen() : getInitScreen());
 	
 	exitGame();
 	
@@ -5,6 +5,8 @@
 #include <assert.h>
 #include <math.h>
 
+#include <vector>
+
 #include <prism/memoryhandler.h>
 #include <prism/log.h>
 #include <prism/system.h>
@@ -15,6 +17,7 @@
 #include "playerhitdata.h"
 #include "gamelogic.h"
 #include "mugencommandhandler.h"
+#include "mugenassignmentevaluator.h"
 
 using namespace std;
 
@@ -25,6 +28,7 @@ static struct {
 
 	int mHasCommandHandlerEntryForLookup;
 	int mCommandHandlerID;
+	DreamMugenCommands* mCommandsForLookup;
 } gMugenAssignmentData;
 
 void setupDreamAssignmentReader(MemoryStack* tMemoryStack) {
@@ -42,9 +46,15 @@ void setDreamAssignmentCommandLookupID(int tID)
 	gMugenAssignmentData.mHasCommandHandlerEntryForLookup = 1;
 }
 
+void setDreamAssignmentCommandLookupCommands(DreamMugenCommands* tCommands)
+{
+	gMugenAssignmentData.mCommandsForLookup = tCommands;
+}
+
 void resetDreamAssignmentCommandLookupID()
 {
 	gMugenAssignmentData.mHasCommandHandlerEntryForLookup = 0;
+	gMugenAssignmentData.mCommandsForLookup = NULL;
 }
 
 static void* allocMemoryOnMemoryStackOrMemory(uint32_t tSize) {
@@ -111,6 +121,17 @@ static void unloadDreamMugenAssignmentRawVariable(DreamMugenAssignment * tAssign
 	freeMemory(e->mName);
 }
 
+static void unloadDreamMugenAssignmentStatic(DreamMugenAssignment * tAssignment) {
+	DreamMugenStaticAssignment* e = (DreamMugenStaticAssignment*)tAssignment;
+	destroyDreamMugenAssignment(e->mOriginal);
+}
+
+static void unloadDreamMugenAssignmentCompiled(DreamMugenAssignment * tAssignment) {
+	DreamMugenCompiledAssignment* e = (DreamMugenCompiledAssignment*)tAssignment;
+	freeMemory(e->mInstructions);
+	destroyDreamMugenAssignment(e->mTree);
+}
+
 void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 {
 	switch (tAssignment->mType) {
@@ -164,6 +185,12 @@ void destroyDreamMugenAssignment(DreamMugenAssignment * tAssignment)
 	case MUGEN_ASSIGNMENT_TYPE_STRING:
 		unloadDreamMugenAssignmentString(tAssignment);
 		break;	
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		unloadDreamMugenAssignmentStatic(tAssignment);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_COMPILED:
+		unloadDreamMugenAssignmentCompiled(tAssignment);
+		break;
 	default:
 		logWarningFormat("Unrecognized assignment format %d. Treating as NULL.\n", tAssignment->mType);
 		unloadDreamMugenAssignmentFixedBoolean(tAssignment);
@@ -282,10 +309,6 @@ DreamMugenAssignment * makeDreamOrMugenAssignment(DreamMugenAssignment * a, Drea
 	return makeMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_OR, a, b);
 }
 
-static int isEmpty(char* tChar) {
-	return !strcmp("", tChar);
-}
-
 static int isEmptyCharacter(char tChar) {
 	return tChar == ' ';
 }
@@ -294,10 +317,21 @@ static int isOperatorCharacter(char tChar) {
 	return tChar == '-' || tChar == '+' || tChar == '|' || tChar == '&' || tChar == '*' || tChar == '/' || tChar == '!';
 }
 
-static int isBinaryOperator(char* tText, int tPosition) {
+static void copyTextSpan(char* oDst, const char* tText, int tStart, int tEnd) {
+	int length = min(tEnd - tStart, MUGEN_DEF_STRING_LENGTH - 1);
+	memcpy(oDst, tText + tStart, length);
+	oDst[length] = '\0';
+}
+
+static void copyTextSpanLowercase(char* oDst, const char* tText, int tStart, int tEnd) {
+	copyTextSpan(oDst, tText, tStart, tEnd);
+	turnStringLowercase(oDst);
+}
+
+static int isBinaryOperator(const char* tText, int tStart, int tEnd, int tPosition) {
 	int p = tPosition - 1;
 	int poss = 0;
-	while (p >= 0) {
+	while (p >= tStart) {
 		if (isEmptyCharacter(tText[p])) p--;
 		else if (isOperatorCharacter(tText[p])) return 0;
 		else {
@@ -308,10 +342,9 @@ static int isBinaryOperator(char* tText, int tPosition) {
 
 	if (!poss) return 0;
 
-	int n = strlen(tText);
 	p = tPosition + 1;
 	poss = 0;
-	while (p < n) {
+	while (p < tEnd) {
 		if (isEmptyCharacter(tText[p])) p++;
 		else if (isOperatorCharacter(tText[p])) return 0;
 		else {
@@ -323,94 +356,105 @@ static int isBinaryOperator(char* tText, int tPosition) {
 	return poss;
 }
 
-static int isOnHighestLevelWithStartPosition(char* tText, const char* tPattern, int* tOptionalPosition, int tStart, int isBinary) {
-	int n = strlen(tText);
-	int m = strlen(tPattern);
+static void updateHighestLevelDepth(char tChar, int* ioDepth1, int* ioDepth2, int* ioDepth3) {
+	if (tChar == '(') (*ioDepth1)++;
+	if (tChar == ')') (*ioDepth1)--;
+	if (tChar == '[') (*ioDepth2)++;
+	if (tChar == ']') (*ioDepth2)--;
+	if (tChar == '"') (*ioDepth3) ^= 1;
+}
+
+// ordered by precedence, a span is split at the first of its lowest operators
+typedef enum {
+	ASSIGNMENT_OPERATOR_COMMA,
+	ASSIGNMENT_OPERATOR_OR,
+	ASSIGNMENT_OPERATOR_AND,
+	ASSIGNMENT_OPERATOR_BITWISE_OR,
+	ASSIGNMENT_OPERATOR_BITWISE_AND,
+	ASSIGNMENT_OPERATOR_VARIABLE_SET,
+	ASSIGNMENT_OPERATOR_INEQUALITY,
+	ASSIGNMENT_OPERATOR_COMPARISON,
+	ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL,
+	ASSIGNMENT_OPERATOR_LESS_OR_EQUAL,
+	ASSIGNMENT_OPERATOR_LESS,
+	ASSIGNMENT_OPERATOR_GREATER,
+	ASSIGNMENT_OPERATOR_ADDITION,
+	ASSIGNMENT_OPERATOR_SUBTRACTION,
+	ASSIGNMENT_OPERATOR_MODULO,
+	ASSIGNMENT_OPERATOR_MULTIPLICATION,
+	ASSIGNMENT_OPERATOR_DIVISION,
+	ASSIGNMENT_OPERATOR_EXPONENTIATION,
+	ASSIGNMENT_OPERATOR_REDIRECTION,
+	ASSIGNMENT_OPERATOR_AMOUNT,
+} AssignmentOperator;
+
+static const DreamMugenAssignmentType gAssignmentOperatorTypes[ASSIGNMENT_OPERATOR_AMOUNT] = {
+	MUGEN_ASSIGNMENT_TYPE_VECTOR,
+	MUGEN_ASSIGNMENT_TYPE_OR,
+	MUGEN_ASSIGNMENT_TYPE_AND,
+	MUGEN_ASSIGNMENT_TYPE_BITWISE_OR,
+	MUGEN_ASSIGNMENT_TYPE_BITWISE_AND,
+	MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE,
+	MUGEN_ASSIGNMENT_TYPE_INEQUALITY,
+	MUGEN_ASSIGNMENT_TYPE_COMPARISON,
+	MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL,
+	MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL,
+	MUGEN_ASSIGNMENT_TYPE_LESS,
+	MUGEN_ASSIGNMENT_TYPE_GREATER,
+	MUGEN_ASSIGNMENT_TYPE_ADDITION,
+	MUGEN_ASSIGNMENT_TYPE_SUBTRACTION,
+	MUGEN_ASSIGNMENT_TYPE_MODULO,
+	MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION,
+	MUGEN_ASSIGNMENT_TYPE_DIVISION,
+	MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION,
+	MUGEN_ASSIGNMENT_TYPE_VECTOR,
+};
+
+typedef struct {
+	const char* mText;
+	int mStart;
+	int mEnd;
+} AssignmentTextSpan;
+
+typedef struct {
+	AssignmentOperator mOperator;
+	int mPosition;
+	int mLength;
+
+	uint8_t mIsBinaryEquals;
+	int mWordEnd;
+	int mWordSpace;
+
+	uint8_t mIsContextFree;
+	int mCommaWordStart;
+	int mCommaWordEnd;
+	int mLastEquals;
+
+	int mSpanStart;
+
+	// whether the span starting behind this token may be split at these operators
+	uint8_t mCanSplitAtComma;
+	uint8_t mCanSplitAtComparison;
+	uint8_t mCanSplitAtMultiplication;
+} AssignmentToken;
+
+// lowest precedences an operator needs to continue the spans a span is nested in
+typedef struct AssignmentSpanBounds {
+	int mPrecedence;
+	int mCommaPrecedence;
+	int mComparisonPrecedence;
+	int mMultiplicationPrecedence;
+
+	int mSpanToken;
+	int mSpanPrecedence;
+	struct AssignmentSpanBounds* mParent;
+} AssignmentSpanBounds;
 
-	int depth1 = 0;
-	int depth2 = 0;
-	int depth3 = 0;
-	int i;
-	for (i = tStart; i < n - m + 1; i++) {
-		if (tText[i] == '(') depth1++;
-		if (tText[i] == ')') depth1--;
-		if (tText[i] == '[') depth2++;
-		if (tText[i] == ']') depth2--;
-		if (tText[i] == '"') depth3 ^= 1;
-
-		if (depth1 || depth2 || depth3) continue;
-
-		int isSame = 1;
-		int j;
-		for (j = 0; j < m; j++) {
-			if (tText[i + j] != tPattern[j]) {
-				isSame = 0;
-				break;
-			}
-		}
-
-		if (isSame && (!isBinary || isBinaryOperator(tText, i))) {
-			if (tOptionalPosition) *tOptionalPosition = i;
-			return 1;
-		}
-	}
-
-	return 0;
-}
-
-static int isOnHighestLevel(char* tText, const char* tPattern, int* tOptionalPosition) {
-	return isOnHighestLevelWithStartPosition(tText, tPattern, tOptionalPosition, 0, 0);
-}
-
-static int isOnHighestLevelBinary(char* tText, const char* tPattern, int* tOptionalPosition) {
-	return isOnHighestLevelWithStartPosition(tText, tPattern, tOptionalPosition, 0, 1);
-}
-
-static DreamMugenAssignment* parseOneElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType) {
-	
-	DreamMugenAssignment* a = parseDreamMugenAssignmentFromString(tText);
-
-	return makeMugenOneElementAssignment(tType, a);
-}
-
-static DreamMugenAssignment* parseTwoElementMugenAssignmentFromStringWithFixedPosition(char* tText, DreamMugenAssignmentType tType, const char* tPattern, int tPosition) {
-	int n = strlen(tText);
-	int m = strlen(tPattern);
-
-	assert(tPosition != -1);
-	if (tPosition >= n - m) {
-		logWarningFormat("Parsing error: Incorrect two element assignment: text %s with pattern %s", tText, tPattern);
-	}
-
-	int start = tPosition;
-	int end = tPosition + m;
-
-	char text1[MUGEN_DEF_STRING_LENGTH];
-	char text2[MUGEN_DEF_STRING_LENGTH];
-
-	strcpy(text1, tText);
-	text1[start] = '\0';
-
-	strcpy(text2, &tText[end]);
-
-	DreamMugenAssignment* a = parseDreamMugenAssignmentFromString(text1);
-	DreamMugenAssignment* b = parseDreamMugenAssignmentFromString(text2);
-
-	return makeMugenTwoElementAssignment(tType, a, b);
-}
-
-static DreamMugenAssignment* parseTwoElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType, const char* tPattern) {
-	int pos = -1;
-	isOnHighestLevel(tText, tPattern, &pos);
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, tType, tPattern, pos);
-}
-
-static DreamMugenAssignment* parseBinaryTwoElementMugenAssignmentFromString(char* tText, DreamMugenAssignmentType tType, const char* tPattern) {
-	int pos = -1;
-	isOnHighestLevelBinary(tText, tPattern, &pos);
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, tType, tPattern, pos);
-}
+static struct {
+	vector<AssignmentToken> mTokens;
+} gAssignmentParserData;
 
+static DreamMugenAssignment* parseDreamMugenAssignmentFromTextSpan(const char* tText, int tStart, int tEnd);
 
 static DreamMugenAssignment* parseMugenNullFromString() {
 	DreamMugenFixedBooleanAssignment* data = (DreamMugenFixedBooleanAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenFixedBooleanAssignment));
@@ -420,17 +464,15 @@ static DreamMugenAssignment* parseMugenNullFromString() {
 	return (DreamMugenAssignment*)data;
 }
 
-
-
-static int isInBraces(char* tText) {
-	int n = strlen(tText);
-	if (tText[0] != '(' || tText[n - 1] != ')') return 0;
+static int isInBraces(AssignmentTextSpan* tSpan) {
+	const char* text = tSpan->mText;
+	if (text[tSpan->mStart] != '(' || text[tSpan->mEnd - 1] != ')') return 0;
 
 	int depth = 0;
 	int i;
-	for (i = 0; i < n - 1; i++) {
-		if (tText[i] == '(') depth++;
-		if (tText[i] == ')') depth--;
+	for (i = tSpan->mStart; i < tSpan->mEnd - 1; i++) {
+		if (text[i] == '(') depth++;
+		if (text[i] == ')') depth--;
 
 		if (!depth) return 0;
 	}
@@ -438,41 +480,23 @@ static int isInBraces(char* tText) {
 	return 1;
 }
 
-static DreamMugenAssignment* parseMugenAssignmentStringInBraces(char* tText) {
-	int n = strlen(tText);
-	tText[n - 1] = '\0';
-	tText++;
-
-	return parseDreamMugenAssignmentFromString(tText);
-}
-
-static int isNegation(char* tText) {
-	return (tText[0] == '!');
-}
-
-static DreamMugenAssignment* parseMugenNegationFromString(char* tText) {
-	tText++;
-	return parseOneElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_NEGATION);
-}
-
-static int isUnaryMinus(char* tText) {
-	return (tText[0] == '-');
+static int isNegation(AssignmentTextSpan* tSpan) {
+	return tSpan->mText[tSpan->mStart] == '!';
 }
 
-static DreamMugenAssignment* parseMugenUnaryMinusFromString(char* tText) {
-	tText++;
-	return parseOneElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS);
+static int isUnaryMinus(AssignmentTextSpan* tSpan) {
+	return tSpan->mText[tSpan->mStart] == '-';
 }
 
-static int isRange(char* tText) {
-	int n = strlen(tText);
-	if ((tText[0] != '[' && tText[0] != '(') || (tText[n - 1] != ']' && tText[n - 1] != ')')) return 0;
+static int isRange(AssignmentTextSpan* tSpan) {
+	const char* text = tSpan->mText;
+	if ((text[tSpan->mStart] != '[' && text[tSpan->mStart] != '(') || (text[tSpan->mEnd - 1] != ']' && text[tSpan->mEnd - 1] != ')')) return 0;
 
 	int depth = 0;
 	int i;
-	for (i = 0; i < n - 1; i++) {
-		if (tText[i] == '(' || tText[i] == '[') depth++;
-		if (tText[i] == ')' || tText[i] == ']') depth--;
+	for (i = tSpan->mStart; i < tSpan->mEnd - 1; i++) {
+		if (text[i] == '(' || text[i] == '[') depth++;
+		if (text[i] == ')' || text[i] == ']') depth--;
 
 		if (!depth) return 0;
 	}
@@ -480,259 +504,75 @@ static int isRange(char* tText) {
 	return 1;
 }
 
-static DreamMugenAssignment* parseMugenRangeFromString(char* tText) {
+static DreamMugenAssignment* parseMugenRangeFromTextSpan(AssignmentTextSpan* tSpan) {
 	DreamMugenRangeAssignment* e = (DreamMugenRangeAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRangeAssignment));
 	gDebugAssignmentAmount++;
-	int n = strlen(tText);
-	e->mExcludeLeft = tText[0] == '(';
-	e->mExcludeRight = tText[n - 1] == ')';
-	
-	tText[n - 1] = '\0';
-	tText++;
-
-	e->a = parseDreamMugenAssignmentFromString(tText);
+	e->mExcludeLeft = tSpan->mText[tSpan->mStart] == '(';
+	e->mExcludeRight = tSpan->mText[tSpan->mEnd - 1] == ')';
+	e->a = parseDreamMugenAssignmentFromTextSpan(tSpan->mText, tSpan->mStart + 1, tSpan->mEnd - 1);
 	e->mType = MUGEN_ASSIGNMENT_TYPE_RANGE;
 	return (DreamMugenAssignment*)e;
 }
 
-
-static int isInequality(char* tText) {
-	return isOnHighestLevel(tText, "!=", NULL);
-}
-
-static DreamMugenAssignment* parseMugenInequalityFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_INEQUALITY, "!=");
-}
-
-static int isVariableSet(char* tText) {
-	return isOnHighestLevel(tText, ":=", NULL);
-}
-
-static DreamMugenAssignment* parseMugenVariableSetFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE, ":=");
-}
-
-static int isComparison(char* tText) {
-	int position;
-
-	if(!isOnHighestLevel(tText, "=", &position)) return 0;
-	if (position == 0) return 0;
-	if (tText[position - 1] == '!') return 0;
-	if (tText[position - 1] == '<') return 0;
-	if (tText[position - 1] == '>') return 0;
-	if (tText[position - 1] == ':') return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenComparisonFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_COMPARISON, "=");
-}
-
-static int isAnd(char* tText) {
-	return isOnHighestLevel(tText, "&&", NULL);
-}
-
-static DreamMugenAssignment* parseMugenAndFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_AND, "&&");
-}
-
-static int isOr(char* tText) {
-	return isOnHighestLevel(tText, "||", NULL);
-}
-
-static DreamMugenAssignment* parseMugenOrFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_OR, "||");
-}
-
-static int isBitwiseAnd(char* tText) {
-	return isOnHighestLevel(tText, "&", NULL);
-}
-
-static DreamMugenAssignment* parseMugenBitwiseAndFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_BITWISE_AND, "&");
-}
-
-static int isBitwiseOr(char* tText) {
-	return isOnHighestLevel(tText, "|", NULL);
-}
-
-static DreamMugenAssignment* parseMugenBitwiseOrFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_BITWISE_OR, "|");
-}
-
-static int isLessOrEqualThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, "<=", &position)) return 0;
-	if (position == 0) return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenLessOrEqualFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL, "<=");
-}
-
-static int isLessThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, "<", &position)) return 0;
-	if (position == 0) return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenLessFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_LESS, "<");
-}
-
-static int isGreaterOrEqualThan(char* tText) {
-	int position;
-	if (!isOnHighestLevel(tText, ">=", &position)) return 0;
-	if (position == 0) return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenGreaterOrEqualFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL, ">=");
-}
-
-static int isGreaterThan(char* tText) {
-	int position;
-	if(!isOnHighestLevel(tText, ">", &position)) return 0;
-	if (position == 0) return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenGreaterFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_GREATER, ">");
-}
-
-static int isExponentiation(char* tText) {
-	return isOnHighestLevel(tText, "**", NULL);
-}
-
-static DreamMugenAssignment* parseMugenExponentiationFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION, "**");
-}
-
-static int isAddition(char* tText) {
-	int plusPosition;
-	if(!isOnHighestLevel(tText, "+", &plusPosition)) return 0;
-	int len = strlen(tText);
-	return plusPosition < len -1;
-}
-
-static DreamMugenAssignment* parseMugenAdditionFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_ADDITION, "+");
-}
-
-static int isSubtraction(char* tText) {
-	return isOnHighestLevelBinary(tText, "-", NULL);
-}
-
-static DreamMugenAssignment* parseMugenSubtractionFromString(char* tText) {
-	return parseBinaryTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_SUBTRACTION, "-");
-}
-
-static int isMultiplication(char* tText) {
-	int position = 0;
-	int n = strlen(tText);
-
-	if (!isOnHighestLevel(tText, "*", &position)) return 0;
-	if (position == 0) return 0;
-	if (position < n-1 && tText[position + 1] == '*') return 0;
-
-	return 1;
-}
-
-static DreamMugenAssignment* parseMugenMultiplicationFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION, "*");
-}
-
-static int isDivision(char* tText) {
-	return isOnHighestLevel(tText, "/", NULL);
-}
-
-static DreamMugenAssignment* parseMugenDivisionFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_DIVISION, "/");
-}
-
-static int isModulo(char* tText) {
-	return isOnHighestLevel(tText, "%", NULL);
-}
-
-static DreamMugenAssignment* parseMugenModuloFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_MODULO, "%");
-}
-
-static int isNumericalConstant(char* tText) {
-	if (*tText == '-') tText++;
-
-	int n = strlen(tText);
-	if (n == 0) return 0;
+static int isNumberText(AssignmentTextSpan* tSpan, int tMaximumPointAmount) {
+	int start = tSpan->mStart;
+	if (tSpan->mText[start] == '-') start++;
+	if (start == tSpan->mEnd) return 0;
 
 	int mPointAmount = 0;
 	int i;
-	for (i = 0; i < n; i++) {
-		if (tText[i] == '.') mPointAmount++;
-		else if (tText[i] >= '0' && tText[i] <= '9') continue;
+	for (i = start; i < tSpan->mEnd; i++) {
+		if (tSpan->mText[i] == '.') mPointAmount++;
+		else if (tSpan->mText[i] >= '0' && tSpan->mText[i] <= '9') continue;
 		else return 0;
 	}
 
-	return mPointAmount <= 0;
+	return mPointAmount <= tMaximumPointAmount;
 }
 
-static DreamMugenAssignment* parseNumericalConstantFromString(char* tText) {
-	int val = atoi(tText);
-
-	return makeDreamNumberMugenAssignment(val);
+static int isNumericalConstant(AssignmentTextSpan* tSpan) {
+	return isNumberText(tSpan, 0);
 }
 
-static int isFloatConstant(char* tText) {
-	if (*tText == '-') tText++;
-
-	int n = strlen(tText);
-	if (n == 0) return 0;
-
-	int mPointAmount = 0;
-	int i;
-	for (i = 0; i < n; i++) {
-		if (tText[i] == '.') mPointAmount++;
-		else if (tText[i] >= '0' && tText[i] <= '9') continue;
-		else return 0;
-	}
-
-	return mPointAmount <= 1;
+static DreamMugenAssignment* parseNumericalConstantFromTextSpan(AssignmentTextSpan* tSpan) {
+	char text[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpan(text, tSpan->mText, tSpan->mStart, tSpan->mEnd);
+	return makeDreamNumberMugenAssignment(atoi(text));
 }
 
-static DreamMugenAssignment* parseFloatConstantFromString(char* tText) {
-	double f = atof(tText);
+static int isFloatConstant(AssignmentTextSpan* tSpan) {
+	return isNumberText(tSpan, 1);
+}
 
-	return makeDreamFloatMugenAssignment(f);
+static DreamMugenAssignment* parseFloatConstantFromTextSpan(AssignmentTextSpan* tSpan) {
+	char text[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpan(text, tSpan->mText, tSpan->mStart, tSpan->mEnd);
+	return makeDreamFloatMugenAssignment(atof(text));
 }
 
-static int isStringConstant(char* tText) {
-	int n = strlen(tText);
-	if (n == 0) return 0;
-	return tText[0] == '"' && tText[n - 1] == '"';
+static int isStringConstant(AssignmentTextSpan* tSpan) {
+	return tSpan->mEnd - tSpan->mStart >= 2 && tSpan->mText[tSpan->mStart] == '"' && tSpan->mText[tSpan->mEnd - 1] == '"';
 }
 
-static DreamMugenAssignment* parseStringConstantFromString(char* tText) {
+static DreamMugenAssignment* parseStringConstantFromTextSpan(AssignmentTextSpan* tSpan) {
+	string value(tSpan->mText + tSpan->mStart + 1, tSpan->mEnd - tSpan->mStart - 2);
 	if (gMugenAssignmentData.mHasCommandHandlerEntryForLookup) {
-		string potentialCommand(tText + 1, strlen(tText + 1) - 1);
 		int potentialCommandIndex;
-		if (isDreamCommandForLookup(gMugenAssignmentData.mCommandHandlerID, potentialCommand.data(), &potentialCommandIndex)) {
+		if (isDreamCommandForLookup(gMugenAssignmentData.mCommandHandlerID, value.data(), &potentialCommandIndex)) {
+			return makeDreamNumberMugenAssignment(potentialCommandIndex);
+		}
+	}
+	else if (gMugenAssignmentData.mCommandsForLookup) {
+		int potentialCommandIndex;
+		if (isDreamCommandForLookupInCommands(gMugenAssignmentData.mCommandsForLookup, value.data(), &potentialCommandIndex)) {
 			return makeDreamNumberMugenAssignment(potentialCommandIndex);
 		}
 	}
 
 	DreamMugenStringAssignment* s = (DreamMugenStringAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenStringAssignment));
 	gDebugAssignmentAmount++;
-	s->mValue = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tText + 1) + 10);
-	strcpy(s->mValue, tText+1);
-	s->mValue[strlen(s->mValue) - 1] = '\0';
+	s->mValue = (char*)allocMemoryOnMemoryStackOrMemory(value.size() + 10);
+	strcpy(s->mValue, value.data());
 
 	s->mType = MUGEN_ASSIGNMENT_TYPE_STRING;
 	return (DreamMugenAssignment*)s;
@@ -753,395 +593,505 @@ int doDreamAssignmentStringsBeginsWithPattern(const char* tPattern, char* tText)
 
 extern std::map<std::string, AssignmentReturnValue*(*)(DreamPlayer*)>& getActiveMugenAssignmentVariableMap();
 
-static int isMugenVariable(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
+static int isDefinitionConstantVariableName(const char* tName) {
+	if (strncmp("const(", tName, 6)) return 0;
 
-	auto m = getActiveMugenAssignmentVariableMap();
-	
-	int ret = m.find(text) != m.end();
-	freeMemory(text);
-
-	return ret;
+	// life gets scaled after the states are loaded and helper size parameters overwrite the size constants during the fight
+	return strcmp("const(data.life)", tName) && strncmp("const(size.ground.", tName, 18) && strncmp("const(size.air.", tName, 15) && strcmp("const(size.height)", tName) && strncmp("const(size.head.pos.", tName, 20) && strncmp("const(size.mid.pos.", tName, 19) && strcmp("const(size.shadowoffset)", tName);
 }
 
-static DreamMugenAssignment* parseMugenVariableFromString(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
-	
+static DreamMugenAssignment* parseMugenVariableFromFunction(const char* tName, AssignmentReturnValue*(*tFunc)(DreamPlayer*)) {
 	DreamMugenVariableAssignment* data = (DreamMugenVariableAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenVariableAssignment));
 	gDebugAssignmentAmount++;
-	auto m = getActiveMugenAssignmentVariableMap();
-	data->mFunc = (void*)m[text];
+	data->mFunc = (void*)tFunc;
+	data->mIsDefinitionConstant = isDefinitionConstantVariableName(tName);
 	data->mType = MUGEN_ASSIGNMENT_TYPE_VARIABLE;
-	freeMemory(text);
 	return (DreamMugenAssignment*)data;
 }
 
-static DreamMugenAssignment* parseMugenRawVariableFromString(char* tText) {
+
+static DreamMugenAssignment* parseMugenRawVariableFromString(const char* tName) {
 	DreamMugenRawVariableAssignment* data = (DreamMugenRawVariableAssignment*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenRawVariableAssignment));
 	gDebugAssignmentAmount++;
-	data->mName = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tText) + 2);
-	strcpy(data->mName, tText);
-	turnStringLowercase(data->mName);
+	data->mName = (char*)allocMemoryOnMemoryStackOrMemory(strlen(tName) + 2);
+	strcpy(data->mName, tName);
 	data->mType = MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE;
+	bindDreamRawVariableAssignment(data);
 	return (DreamMugenAssignment*)data;
 }
 
-static void sanitizeTextFront(char** tText) {
-	int n = strlen(*tText);
-	int i;
-	for (i = 0; i < n; i++) {
-		if (**tText != ' ' && **tText != '\t') {
-			return;
-		}
-
-		(*tText)++;
-	}
-}
-
-static void sanitizeTextBack(char* tText) {
-	int n = strlen(tText);
-
-	int i;
-	for (i = n - 1; i >= 0; i--) {
-		if (tText[i] == ' ' || tText[i] == '\t') tText[i] = '\0';
-		else if (tText[i] == ',') tText[i] = '\0';
-		else return;
-	}
-}
-
-static void sanitizeText(char** tText) {
-	sanitizeTextFront(tText);
-	sanitizeTextBack(*tText);
+static void sanitizeTextSpan(const char* tText, int* ioStart, int* ioEnd) {
+	while (*ioStart < *ioEnd && (tText[*ioStart] == ' ' || tText[*ioStart] == '\t')) (*ioStart)++;
+	while (*ioEnd > *ioStart && (tText[*ioEnd - 1] == ' ' || tText[*ioEnd - 1] == '\t' || tText[*ioEnd - 1] == ',')) (*ioEnd)--;
 }
 
+static int isArray(AssignmentTextSpan* tSpan, int* oOpenPosition) {
+	const char* open = (const char*)memchr(tSpan->mText + tSpan->mStart, '(', tSpan->mEnd - tSpan->mStart);
+	if (!open || open == tSpan->mText + tSpan->mStart || tSpan->mText[tSpan->mEnd - 1] != ')' || tSpan->mText + tSpan->mEnd - 1 <= open) return 0;
 
-static int isArray(char* tText) {
-
-	int n = strlen(tText);
-	char* open = strchr(tText, '(');
-	char* close = strrchr(tText, ')');
-
-	return open != NULL && close != NULL && close > open && open != tText && close == (tText + n - 1);
-}
-
-static DreamMugenAssignment* parseArrayFromString(char* tText) {
-	int posOpen = -1;
-	posOpen = strchr(tText, '(') - tText;
-	assert(posOpen >= 0);
-	assert((strrchr(tText, ')') - tText) >= 0);
-
-	char text1[MUGEN_DEF_STRING_LENGTH];
-	char text2[MUGEN_DEF_STRING_LENGTH];
-
-	strcpy(text1, tText);
-	text1[posOpen] = '\0';
-
-	char* saneText1 = text1;
-	sanitizeText(&saneText1);
-	turnStringLowercase(saneText1);
-
-	strcpy(text2, &tText[posOpen+1]);
-	char* text2End = strrchr(text2, ')');
-	*text2End = '\0';
-
-	DreamMugenAssignment* b = parseDreamMugenAssignmentFromString(text2);
-	return makeMugenArrayAssignment(saneText1, b);
+	*oOpenPosition = int(open - tSpan->mText);
+	return 1;
 }
 
-static int isVectorAssignment(char* tText, int tPotentialCommaPosition) {
-	int endPosition = -1;
-	while (endPosition < tPotentialCommaPosition) {
-		int newPosition;
-		if (!isOnHighestLevelWithStartPosition(tText, "=", &newPosition, endPosition + 1, 1)) break;
-		if (newPosition >= tPotentialCommaPosition) break;
-		endPosition = newPosition;
-	}
-	endPosition--;
-	while (endPosition >= 0 && isEmptyCharacter(tText[endPosition])) {
-		endPosition--;
-	}
-	if (endPosition <= 0) return 0;
-	int startPosition = endPosition;
-	while (startPosition > 0 && !isEmptyCharacter(tText[startPosition])) {
-		startPosition--;
-	}
-	if (isEmptyCharacter(tText[startPosition])) startPosition++;
-
-	const char* textArea = tText + startPosition;
-	char* text = (char*)allocMemory(strlen(textArea) + 2);
-	strcpy(text, textArea);
-	turnStringLowercase(text);
+static DreamMugenAssignment* parseArrayFromTextSpan(AssignmentTextSpan* tSpan, int tOpenPosition) {
+	int nameStart = tSpan->mStart;
+	int nameEnd = tOpenPosition;
+	sanitizeTextSpan(tSpan->mText, &nameStart, &nameEnd);
+	char name[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpanLowercase(name, tSpan->mText, nameStart, nameEnd);
 
-	int ret;
-	if (doDreamAssignmentStringsBeginsWithPattern("animelem", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("timemod", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("hitdefattr", text)) ret = 1;
-	else ret = 0;
-
-	freeMemory(text);
-	return ret;
+	DreamMugenAssignment* b = parseDreamMugenAssignmentFromTextSpan(tSpan->mText, tOpenPosition + 1, tSpan->mEnd - 1);
+	return makeMugenArrayAssignment(name, b);
 }
 
 static int isVectorTarget(char* tText) {
-	char* text = (char*)allocMemory(strlen(tText) + 2);
-	strcpy(text, tText);
-	turnStringLowercase(text);
-
-	int ret;
-	if (doDreamAssignmentStringsBeginsWithPattern("target", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("p1", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("p2", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("helper", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("enemy", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("enemynear", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("root", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("playerid", text)) ret = 1;
-	else if (doDreamAssignmentStringsBeginsWithPattern("parent", text)) ret = 1;
-	else ret = 0;
-
-	freeMemory(text);
-	return ret;
-}
-
-static int isCommaContextFree(char* tText, int tPosition) {
-	assert(tText[tPosition] == ',');
+	if (doDreamAssignmentStringsBeginsWithPattern("target", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("p1", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("p2", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("helper", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("enemy", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("enemynear", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("root", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("playerid", tText)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("parent", tText)) return 1;
+	else return 0;
+}
+
+static void findCommaWord(AssignmentTextSpan* tSpan, int tPosition, int* oStart, int* oEnd) {
+	const char* text = tSpan->mText;
+	assert(text[tPosition] == ',');
 	tPosition--;
-	while (tPosition >= 0 && isEmptyCharacter(tText[tPosition])) tPosition--;
-	int end = tPosition+1;
+	while (tPosition >= tSpan->mStart && isEmptyCharacter(text[tPosition])) tPosition--;
+	int end = tPosition + 1;
 
 	int depth1 = 0;
 	int depth2 = 0;
-	while (tPosition >= 0) {
-		if (tText[tPosition] == ')') depth1++;
-		if (tText[tPosition] == '(') {
+	while (tPosition >= tSpan->mStart) {
+		if (text[tPosition] == ')') depth1++;
+		if (text[tPosition] == '(') {
 			if (!depth1) break;
 			else depth1--;
 		}
-		if (tText[tPosition] == ']') depth2++;
-		if (tText[tPosition] == '[') {
+		if (text[tPosition] == ']') depth2++;
+		if (text[tPosition] == '[') {
 			if (!depth2) break;
 			else depth2--;
 		}
 
-		if (!depth1 && !depth2 && (tText[tPosition] == ',' || isEmptyCharacter(tText[tPosition]) || isOperatorCharacter(tText[tPosition]))) break;
+		if (!depth1 && !depth2 && (text[tPosition] == ',' || isEmptyCharacter(text[tPosition]) || isOperatorCharacter(text[tPosition]))) break;
 		tPosition--;
 	}
-	assert(tPosition >= -1);
-	int start = tPosition + 1;
-
-	char* prevWord = (char*)allocMemory(strlen(&tText[start]) + 2);
-	strcpy(prevWord, &tText[start]);
-	int length = end - start;
-	prevWord[length] = '\0';
+	*oStart = tPosition + 1;
+	*oEnd = end;
+}
 
-	int ret = !isVectorTarget(prevWord);
-	freeMemory(prevWord);
-	return ret;
+static int isCommaWordContextFree(const char* tText, int tStart, int tEnd) {
+	char previousWord[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpanLowercase(previousWord, tText, tStart, max(tStart, tEnd));
+	return !isVectorTarget(previousWord);
 }
 
-static int hasContextFreeComma(char* tText, int* tPosition) {
-	int isRunning = 1;
-	int position = 0;
-	while (isRunning) {
-		if (!isOnHighestLevelWithStartPosition(tText, ",", &position, position, 0)) return 0;
-		if (isCommaContextFree(tText, position)) {
-			if (tPosition) *tPosition = position;
-			return 1;
-		}
+static DreamMugenAssignment* parseMugenVariableOrArrayOrRawVariableFromTextSpan(AssignmentTextSpan* tSpan) {
+	char name[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpanLowercase(name, tSpan->mText, tSpan->mStart, tSpan->mEnd);
+
+	auto& m = getActiveMugenAssignmentVariableMap();
+	auto it = m.find(name);
+	if (it != m.end()) {
+		return parseMugenVariableFromFunction(name, it->second);
+	}
 
-		position++;
+	int openPosition;
+	if (isArray(tSpan, &openPosition)) {
+		return parseArrayFromTextSpan(tSpan, openPosition);
 	}
 
-	return 0;
+	return parseMugenRawVariableFromString(name);
+}
+
+static int isVectorAssignment(const char* tText, int tEnd, int tSpanToken, int tCommaToken) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int start = tokens[tSpanToken].mSpanStart;
+	int equals = tokens[tCommaToken].mLastEquals;
+	if (equals <= tSpanToken) return 0;
+	AssignmentToken* e = &tokens[equals];
+	if (e->mOperator == ASSIGNMENT_OPERATOR_COMPARISON && e->mPosition == start) return 0;
+	if (e->mWordEnd <= start) return 0;
+	int startPosition = max(start, e->mWordSpace + 1);
+
+	char word[MUGEN_DEF_STRING_LENGTH];
+	copyTextSpanLowercase(word, tText, startPosition, tEnd);
+
+	if (doDreamAssignmentStringsBeginsWithPattern("animelem", word)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("timemod", word)) return 1;
+	else if (doDreamAssignmentStringsBeginsWithPattern("hitdefattr", word)) return 1;
+	else return 0;
+}
+
+static void addAssignmentToken(AssignmentOperator tOperator, int tPosition, int tLength) {
+	AssignmentToken token;
+	token.mOperator = tOperator;
+	token.mPosition = tPosition;
+	token.mLength = tLength;
+	token.mIsBinaryEquals = 0;
+	token.mWordEnd = -1;
+	token.mWordSpace = -1;
+	token.mIsContextFree = 1;
+	token.mCommaWordStart = -1;
+	token.mCommaWordEnd = -1;
+	token.mLastEquals = -1;
+	token.mSpanStart = tPosition + tLength;
+	token.mCanSplitAtComma = 1;
+	token.mCanSplitAtComparison = 1;
+	token.mCanSplitAtMultiplication = 1;
+	gAssignmentParserData.mTokens.push_back(token);
+}
+
+static int isSubtraction(const char* tText, int tStart, int tEnd, int tPosition) {
+	if (!isBinaryOperator(tText, tStart, tEnd, tPosition)) return 0;
+
+	// a minus behind another operator is unary unless that operator binds tighter than the subtraction
+	AssignmentToken* previous = &gAssignmentParserData.mTokens.back();
+	int p = tPosition - 1;
+	while (isEmptyCharacter(tText[p])) p--;
+	return p >= previous->mPosition + previous->mLength || previous->mOperator == ASSIGNMENT_OPERATOR_MODULO;
 }
 
-static int isVector(char* tText) {
-	int position;
-	return hasContextFreeComma(tText, &position) && !isVectorAssignment(tText, position);
+static int isEqualsOperator(AssignmentOperator tOperator) {
+	return tOperator == ASSIGNMENT_OPERATOR_VARIABLE_SET || tOperator == ASSIGNMENT_OPERATOR_INEQUALITY || tOperator == ASSIGNMENT_OPERATOR_COMPARISON || tOperator == ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL || tOperator == ASSIGNMENT_OPERATOR_LESS_OR_EQUAL;
 }
 
-static DreamMugenAssignment* parseMugenContextFreeVectorFromString(char* tText) {
-	int position;
-	hasContextFreeComma(tText, &position);
+static int isCommaContextFreeInSpan(const char* tText, int tSpanToken, int tCommaToken) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int start = tokens[tSpanToken].mSpanStart;
+	AssignmentToken* comma = &tokens[tCommaToken];
+	if (start <= comma->mCommaWordStart) return comma->mIsContextFree;
 
-	return parseTwoElementMugenAssignmentFromStringWithFixedPosition(tText, MUGEN_ASSIGNMENT_TYPE_VECTOR, ",", position);
+	return isCommaWordContextFree(tText, start, comma->mCommaWordEnd);
 }
 
-static int isVectorInsideAssignmentOrTargetAccess(char* tText) {
-	return isOnHighestLevel(tText, ",", NULL);
-}
+static AssignmentOperator getAssignmentSpanOperator(const char* tText, int tSpanToken, int tToken) {
+	AssignmentOperator op = gAssignmentParserData.mTokens[tToken].mOperator;
+	if (op == ASSIGNMENT_OPERATOR_COMMA && !isCommaContextFreeInSpan(tText, tSpanToken, tToken)) return ASSIGNMENT_OPERATOR_REDIRECTION;
 
-static DreamMugenAssignment* parseMugenVectorFromString(char* tText) {
-	return parseTwoElementMugenAssignmentFromString(tText, MUGEN_ASSIGNMENT_TYPE_VECTOR, ",");
+	return op;
 }
 
-static int isOperatorAndReturnType(char* tText, char* tDst) {
-	int position;
-	int isThere;
-	int isDifferent;
+static void setAssignmentTokenSplitFlags(AssignmentTextSpan* tSpan, int tFirstToken) {
+	const char* text = tSpan->mText;
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int amount = int(tokens.size());
 
-	isThere = isOnHighestLevel(tText, ">=", &position);
-	isDifferent = strcmp(">=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, ">=");
-		return 1;
+	int lastEquals = -1;
+	int i;
+	for (i = tFirstToken; i < amount; i++) {
+		while (tokens[i].mSpanStart < tSpan->mEnd && (text[tokens[i].mSpanStart] == ' ' || text[tokens[i].mSpanStart] == '\t')) tokens[i].mSpanStart++;
+		if (tokens[i].mIsBinaryEquals) lastEquals = i;
+		if (tokens[i].mOperator == ASSIGNMENT_OPERATOR_COMMA) tokens[i].mLastEquals = lastEquals;
 	}
 
-	isThere = isOnHighestLevel(tText, "<=", &position);
-	isDifferent = strcmp("<=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, "<=");
-		return 1;
-	}
+	// spans only split at the first comma, equals sign and star of their text when it is of the right kind
+	int nextComma = -1;
+	int nextContextFreeComma = -1;
+	int nextContextFreeCommaBehindComma = -1;
+	AssignmentOperator nextEquals = ASSIGNMENT_OPERATOR_AMOUNT;
+	AssignmentOperator nextStar = ASSIGNMENT_OPERATOR_AMOUNT;
+	for (i = amount - 2; i >= tFirstToken; i--) {
+		AssignmentOperator next = tokens[i + 1].mOperator;
+		if (next == ASSIGNMENT_OPERATOR_COMMA) {
+			nextComma = i + 1;
+			nextContextFreeCommaBehindComma = nextContextFreeComma;
+			if (tokens[i + 1].mIsContextFree) nextContextFreeComma = i + 1;
+		}
+		if (isEqualsOperator(next)) nextEquals = next;
+		if (next == ASSIGNMENT_OPERATOR_MULTIPLICATION || next == ASSIGNMENT_OPERATOR_EXPONENTIATION) nextStar = next;
 
-	isThere = isOnHighestLevel(tText, "=", &position);
-	isDifferent = strcmp("=", tText);
-	if (isThere && isDifferent && position == 0) {
-		strcpy(tDst, "=");
-		return 1;
-	}
+		// a span starting inside the word in front of a comma only sees the rest of that word
+		int comma = nextContextFreeComma;
+		if (nextComma >= 0 && tokens[i].mSpanStart > tokens[nextComma].mCommaWordStart) {
+			comma = isCommaContextFreeInSpan(text, i, nextComma) ? nextComma : nextContextFreeCommaBehindComma;
+		}
 
-	isThere = isOnHighestLevel(tText, "<", &position);
-	isDifferent = strcmp("<", tText);
-	if (isThere && isDifferent && position == 0 && tText[1] != '=') {
-		strcpy(tDst, "<");
-		return 1;
+		tokens[i].mCanSplitAtComma = comma < 0 || !isVectorAssignment(text, tSpan->mEnd, i, comma);
+		tokens[i].mCanSplitAtComparison = nextEquals != ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL && nextEquals != ASSIGNMENT_OPERATOR_LESS_OR_EQUAL;
+		tokens[i].mCanSplitAtMultiplication = nextStar != ASSIGNMENT_OPERATOR_EXPONENTIATION;
 	}
+}
 
-	isThere = isOnHighestLevel(tText, ">", &position);
-	isDifferent = strcmp(">", tText);
-	if (isThere && isDifferent && position == 0 && tText[1] != '=') {
-		strcpy(tDst, ">");
-		return 1;
+static void scanAssignmentTokens(AssignmentTextSpan* tSpan) {
+	const char* text = tSpan->mText;
+	int start = tSpan->mStart;
+	int end = tSpan->mEnd;
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int firstToken = int(tokens.size());
+	addAssignmentToken(ASSIGNMENT_OPERATOR_AMOUNT, start, 0);
+
+	int depth1 = 0;
+	int depth2 = 0;
+	int depth3 = 0;
+	int lastSpace = start - 1;
+	int wordEnd = start - 1;
+	int wordSpace = start - 1;
+	int i;
+	for (i = start; i < end; i++) {
+		updateHighestLevelDepth(text[i], &depth1, &depth2, &depth3);
+
+		AssignmentOperator op = ASSIGNMENT_OPERATOR_AMOUNT;
+		int length = 1;
+		if (!depth1 && !depth2 && !depth3) {
+			char next = i + 1 < end ? text[i + 1] : '\0';
+			switch (text[i]) {
+			case ',':
+				op = ASSIGNMENT_OPERATOR_COMMA;
+				break;
+			case '|':
+				op = next == '|' ? ASSIGNMENT_OPERATOR_OR : ASSIGNMENT_OPERATOR_BITWISE_OR;
+				break;
+			case '&':
+				op = next == '&' ? ASSIGNMENT_OPERATOR_AND : ASSIGNMENT_OPERATOR_BITWISE_AND;
+				break;
+			case ':':
+				if (next == '=') op = ASSIGNMENT_OPERATOR_VARIABLE_SET;
+				break;
+			case '!':
+				if (next == '=') op = ASSIGNMENT_OPERATOR_INEQUALITY;
+				break;
+			case '=':
+				op = ASSIGNMENT_OPERATOR_COMPARISON;
+				break;
+			case '>':
+				op = next == '=' ? ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL : ASSIGNMENT_OPERATOR_GREATER;
+				break;
+			case '<':
+				op = next == '=' ? ASSIGNMENT_OPERATOR_LESS_OR_EQUAL : ASSIGNMENT_OPERATOR_LESS;
+				break;
+			case '+':
+				if (i < end - 1) op = ASSIGNMENT_OPERATOR_ADDITION;
+				break;
+			case '-':
+				if (isSubtraction(text, start, end, i)) op = ASSIGNMENT_OPERATOR_SUBTRACTION;
+				break;
+			case '%':
+				op = ASSIGNMENT_OPERATOR_MODULO;
+				break;
+			case '*':
+				op = next == '*' ? ASSIGNMENT_OPERATOR_EXPONENTIATION : ASSIGNMENT_OPERATOR_MULTIPLICATION;
+				break;
+			case '/':
+				op = ASSIGNMENT_OPERATOR_DIVISION;
+				break;
+			default:
+				break;
+			}
+		}
+
+		if (op != ASSIGNMENT_OPERATOR_AMOUNT) {
+			int isDoubleCharacter = op == ASSIGNMENT_OPERATOR_OR || op == ASSIGNMENT_OPERATOR_AND || op == ASSIGNMENT_OPERATOR_VARIABLE_SET || op == ASSIGNMENT_OPERATOR_INEQUALITY || op == ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL || op == ASSIGNMENT_OPERATOR_LESS_OR_EQUAL || op == ASSIGNMENT_OPERATOR_EXPONENTIATION;
+			if (isDoubleCharacter) length = 2;
+			addAssignmentToken(op, i, length);
+
+			if (op == ASSIGNMENT_OPERATOR_COMMA) {
+				AssignmentToken* token = &tokens.back();
+				findCommaWord(tSpan, i, &token->mCommaWordStart, &token->mCommaWordEnd);
+				token->mIsContextFree = isCommaWordContextFree(text, token->mCommaWordStart, token->mCommaWordEnd);
+			}
+			else if (isEqualsOperator(op)) {
+				AssignmentToken* token = &tokens.back();
+				token->mIsBinaryEquals = isBinaryOperator(text, start, end, i + length - 1);
+				token->mWordEnd = length == 1 ? wordEnd : i;
+				token->mWordSpace = length == 1 ? wordSpace : lastSpace;
+			}
+		}
+
+		int j;
+		for (j = i; j < i + length; j++) {
+			if (isEmptyCharacter(text[j])) lastSpace = j;
+			else {
+				wordEnd = j;
+				wordSpace = lastSpace;
+			}
+		}
+		i += length - 1;
 	}
 
-	return 0;
+	addAssignmentToken(ASSIGNMENT_OPERATOR_AMOUNT, end, 0);
+	setAssignmentTokenSplitFlags(tSpan, firstToken);
 }
 
-static int isOperatorArgument(char* tText) {
-	char dst[10];
+static void narrowAssignmentSpanBounds(AssignmentSpanBounds* oBounds, AssignmentSpanBounds* tBounds, int tSpanToken, int tPrecedence) {
+	AssignmentToken* token = &gAssignmentParserData.mTokens[tSpanToken];
+	*oBounds = *tBounds;
+	oBounds->mPrecedence = max(tBounds->mPrecedence, tPrecedence);
+	if (token->mCanSplitAtComma) oBounds->mCommaPrecedence = max(tBounds->mCommaPrecedence, tPrecedence);
+	if (token->mCanSplitAtComparison) oBounds->mComparisonPrecedence = max(tBounds->mComparisonPrecedence, tPrecedence);
+	if (token->mCanSplitAtMultiplication) oBounds->mMultiplicationPrecedence = max(tBounds->mMultiplicationPrecedence, tPrecedence);
+	oBounds->mSpanToken = tSpanToken;
+	oBounds->mSpanPrecedence = tPrecedence;
+	oBounds->mParent = tBounds;
+}
 
-	int ret = isOperatorAndReturnType(tText, dst);
-	return ret;
+static int isCommaAssignmentSpanEnd(const char* tText, int tToken, AssignmentSpanBounds* tBounds) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	AssignmentToken* comma = &tokens[tToken];
+
+	// enclosing spans starting inside the word in front of the comma may see it as a redirection instead
+	AssignmentSpanBounds* bounds;
+	for (bounds = tBounds; bounds->mParent; bounds = bounds->mParent) {
+		AssignmentToken* span = &tokens[bounds->mSpanToken];
+		if (span->mSpanStart <= comma->mCommaWordStart) break;
+		if (span->mCanSplitAtComma && bounds->mSpanPrecedence > ASSIGNMENT_OPERATOR_COMMA && isCommaContextFreeInSpan(tText, bounds->mSpanToken, tToken)) return 1;
+	}
+
+	return comma->mIsContextFree && bounds->mCommaPrecedence > ASSIGNMENT_OPERATOR_COMMA;
 }
 
-static DreamMugenAssignment* parseMugenOperatorArgumentFromString(char* tText) {
-	char dst[10];
-	char text[200];
-	isOperatorAndReturnType(tText, dst);
+static int isAssignmentSpanEnd(const char* tText, int tToken, AssignmentSpanBounds* tBounds) {
+	AssignmentOperator op = gAssignmentParserData.mTokens[tToken].mOperator;
+	switch (op) {
+	case ASSIGNMENT_OPERATOR_AMOUNT:
+		return 1;
+	case ASSIGNMENT_OPERATOR_COMMA:
+		return isCommaAssignmentSpanEnd(tText, tToken, tBounds);
+	case ASSIGNMENT_OPERATOR_COMPARISON:
+		return op < tBounds->mComparisonPrecedence;
+	case ASSIGNMENT_OPERATOR_MULTIPLICATION:
+		return op < tBounds->mMultiplicationPrecedence;
+	default:
+		return op < tBounds->mPrecedence;
+	}
+}
 
-	sprintf(text, "%s $$ %s", dst, tText + strlen(dst));
-	return parseTwoElementMugenAssignmentFromString(text, MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT, "$$");
+static int isEmptyAssignmentSpan(AssignmentTextSpan* tExpression, int tToken, AssignmentSpanBounds* tBounds) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int start = tokens[tToken].mPosition + tokens[tToken].mLength;
+	int end = tokens[tToken + 1].mPosition;
+	sanitizeTextSpan(tExpression->mText, &start, &end);
+	return start == end && isAssignmentSpanEnd(tExpression->mText, tToken + 1, tBounds);
 }
 
-DreamMugenAssignment * parseDreamMugenAssignmentFromString(char * tText)
-{
-	sanitizeText(&tText);
+static int isOperatorArgument(AssignmentOperator tOperator) {
+	return tOperator == ASSIGNMENT_OPERATOR_COMPARISON || tOperator == ASSIGNMENT_OPERATOR_GREATER_OR_EQUAL || tOperator == ASSIGNMENT_OPERATOR_LESS_OR_EQUAL || tOperator == ASSIGNMENT_OPERATOR_LESS || tOperator == ASSIGNMENT_OPERATOR_GREATER;
+}
 
-	if (isEmpty(tText)) {
+static DreamMugenAssignment* parseMugenOperandFromTextSpan(AssignmentTextSpan* tSpan) {
+	if (tSpan->mStart == tSpan->mEnd) {
 		return parseMugenNullFromString();
 	}
-	else if (isVector(tText)) {
-		return parseMugenContextFreeVectorFromString(tText);
-	}
-	else if (isOperatorArgument(tText)) {
-		return parseMugenOperatorArgumentFromString(tText);
-	}
-	else if (isOr(tText)) {
-		return parseMugenOrFromString(tText);
+	else if (isInBraces(tSpan)) {
+		return parseDreamMugenAssignmentFromTextSpan(tSpan->mText, tSpan->mStart + 1, tSpan->mEnd - 1);
 	}
-	else if (isAnd(tText)) {
-		return parseMugenAndFromString(tText);
+	else if (isRange(tSpan)) {
+		return parseMugenRangeFromTextSpan(tSpan);
 	}
-	else if (isBitwiseOr(tText)) {
-		return parseMugenBitwiseOrFromString(tText);
+	else if (isNumericalConstant(tSpan)) {
+		return parseNumericalConstantFromTextSpan(tSpan);
 	}
-	else if (isBitwiseAnd(tText)) {
-		return parseMugenBitwiseAndFromString(tText);
+	else if (isFloatConstant(tSpan)) {
+		return parseFloatConstantFromTextSpan(tSpan);
 	}
-	else if (isVariableSet(tText)) {
-		return parseMugenVariableSetFromString(tText);
+	else if (isStringConstant(tSpan)) {
+		return parseStringConstantFromTextSpan(tSpan);
 	}
-	else if (isInequality(tText)) {
-		return parseMugenInequalityFromString(tText);
-	}
-	else if (isComparison(tText)) {
-		return parseMugenComparisonFromString(tText);
-	}
-	else if (isGreaterOrEqualThan(tText)) {
-		return parseMugenGreaterOrEqualFromString(tText);
-	}
-	else if (isLessOrEqualThan(tText)) {
-		return parseMugenLessOrEqualFromString(tText);
-	}
-	else if (isLessThan(tText)) {
-		return parseMugenLessFromString(tText);
-	}
-	else if (isGreaterThan(tText)) {
-		return parseMugenGreaterFromString(tText);
+	else {
+		return parseMugenVariableOrArrayOrRawVariableFromTextSpan(tSpan);
 	}
+}
 
-	else if (isAddition(tText)) {
-		return parseMugenAdditionFromString(tText);
-	}
-	else if (isSubtraction(tText)) {
-		return parseMugenSubtractionFromString(tText);
-	}
-	else if (isModulo(tText)) {
-		return parseMugenModuloFromString(tText);
-	}
-	else if (isMultiplication(tText)) {
-		return parseMugenMultiplicationFromString(tText);
-	}
-	else if (isDivision(tText)) {
-		return parseMugenDivisionFromString(tText);
-	}
-	else if (isExponentiation(tText)) {
-		return parseMugenExponentiationFromString(tText);
-	}
-	else if (isNegation(tText)) {
-		return parseMugenNegationFromString(tText);
-	}
-	else if (isUnaryMinus(tText)) {
-		return parseMugenUnaryMinusFromString(tText);
-	}
-	else if (isInBraces(tText)) {
-		return parseMugenAssignmentStringInBraces(tText);
-	}
-	else if (isRange(tText)) {
-		return parseMugenRangeFromString(tText);
-	}
-	else if (isNumericalConstant(tText)) {
-		return parseNumericalConstantFromString(tText);
-	}
-	else if (isFloatConstant(tText)) {
-		return parseFloatConstantFromString(tText);
-	}
-	else if (isStringConstant(tText)) {
-		return parseStringConstantFromString(tText);
+static DreamMugenAssignment* parseMugenAssignmentSpan(AssignmentTextSpan* tExpression, int* ioToken, int tStart, AssignmentSpanBounds* tBounds);
+
+static DreamMugenAssignment* parseMugenAssignmentSpanOperand(AssignmentTextSpan* tExpression, int* ioToken, int tStart, AssignmentSpanBounds* tBounds) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int spanToken = *ioToken;
+	AssignmentTextSpan span;
+	span.mText = tExpression->mText;
+	span.mStart = tStart;
+	span.mEnd = tokens[spanToken + 1].mPosition;
+	sanitizeTextSpan(span.mText, &span.mStart, &span.mEnd);
+
+	AssignmentSpanBounds bounds;
+	if (span.mStart == span.mEnd && isOperatorArgument(tokens[spanToken + 1].mOperator) && !isAssignmentSpanEnd(span.mText, spanToken + 1, tBounds)) {
+		(*ioToken)++;
+		AssignmentTextSpan operatorSpan;
+		operatorSpan.mText = span.mText;
+		operatorSpan.mStart = tokens[*ioToken].mPosition;
+		operatorSpan.mEnd = operatorSpan.mStart + tokens[*ioToken].mLength;
+		DreamMugenAssignment* a = parseMugenVariableOrArrayOrRawVariableFromTextSpan(&operatorSpan);
+		if (operatorSpan.mEnd == tExpression->mEnd) return a;
+
+		narrowAssignmentSpanBounds(&bounds, tBounds, spanToken, ASSIGNMENT_OPERATOR_OR);
+		DreamMugenAssignment* b = parseMugenAssignmentSpan(tExpression, ioToken, operatorSpan.mEnd, &bounds);
+		return makeMugenTwoElementAssignment(MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT, a, b);
 	}
-	else if (isVectorInsideAssignmentOrTargetAccess(tText)) {
-		return parseMugenVectorFromString(tText);
+	else if (span.mStart < span.mEnd && (isNegation(&span) || isUnaryMinus(&span))) {
+		DreamMugenAssignmentType type = isNegation(&span) ? MUGEN_ASSIGNMENT_TYPE_NEGATION : MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS;
+		narrowAssignmentSpanBounds(&bounds, tBounds, spanToken, ASSIGNMENT_OPERATOR_REDIRECTION);
+		DreamMugenAssignment* a = parseMugenAssignmentSpan(tExpression, ioToken, span.mStart + 1, &bounds);
+		return makeMugenOneElementAssignment(type, a);
 	}
-	else if (isMugenVariable(tText)) {
-		return parseMugenVariableFromString(tText);
+	else {
+		return parseMugenOperandFromTextSpan(&span);
 	}
-	else if (isArray(tText)) {
-		return parseArrayFromString(tText);
+}
+
+static DreamMugenAssignment* parseMugenAssignmentSpan(AssignmentTextSpan* tExpression, int* ioToken, int tStart, AssignmentSpanBounds* tBounds) {
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int spanToken = *ioToken;
+	DreamMugenAssignment* a = parseMugenAssignmentSpanOperand(tExpression, ioToken, tStart, tBounds);
+	while (!isAssignmentSpanEnd(tExpression->mText, *ioToken + 1, tBounds)) {
+		(*ioToken)++;
+		AssignmentOperator op = getAssignmentSpanOperator(tExpression->mText, spanToken, *ioToken);
+		int operatorEnd = tokens[*ioToken].mPosition + tokens[*ioToken].mLength;
+		if (operatorEnd >= tExpression->mEnd) {
+			logWarningFormat("Parsing error: Incorrect two element assignment: text %.*s with pattern %.*s", tExpression->mEnd - tExpression->mStart, tExpression->mText + tExpression->mStart, tokens[*ioToken].mLength, tExpression->mText + tokens[*ioToken].mPosition);
+		}
+
+		AssignmentSpanBounds bounds;
+		narrowAssignmentSpanBounds(&bounds, tBounds, spanToken, op);
+		if ((op == ASSIGNMENT_OPERATOR_COMMA || op == ASSIGNMENT_OPERATOR_REDIRECTION) && isEmptyAssignmentSpan(tExpression, *ioToken, &bounds)) {
+			continue;
+		}
+
+		DreamMugenAssignment* b = parseMugenAssignmentSpan(tExpression, ioToken, operatorEnd, &bounds);
+		a = makeMugenTwoElementAssignment(gAssignmentOperatorTypes[op], a, b);
 	}
-	else {
-		return parseMugenRawVariableFromString(tText);
+
+	return a;
+}
+
+static DreamMugenAssignment* parseDreamMugenAssignmentFromTextSpan(const char* tText, int tStart, int tEnd) {
+	AssignmentTextSpan expression;
+	expression.mText = tText;
+	expression.mStart = tStart;
+	expression.mEnd = tEnd;
+	sanitizeTextSpan(tText, &expression.mStart, &expression.mEnd);
+
+	if (expression.mStart == expression.mEnd) {
+		return parseMugenNullFromString();
 	}
+
+	// operators are scanned once per nesting level and every span is parsed by precedence climbing over them, nested braces parse their own text
+	vector<AssignmentToken>& tokens = gAssignmentParserData.mTokens;
+	int firstToken = int(tokens.size());
+	scanAssignmentTokens(&expression);
+
+	int token = firstToken;
+	AssignmentSpanBounds bounds;
+	bounds.mPrecedence = bounds.mCommaPrecedence = bounds.mComparisonPrecedence = bounds.mMultiplicationPrecedence = 0;
+	bounds.mSpanToken = -1;
+	bounds.mSpanPrecedence = 0;
+	bounds.mParent = NULL;
+	DreamMugenAssignment* ret = parseMugenAssignmentSpan(&expression, &token, expression.mStart, &bounds);
+	tokens.resize(firstToken);
+	return ret;
+}
+
+DreamMugenAssignment * parseDreamMugenAssignmentFromString(char * tText)
+{
+	return parseDreamMugenAssignmentFromTextSpan(tText, 0, strlen(tText));
 }
 
 DreamMugenAssignment*  parseDreamMugenAssignmentFromString(const char* tText) {
-	char evalText[1024];
-	strcpy(evalText, tText);
-	return parseDreamMugenAssignmentFromString(evalText);
+	return parseDreamMugenAssignmentFromTextSpan(tText, 0, strlen(tText));
 }
 
 uint8_t fetchDreamAssignmentFromGroupAndReturnWhetherItExists(const char* tName, MugenDefScriptGroup* tGroup, DreamMugenAssignment** tOutput) {
@@ -1160,5 +1110,6 @@ void fetchDreamAssignmentFromGroupAsElement(MugenDefScriptGroupElement * tElemen
 	char* text = getAllocatedMugenDefStringVariableForAssignmentAsElement(tElement);
 	*tOutput = parseDreamMugenAssignmentFromString(text);
 	freeMemory(text);
+	compileDreamAssignment(tOutput);
 }
 
@@ -6,6 +6,8 @@
 #include <prism/memorystack.h>
 #include <prism/stlutil.h>
 
+#include "mugencommandreader.h"
+
 typedef enum {
 	MUGEN_ASSIGNMENT_RETURN_TYPE_STRING,
 	MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER,
@@ -54,6 +56,7 @@ enum DreamMugenAssignmentType : uint8_t {
 	MUGEN_ASSIGNMENT_TYPE_BITWISE_AND,
 	MUGEN_ASSIGNMENT_TYPE_BITWISE_OR,
 	MUGEN_ASSIGNMENT_TYPE_STATIC,
+	MUGEN_ASSIGNMENT_TYPE_COMPILED,
 	MUGEN_ASSIGNMENT_TYPE_AMOUNT
 };
 
@@ -78,12 +81,49 @@ typedef struct {
 
 typedef struct {
 	uint8_t mType;
+	uint8_t mIsDefinitionConstant;
 	void* mFunc;
 } DreamMugenVariableAssignment;
 
+enum DreamMugenRawVariableComparisonType : uint8_t {
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_NONE,
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_COMMAND,
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_FUNCTION,
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_CONTACT,
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_GUARDED,
+	MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_HIT,
+};
+
+enum DreamMugenRedirectionType : uint8_t {
+	MUGEN_REDIRECTION_TYPE_NONE,
+	MUGEN_REDIRECTION_TYPE_P1,
+	MUGEN_REDIRECTION_TYPE_P2,
+	MUGEN_REDIRECTION_TYPE_TARGET,
+	MUGEN_REDIRECTION_TYPE_ENEMY,
+	MUGEN_REDIRECTION_TYPE_ENEMY_NEAR,
+	MUGEN_REDIRECTION_TYPE_ROOT,
+	MUGEN_REDIRECTION_TYPE_PARENT,
+	MUGEN_REDIRECTION_TYPE_HELPER,
+	MUGEN_REDIRECTION_TYPE_PLAYER_ID,
+};
+
+enum DreamMugenAssignmentDependency : uint8_t {
+	MUGEN_ASSIGNMENT_DEPENDENCY_NONE = 0,
+	MUGEN_ASSIGNMENT_DEPENDENCY_VARIABLES = 1 << 0,
+	MUGEN_ASSIGNMENT_DEPENDENCY_STATE = 1 << 1,
+	MUGEN_ASSIGNMENT_DEPENDENCY_COMMAND = 1 << 2,
+	MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED = 1 << 7,
+};
+
 typedef struct {
 	uint8_t mType;
+	uint8_t mComparisonType;
+	uint8_t mRedirectionType;
+	uint8_t mIsInOtherFile;
+	int mProjectileID;
 	char* mName;
+	void* mComparisonFunc;
+	void* mOrdinalFunc;
 } DreamMugenRawVariableAssignment;
 
 
@@ -116,9 +156,40 @@ typedef struct {
 	DreamMugenAssignment* mIndex;
 } DreamMugenArrayAssignment;
 
+typedef struct {
+	uint8_t mType;
+	AssignmentReturnValue mValue;
+	void* mOwner;
+	DreamMugenAssignment* mOriginal;
+} DreamMugenStaticAssignment;
+
+typedef struct {
+	uint8_t mOpcode;
+	uint8_t mTarget;
+	uint8_t mA;
+	uint8_t mB;
+	uint8_t mC;
+	union {
+		int mInteger;
+		double mFloat;
+		void* mFunc;
+		DreamMugenAssignment** mTree;
+	};
+} DreamMugenAssignmentInstruction;
+
+typedef struct {
+	uint8_t mType;
+	uint8_t mRegisterAmount;
+	uint8_t mResultRegister;
+	uint16_t mInstructionAmount;
+	DreamMugenAssignmentInstruction* mInstructions;
+	DreamMugenAssignment* mTree;
+} DreamMugenCompiledAssignment;
+
 void setupDreamAssignmentReader(MemoryStack* tMemoryStack);
 void shutdownDreamAssignmentReader();
 void setDreamAssignmentCommandLookupID(int tID);
+void setDreamAssignmentCommandLookupCommands(DreamMugenCommands* tCommands);
 void resetDreamAssignmentCommandLookupID();
 
 DreamMugenAssignment* makeDreamTrueMugenAssignment();
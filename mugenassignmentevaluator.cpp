@@ -3,8 +3,10 @@
 #include "mugenassignmentevaluator.h"
 
 #include <assert.h>
+#include <stddef.h>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
@@ -55,7 +57,16 @@ typedef struct {
 	AssignmentReturnType mType;
 } AssignmentReturnBottom;
 
+typedef struct {
+	AssignmentReturnType mType;
+	union {
+		int mInteger;
+		double mFloat;
+	};
+} AssignmentRegister;
+
 #define REGULAR_STACK_SIZE 500
+#define REGISTER_STACK_SIZE 1024
 
 static struct {
 	int mStackSize;
@@ -63,11 +74,19 @@ static struct {
 	std::list<AssignmentReturnValue> mEmergencyStack;
 	int mFreePointer;
 
+	AssignmentRegister mRegisters[REGISTER_STACK_SIZE];
+	int mRegisterPointer;
+
+	DreamPlayer* mFoldingPlayer;
+	int mIsFoldingDeferred;
 } gAssignmentEvaluator;
 
 static void initEvaluationStack() {
 	gAssignmentEvaluator.mStackSize = REGULAR_STACK_SIZE;
 	gAssignmentEvaluator.mEmergencyStack.clear();
+	gAssignmentEvaluator.mRegisterPointer = 0;
+	gAssignmentEvaluator.mFoldingPlayer = NULL;
+	gAssignmentEvaluator.mIsFoldingDeferred = 0;
 }
 
 static AssignmentReturnValue* getFreeAssignmentReturnValue() {
@@ -90,6 +109,10 @@ static struct {
 	map<string, ArrayFunction> mArrays;
 	map<string, ComparisonFunction> mComparisons;
 	map<string, OrdinalFunction> mOrdinals;
+
+	vector<void*> mFunctionTable;
+	map<void*, uint32_t> mFunctionIDs;
+	uint32_t mFunctionTableStamp;
 } gVariableHandler;
 
 std::map<string, AssignmentReturnValue*(*)(DreamPlayer*)>& getActiveMugenAssignmentVariableMap() {
@@ -573,28 +596,26 @@ static AssignmentReturnValue* enemyNearFunction(DreamMugenAssignment** tIndexAss
 static AssignmentReturnValue* playerIDFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic);
 
 static DreamPlayer* getPlayerFromFirstVectorPartOrNullIfNonexistant(DreamMugenAssignment** a, DreamPlayer* tPlayer, int* tIsStatic) {
-	static const size_t PLAYER_TEXT_BUFFER_SIZE = 100;
-	char text[PLAYER_TEXT_BUFFER_SIZE];
+	uint8_t redirectionType;
 	int id = -1;
 	if ((*a)->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE)
 	{
 		auto rawVar = (DreamMugenRawVariableAssignment*)(*a);
-		if (strlen(text) >= PLAYER_TEXT_BUFFER_SIZE) return NULL;
-		strcpy(text, rawVar->mName);
+		redirectionType = rawVar->mRedirectionType;
 	}
 	else if ((*a)->mType == MUGEN_ASSIGNMENT_TYPE_ARRAY) {
 		auto arrayVar = (DreamMugenArrayAssignment*)(*a);
 		if (arrayVar->mFunc == numTargetArrayFunction) {
-			strcpy(text, "target");
+			redirectionType = MUGEN_REDIRECTION_TYPE_TARGET;
 		}
 		else if (arrayVar->mFunc == helperFunction) {
-			strcpy(text, "helper");
+			redirectionType = MUGEN_REDIRECTION_TYPE_HELPER;
 		}
 		else if (arrayVar->mFunc == enemyNearFunction) {
-			strcpy(text, "enemynear");
+			redirectionType = MUGEN_REDIRECTION_TYPE_ENEMY_NEAR;
 		}
 		else if (arrayVar->mFunc == playerIDFunction) {
-			strcpy(text, "playerid");
+			redirectionType = MUGEN_REDIRECTION_TYPE_PLAYER_ID;
 		}
 		else {
 			return NULL;
@@ -607,42 +628,34 @@ static DreamPlayer* getPlayerFromFirstVectorPartOrNullIfNonexistant(DreamMugenAs
 		return NULL;
 	}
 
-	if (!strcmp("p1", text)) {
+	DreamPlayer* ret;
+	switch (redirectionType) {
+	case MUGEN_REDIRECTION_TYPE_P1:
 		return getRootPlayer(0);
-	}
-	else if (!strcmp("p2", text)) {
+	case MUGEN_REDIRECTION_TYPE_P2:
 		return getRootPlayer(1);
-	}
-	else if (!strcmp("target", text)) {
+	case MUGEN_REDIRECTION_TYPE_TARGET:
 		return getPlayerOtherPlayer(tPlayer); // TODO: proper targeting + with id (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/376)
-	}
-	else if (!strcmp("enemy", text)) {
+	case MUGEN_REDIRECTION_TYPE_ENEMY:
+	case MUGEN_REDIRECTION_TYPE_ENEMY_NEAR:
 		return getPlayerOtherPlayer(tPlayer);
-	}
-	else if (!strcmp("enemynear", text)) {
-		return getPlayerOtherPlayer(tPlayer);
-	}
-	else if (!strcmp("root", text)) {
+	case MUGEN_REDIRECTION_TYPE_ROOT:
 		return getPlayerRoot(tPlayer);
-	}
-	else if (!strcmp("parent", text)) {
+	case MUGEN_REDIRECTION_TYPE_PARENT:
 		return getPlayerParent(tPlayer);
-	}
-	else if (!strcmp("helper", text)) {
-		DreamPlayer* ret = getPlayerHelperOrNullIfNonexistant(tPlayer, id);
+	case MUGEN_REDIRECTION_TYPE_HELPER:
+		ret = getPlayerHelperOrNullIfNonexistant(tPlayer, id);
 		if (!ret) {
 			logWarningFormat("Unable to find helper with id %d. Returning NULL.", id);
 		}
 		return ret;
-	}
-	else if (!strcmp("playerid", text)) {
-		DreamPlayer* ret = getPlayerByIDOrNullIfNonexistant(tPlayer, id);
+	case MUGEN_REDIRECTION_TYPE_PLAYER_ID:
+		ret = getPlayerByIDOrNullIfNonexistant(tPlayer, id);
 		if (!ret) {
 			logWarningFormat("Unable to find helper with id %d. Returning NULL.", id);
 		}
 		return ret;
-	}
-	else {
+	default:
 		return NULL;
 	}
 }
@@ -914,16 +927,7 @@ static AssignmentReturnValue* evaluateProjNumberAssignment(AssignmentReturnValue
 	return makeBooleanAssignmentReturn(ret == compareValue);
 }
 
-static int getProjectileIDFromAssignmentName(char* tName, const char* tBaseName) {
-	char* idOffset = tName += strlen(tBaseName);
-	if (*idOffset == '\0') return 0;
-
-	return atoi(idOffset);
-}
-
-static AssignmentReturnValue* evaluateProjAssignment(char* tName, const char* tBaseName, AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int(*tTimeFunc)(DreamPlayer*, int), int* tIsStatic) {
-	int projID = getProjectileIDFromAssignmentName(tName, tBaseName);
-
+static AssignmentReturnValue* evaluateProjAssignment(int projID, AssignmentReturnValue* tCommand, DreamPlayer* tPlayer, int(*tTimeFunc)(DreamPlayer*, int), int* tIsStatic) {
 	if (tCommand->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR) {
 		return evaluateProjVectorAssignment(tCommand, tPlayer, projID, tTimeFunc, tIsStatic);
 	}
@@ -932,15 +936,11 @@ static AssignmentReturnValue* evaluateProjAssignment(char* tName, const char* tB
 	}
 }
 
-static int isProjAssignment(char* tName, const char* tBaseName) {
-	return !strncmp(tName, tBaseName, strlen(tBaseName));
-
-}
-
 static int tryEvaluateVariableComparison(DreamMugenRawVariableAssignment* tVariableAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic) {
 
 	int hasReturn = 0;
-	if(!strcmp("command", tVariableAssignment->mName)) {
+	switch (tVariableAssignment->mComparisonType) {
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_COMMAND:
 		hasReturn = 1;
 		if (b->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER) {
 			*oRet = makeBooleanAssignmentReturn(isPlayerCommandActiveWithLookup(tPlayer, convertAssignmentReturnToNumber(b)));
@@ -952,23 +952,25 @@ static int tryEvaluateVariableComparison(DreamMugenRawVariableAssignment* tVaria
 			*oRet = makeBooleanAssignmentReturn(0);
 		}
 		*tIsStatic = 0;
-	}
-	else if (stl_string_map_contains_array(gVariableHandler.mComparisons, tVariableAssignment->mName)) {
-		ComparisonFunction func = gVariableHandler.mComparisons[tVariableAssignment->mName];
+		break;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_FUNCTION:
 		hasReturn = 1;
-		*oRet = func(b, tPlayer, tIsStatic);
-	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projcontact")) {
+		*oRet = ((ComparisonFunction)tVariableAssignment->mComparisonFunc)(b, tPlayer, tIsStatic);
+		break;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_CONTACT:
 		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projcontact", b, tPlayer, getPlayerProjectileTimeSinceContact, tIsStatic);
-	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projguarded")) {
+		*oRet = evaluateProjAssignment(tVariableAssignment->mProjectileID, b, tPlayer, getPlayerProjectileTimeSinceContact, tIsStatic);
+		break;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_GUARDED:
 		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projguarded", b, tPlayer, getPlayerProjectileTimeSinceGuarded, tIsStatic);
-	}
-	else if (isProjAssignment(tVariableAssignment->mName, "projhit")) {
+		*oRet = evaluateProjAssignment(tVariableAssignment->mProjectileID, b, tPlayer, getPlayerProjectileTimeSinceGuarded, tIsStatic);
+		break;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_HIT:
 		hasReturn = 1;
-		*oRet = evaluateProjAssignment(tVariableAssignment->mName, "projhit", b, tPlayer, getPlayerProjectileTimeSinceHit, tIsStatic);
+		*oRet = evaluateProjAssignment(tVariableAssignment->mProjectileID, b, tPlayer, getPlayerProjectileTimeSinceHit, tIsStatic);
+		break;
+	default:
+		break;
 	}
 
 	return hasReturn;
@@ -1039,7 +1041,9 @@ static AssignmentReturnValue* evaluateComparisonAssignment(DreamMugenAssignment*
 				return makeBottomAssignmentReturn(); 
 			}
 			AssignmentReturnValue* b = evaluateAssignmentDependency(&comparisonAssignment->b, tPlayer, tIsStatic);
-			return evaluateComparisonAssignmentInternal(&vectorAssignment->b, b, target, tIsStatic);
+			AssignmentReturnValue* ret = evaluateComparisonAssignmentInternal(&vectorAssignment->b, b, target, tIsStatic);
+			*tIsStatic = 0;
+			return ret;
 		}
 	}
 
@@ -1056,8 +1060,8 @@ static AssignmentReturnValue* evaluateInequalityAssignment(DreamMugenAssignment*
 
 static int tryEvaluateVariableOrdinalInternal(DreamMugenRawVariableAssignment* tVariableAssignment, AssignmentReturnValue** oRet, AssignmentReturnValue* b, DreamPlayer* tPlayer, int* tIsStatic, int(*tCompareFunction)(int, int)) {
 
-	if (stl_string_map_contains_array(gVariableHandler.mOrdinals, tVariableAssignment->mName)) {
-		OrdinalFunction func = gVariableHandler.mOrdinals[tVariableAssignment->mName];
+	if (tVariableAssignment->mOrdinalFunc) {
+		OrdinalFunction func = (OrdinalFunction)tVariableAssignment->mOrdinalFunc;
 		*oRet = func(b, tPlayer, tIsStatic, tCompareFunction);
 		return 1;
 	}
@@ -1442,12 +1446,14 @@ static AssignmentReturnValue* evaluatePlayerVectorAssignment(DreamMugenAssignmen
 		logWarning("Unable to evaluate player vector assignment with NULL. Defaulting to bottom.");
 		return makeBottomAssignmentReturn(); 
 	}
-	if (tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_ARRAY) {
+	if (tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_ARRAY && tVectorAssignment->b->mType != MUGEN_ASSIGNMENT_TYPE_STATIC) {
 		logWarningFormat("Invalid player vector assignment type %d. Defaulting to bottom.", tVectorAssignment->b->mType);
 		return makeBottomAssignmentReturn();
 	}
 
-	return evaluateAssignmentDependency(&tVectorAssignment->b, target, tIsStatic);
+	AssignmentReturnValue* ret = evaluateAssignmentDependency(&tVectorAssignment->b, target, tIsStatic);
+	*tIsStatic = 0;
+	return ret;
 }
 
 static AssignmentReturnValue* evaluateVectorAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
@@ -1979,11 +1985,56 @@ static void setupVariableAssignments() {
 
 static void setupArrayAssignments();
 
+static void addAssignmentFunctionTableEntry(const string& tName, void* tFunc) {
+	// the same function can be registered under several names, it keeps the ID of its first one
+	if (!stl_map_contains(gVariableHandler.mFunctionIDs, tFunc)) {
+		gVariableHandler.mFunctionIDs[tFunc] = (uint32_t)gVariableHandler.mFunctionTable.size();
+		gVariableHandler.mFunctionTable.push_back(tFunc);
+	}
+
+	size_t i;
+	for (i = 0; i <= tName.size(); i++) {
+		gVariableHandler.mFunctionTableStamp = (gVariableHandler.mFunctionTableStamp ^ (uint8_t)tName.c_str()[i]) * 16777619u;
+	}
+}
+
+static void setupAssignmentFunctionTable() {
+	gVariableHandler.mFunctionTable.clear();
+	gVariableHandler.mFunctionIDs.clear();
+	gVariableHandler.mFunctionTableStamp = 2166136261u;
+
+	for (auto& variable : gVariableHandler.mVariables) addAssignmentFunctionTableEntry(variable.first, (void*)variable.second);
+	for (auto& array : gVariableHandler.mArrays) addAssignmentFunctionTableEntry(array.first, (void*)array.second);
+	for (auto& comparison : gVariableHandler.mComparisons) addAssignmentFunctionTableEntry(comparison.first, (void*)comparison.second);
+	for (auto& ordinal : gVariableHandler.mOrdinals) addAssignmentFunctionTableEntry(ordinal.first, (void*)ordinal.second);
+}
+
 void setupDreamAssignmentEvaluator() {
 	initEvaluationStack();
 	setupVariableAssignments();
 	setupArrayAssignments();
 	setupComparisons();
+	setupAssignmentFunctionTable();
+}
+
+int getDreamAssignmentFunctionID(void* tFunc, uint32_t* oID) {
+	auto it = gVariableHandler.mFunctionIDs.find(tFunc);
+	if (it == gVariableHandler.mFunctionIDs.end()) return 0;
+	*oID = it->second;
+	return 1;
+}
+
+void* getDreamAssignmentFunctionFromID(uint32_t tID) {
+	if (tID >= gVariableHandler.mFunctionTable.size()) return NULL;
+	return gVariableHandler.mFunctionTable[tID];
+}
+
+uint32_t getDreamAssignmentFunctionAmount() {
+	return (uint32_t)gVariableHandler.mFunctionTable.size();
+}
+
+uint32_t getDreamAssignmentFunctionTableStamp() {
+	return gVariableHandler.mFunctionTableStamp;
 }
 
 static int isIsInOtherFileVariable(char* tName) {
@@ -2008,7 +2059,7 @@ static AssignmentReturnValue* makeExternalFileAssignmentReturn(char tIdentifierC
 
 static AssignmentReturnValue* evaluateVariableAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
 	DreamMugenVariableAssignment* variable = (DreamMugenVariableAssignment*)*tAssignment;
-	*tIsStatic = 0;
+	*tIsStatic = variable->mIsDefinitionConstant;
 	AssignmentReturnValue*(*func)(DreamPlayer*) = (AssignmentReturnValue*(*)(DreamPlayer*))variable->mFunc;
 
 	return func(tPlayer);
@@ -2018,13 +2069,61 @@ static AssignmentReturnValue* evaluateRawVariableAssignment(DreamMugenAssignment
 	DreamMugenRawVariableAssignment* variable = (DreamMugenRawVariableAssignment*)*tAssignment;
 	*tIsStatic = 0;
 
-	if (isIsInOtherFileVariable(variable->mName)) {
+	if (variable->mIsInOtherFile) {
 		return makeExternalFileAssignmentReturn(variable->mName[0], variable->mName + 1);
 	}
 
 	return makeStringAssignmentReturn(variable->mName);
 }
 
+static uint8_t getRawVariableRedirectionType(const char* tName) {
+	if (!strcmp("p1", tName)) return MUGEN_REDIRECTION_TYPE_P1;
+	else if (!strcmp("p2", tName)) return MUGEN_REDIRECTION_TYPE_P2;
+	else if (!strcmp("target", tName)) return MUGEN_REDIRECTION_TYPE_TARGET;
+	else if (!strcmp("enemy", tName)) return MUGEN_REDIRECTION_TYPE_ENEMY;
+	else if (!strcmp("enemynear", tName)) return MUGEN_REDIRECTION_TYPE_ENEMY_NEAR;
+	else if (!strcmp("root", tName)) return MUGEN_REDIRECTION_TYPE_ROOT;
+	else if (!strcmp("parent", tName)) return MUGEN_REDIRECTION_TYPE_PARENT;
+	else if (!strcmp("helper", tName)) return MUGEN_REDIRECTION_TYPE_HELPER;
+	else if (!strcmp("playerid", tName)) return MUGEN_REDIRECTION_TYPE_PLAYER_ID;
+	else return MUGEN_REDIRECTION_TYPE_NONE;
+}
+
+static int tryBindProjectileRawVariable(DreamMugenRawVariableAssignment* tAssignment, const char* tBaseName, uint8_t tComparisonType) {
+	size_t length = strlen(tBaseName);
+	if (strncmp(tAssignment->mName, tBaseName, length)) return 0;
+
+	tAssignment->mComparisonType = tComparisonType;
+	tAssignment->mProjectileID = atoi(tAssignment->mName + length);
+	return 1;
+}
+
+void bindDreamRawVariableAssignment(DreamMugenRawVariableAssignment* tAssignment) {
+	tAssignment->mComparisonType = MUGEN_RAW_VARIABLE_COMPARISON_TYPE_NONE;
+	tAssignment->mProjectileID = 0;
+	tAssignment->mComparisonFunc = NULL;
+	tAssignment->mOrdinalFunc = NULL;
+	tAssignment->mRedirectionType = getRawVariableRedirectionType(tAssignment->mName);
+	tAssignment->mIsInOtherFile = (uint8_t)isIsInOtherFileVariable(tAssignment->mName);
+
+	if (!strcmp("command", tAssignment->mName)) {
+		tAssignment->mComparisonType = MUGEN_RAW_VARIABLE_COMPARISON_TYPE_COMMAND;
+	}
+	else if (stl_string_map_contains_array(gVariableHandler.mComparisons, tAssignment->mName)) {
+		tAssignment->mComparisonType = MUGEN_RAW_VARIABLE_COMPARISON_TYPE_FUNCTION;
+		tAssignment->mComparisonFunc = (void*)gVariableHandler.mComparisons[tAssignment->mName];
+	}
+	else if (!tryBindProjectileRawVariable(tAssignment, "projcontact", MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_CONTACT)) {
+		if (!tryBindProjectileRawVariable(tAssignment, "projguarded", MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_GUARDED)) {
+			tryBindProjectileRawVariable(tAssignment, "projhit", MUGEN_RAW_VARIABLE_COMPARISON_TYPE_PROJECTILE_HIT);
+		}
+	}
+
+	if (stl_string_map_contains_array(gVariableHandler.mOrdinals, tAssignment->mName)) {
+		tAssignment->mOrdinalFunc = (void*)gVariableHandler.mOrdinals[tAssignment->mName];
+	}
+}
+
 static AssignmentReturnValue* evaluateVarArrayAssignment(AssignmentReturnValue* tIndex, DreamPlayer* tPlayer, int* tIsStatic) {
 	int id = convertAssignmentReturnToNumber(tIndex);
 	int val = getPlayerVariable(tPlayer, id);
@@ -2508,30 +2607,35 @@ static AssignmentReturnValue* evaluateNegationAssignment(DreamMugenAssignment**
 	return makeBooleanAssignmentReturn(!val);
 }
 
-typedef struct {
-	uint8_t mType;
-	AssignmentReturnValue* mValue;
-} DreamMugenStaticAssignment;
-
 int gPruneAmount;
 
-static DreamMugenAssignment* makeStaticDreamMugenAssignment(AssignmentReturnValue* tValue) {
+static DreamMugenAssignment* makeStaticDreamMugenAssignment(DreamMugenAssignment* tOriginal, AssignmentReturnValue* tValue, DreamPlayer* tPlayer) {
 	DreamMugenStaticAssignment* e = (DreamMugenStaticAssignment*)allocMemory(sizeof(DreamMugenStaticAssignment));
 	e->mType = MUGEN_ASSIGNMENT_TYPE_STATIC;
-	e->mValue = tValue;
+	e->mValue = *tValue;
+	e->mOwner = tPlayer ? tPlayer->mHeader : NULL;
+	e->mOriginal = tOriginal;
 
 	gPruneAmount++;
 	return (DreamMugenAssignment*)e;
 }
 
 static AssignmentReturnValue* evaluateStaticAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
-	(void)tPlayer;
-	(void)tIsStatic;
-
 	DreamMugenStaticAssignment* stat = (DreamMugenStaticAssignment*)*tAssignment;
-	return stat->mValue;
+	if (tPlayer && tPlayer->mHeader == stat->mOwner) {
+		AssignmentReturnValue* ret = getFreeAssignmentReturnValue();
+		*ret = stat->mValue;
+		return ret;
+	}
+
+	// states of another definition (e.g. custom states) look up their own constants
+	AssignmentReturnValue* ret = evaluateAssignmentDependency(&stat->mOriginal, tPlayer, tIsStatic);
+	*tIsStatic = 0;
+	return ret;
 }
 
+static AssignmentReturnValue* evaluateCompiledAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic);
+
 typedef AssignmentReturnValue*(AssignmentEvaluationFunction)(DreamMugenAssignment**, DreamPlayer*, int*);
 
 static void* gEvaluationFunctions[] = {
@@ -2566,41 +2670,14 @@ static void* gEvaluationFunctions[] = {
 	(void*)evaluateBitwiseAndAssignment,
 	(void*)evaluateBitwiseOrAssignment,
 	(void*)evaluateStaticAssignment,
+	(void*)evaluateCompiledAssignment,
 };
 
 
-static void setAssignmentStatic(DreamMugenAssignment** tAssignment, AssignmentReturnValue* tValue) {
-	switch ((*tAssignment)->mType) {
-	case MUGEN_ASSIGNMENT_TYPE_AND:
-	case MUGEN_ASSIGNMENT_TYPE_OR:
-	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
-	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
-	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
-	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
-	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
-	case MUGEN_ASSIGNMENT_TYPE_RANGE:
-	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
-	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
-	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
-	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
-	case MUGEN_ASSIGNMENT_TYPE_LESS:
-	case MUGEN_ASSIGNMENT_TYPE_GREATER:
-	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
-	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
-	case MUGEN_ASSIGNMENT_TYPE_MODULO:
-	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
-	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
-	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
-	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
-	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
-	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
-	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
-	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
-		if(0) *tAssignment = makeStaticDreamMugenAssignment(tValue); // TODO: reset (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/388)
-		break;
-	default:
-		break;
-	}
+static int isPlayerRedirectionArrayAssignment(DreamMugenAssignment* tAssignment) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_ARRAY) return 0;
+	DreamMugenArrayAssignment* arrayAssignment = (DreamMugenArrayAssignment*)tAssignment;
+	return arrayAssignment->mFunc == numTargetArrayFunction || arrayAssignment->mFunc == helperFunction || arrayAssignment->mFunc == enemyNearFunction || arrayAssignment->mFunc == playerIDFunction;
 }
 
 static AssignmentReturnValue* evaluateAssignmentInternal(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic) {
@@ -2618,13 +2695,7 @@ static AssignmentReturnValue* evaluateAssignmentInternal(DreamMugenAssignment**
 	}
 
 	AssignmentEvaluationFunction* func = (AssignmentEvaluationFunction*)gEvaluationFunctions[(*tAssignment)->mType];
-	AssignmentReturnValue* ret = func(tAssignment, tPlayer, oIsStatic);
-
-	if (*oIsStatic) {
-		setAssignmentStatic(tAssignment, ret);
-	}
-
-	return ret;
+	return func(tAssignment, tPlayer, oIsStatic);
 }
 
 static AssignmentReturnValue* evaluateAssignmentStart(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* oIsStatic) {
@@ -2636,181 +2707,1194 @@ static AssignmentReturnValue* evaluateAssignmentStart(DreamMugenAssignment** tAs
 	return ret;
 }
 
-static AssignmentReturnValue* timeStoryFunction(DreamPlayer* tPlayer) { return makeNumberAssignmentReturn(getDolmexicaStoryTimeInState((StoryInstance*)tPlayer)); }
-
-static void setupStoryVariableAssignments() {
-	gVariableHandler.mVariables.clear();
-	gVariableHandler.mVariables["time"] = timeStoryFunction;
-	gVariableHandler.mVariables["random"] = randomFunction;
-	gVariableHandler.mVariables["platform"] = platformFunction;
-}
+typedef enum : uint8_t {
+	ASSIGNMENT_OPCODE_LOAD_NUMBER,
+	ASSIGNMENT_OPCODE_LOAD_FLOAT,
+	ASSIGNMENT_OPCODE_LOAD_BOOLEAN,
+	ASSIGNMENT_OPCODE_CALL_VARIABLE,
+	ASSIGNMENT_OPCODE_LOAD_VAR,
+	ASSIGNMENT_OPCODE_LOAD_FVAR,
+	ASSIGNMENT_OPCODE_LOAD_SYSVAR,
+	ASSIGNMENT_OPCODE_LOAD_SYSFVAR,
+	ASSIGNMENT_OPCODE_LOAD_GLOBALVAR,
+	ASSIGNMENT_OPCODE_LOAD_GLOBALFVAR,
+	ASSIGNMENT_OPCODE_EVALUATE_TREE,
+	ASSIGNMENT_OPCODE_EVALUATE_TREE_AS_BOOLEAN,
+	ASSIGNMENT_OPCODE_TO_BOOLEAN,
+	ASSIGNMENT_OPCODE_NOT,
+	ASSIGNMENT_OPCODE_NEGATE,
+	ASSIGNMENT_OPCODE_ADD,
+	ASSIGNMENT_OPCODE_SUBTRACT,
+	ASSIGNMENT_OPCODE_MULTIPLY,
+	ASSIGNMENT_OPCODE_DIVIDE,
+	ASSIGNMENT_OPCODE_MODULO,
+	ASSIGNMENT_OPCODE_EXPONENTIATE,
+	ASSIGNMENT_OPCODE_BITWISE_AND,
+	ASSIGNMENT_OPCODE_BITWISE_OR,
+	ASSIGNMENT_OPCODE_EQUAL,
+	ASSIGNMENT_OPCODE_NOT_EQUAL,
+	ASSIGNMENT_OPCODE_LESS,
+	ASSIGNMENT_OPCODE_LESS_OR_EQUAL,
+	ASSIGNMENT_OPCODE_GREATER,
+	ASSIGNMENT_OPCODE_GREATER_OR_EQUAL,
+	ASSIGNMENT_OPCODE_IN_RANGE,
+	ASSIGNMENT_OPCODE_JUMP_IF_FALSE,
+	ASSIGNMENT_OPCODE_JUMP_IF_TRUE,
+} AssignmentOpcode;
+
+typedef enum {
+	ASSIGNMENT_COMPILE_CONTEXT_EXACT,
+	ASSIGNMENT_COMPILE_CONTEXT_NUMERIC,
+	ASSIGNMENT_COMPILE_CONTEXT_BOOLEAN,
+} AssignmentCompileContext;
+
+#define MAXIMUM_COMPILED_REGISTER_AMOUNT 255
 
-//static AssignmentReturnValue* movementDownFrictionThresholdFunction(DreamPlayer* tPlayer) { return makeFloatAssignmentReturn(getPlayerLyingDownFrictionThreshold(tPlayer)); }
+typedef struct {
+	vector<DreamMugenAssignmentInstruction> mInstructions;
+	int mRegisterAmount;
+} AssignmentCompiler;
 
-static AssignmentReturnValue* evaluateAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryAnimationTimeLeft(tInstance, id));
-}
+int gCompiledAssignmentAmount;
 
-static AssignmentReturnValue* evaluateRootAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryAnimationTimeLeft(getDolmexicaStoryRootInstance(), id));
+static int isStringVariableFunction(void* tFunc) {
+	return tFunc == (void*)authorNameFunction || tFunc == (void*)nameFunction || tFunc == (void*)p1NameFunction || tFunc == (void*)p2NameFunction || tFunc == (void*)p3NameFunction || tFunc == (void*)p4NameFunction || tFunc == (void*)platformFunction;
 }
 
-static AssignmentReturnValue* evaluateAnimPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryAnimationPositionX(tInstance, id));
+static int isRawVariableOrNegatedRawVariable(DreamMugenAssignment* tAssignment) {
+	if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) return 1;
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_NEGATION) return 0;
+	DreamMugenDependOnOneAssignment* neg = (DreamMugenDependOnOneAssignment*)tAssignment;
+	return neg->a->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE;
 }
 
-static AssignmentReturnValue* evaluateCharPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryCharacterPositionX(tInstance, id));
+static int isPossiblePlayerAccessAssignment(DreamMugenAssignment* tAssignment) {
+	return tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE || isPlayerRedirectionArrayAssignment(tAssignment);
 }
 
-static AssignmentReturnValue* evaluateRootCharPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryCharacterPositionX(getDolmexicaStoryRootInstance(), id));
+static int addCompiledRegister(AssignmentCompiler* tCompiler) {
+	return tCompiler->mRegisterAmount++;
 }
 
-static AssignmentReturnValue* evaluateRootTextPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryTextBasePositionX(getDolmexicaStoryRootInstance(), id));
+static int addCompiledInstruction(AssignmentCompiler* tCompiler, AssignmentOpcode tOpcode, int tTarget, int tA = 0, int tB = 0, int tC = 0) {
+	DreamMugenAssignmentInstruction e;
+	e.mOpcode = tOpcode;
+	e.mTarget = (uint8_t)tTarget;
+	e.mA = (uint8_t)tA;
+	e.mB = (uint8_t)tB;
+	e.mC = (uint8_t)tC;
+	e.mFloat = 0;
+	tCompiler->mInstructions.push_back(e);
+	return int(tCompiler->mInstructions.size()) - 1;
 }
 
-static AssignmentReturnValue* evaluateRootTextPosYStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryTextBasePositionY(getDolmexicaStoryRootInstance(), id));
-}
+static int compileAssignmentNode(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentCompileContext tContext);
 
-static AssignmentReturnValue* evaluateRootTextVisibleStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeBooleanAssignmentReturn(isDolmexicaStoryTextVisible(getDolmexicaStoryRootInstance(), id));
-}
+static int compileBinaryOperation(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentOpcode tOpcode, AssignmentCompileContext tContextA, AssignmentCompileContext tContextB, int tIsEvaluatingBFirst) {
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	int a, b;
+	if (tIsEvaluatingBFirst) {
+		if ((b = compileAssignmentNode(tCompiler, &e->b, tContextB)) < 0) return -1;
+		if ((a = compileAssignmentNode(tCompiler, &e->a, tContextA)) < 0) return -1;
+	}
+	else {
+		if ((a = compileAssignmentNode(tCompiler, &e->a, tContextA)) < 0) return -1;
+		if ((b = compileAssignmentNode(tCompiler, &e->b, tContextB)) < 0) return -1;
+	}
 
-static AssignmentReturnValue* evaluateCharAnimStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterAnimation(tInstance, id));
+	int target = addCompiledRegister(tCompiler);
+	addCompiledInstruction(tCompiler, tOpcode, target, a, b);
+	return target;
 }
 
-static AssignmentReturnValue* evaluateRootCharAnimStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterAnimation(getDolmexicaStoryRootInstance(), id));
-}
+static int compileShortCircuitOperation(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentOpcode tJumpOpcode) {
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	int target = addCompiledRegister(tCompiler);
 
-static AssignmentReturnValue* evaluateCharAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	string val;
-	convertAssignmentReturnToString(val, tIndex);
-	int id = getDolmexicaStoryIDFromString(val.data(), tInstance);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterTimeLeft(tInstance, id));
-}
+	int a = compileAssignmentNode(tCompiler, &e->a, ASSIGNMENT_COMPILE_CONTEXT_BOOLEAN);
+	if (a < 0) return -1;
+	addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_TO_BOOLEAN, target, a);
+	int jump = addCompiledInstruction(tCompiler, tJumpOpcode, target, target);
 
-static AssignmentReturnValue* evaluateRootCharAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	string val;
-	convertAssignmentReturnToString(val, tIndex);
-	int id = getDolmexicaStoryIDFromString(val.data(), tInstance);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterTimeLeft(getDolmexicaStoryRootInstance(), id));
+	int b = compileAssignmentNode(tCompiler, &e->b, ASSIGNMENT_COMPILE_CONTEXT_BOOLEAN);
+	if (b < 0) return -1;
+	addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_TO_BOOLEAN, target, b);
+	tCompiler->mInstructions[jump].mInteger = int(tCompiler->mInstructions.size());
+	return target;
 }
 
-static AssignmentReturnValue* evaluateSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(tInstance, id).data());
-}
+static int compileUnaryOperation(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentOpcode tOpcode, AssignmentCompileContext tContext) {
+	DreamMugenDependOnOneAssignment* e = (DreamMugenDependOnOneAssignment*)*tAssignment;
+	int a = compileAssignmentNode(tCompiler, &e->a, tContext);
+	if (a < 0) return -1;
 
-static AssignmentReturnValue* evaluateFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(tInstance, id));
+	int target = addCompiledRegister(tCompiler);
+	addCompiledInstruction(tCompiler, tOpcode, target, a);
+	return target;
 }
 
-static AssignmentReturnValue* evaluateVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(tInstance, id));
-}
+static int compileArrayAssignment(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment) {
+	DreamMugenArrayAssignment* e = (DreamMugenArrayAssignment*)*tAssignment;
 
-static AssignmentReturnValue* evaluateGlobalVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getGlobalVariable(id));
-}
+	AssignmentOpcode opcode;
+	if (e->mFunc == varFunction) opcode = ASSIGNMENT_OPCODE_LOAD_VAR;
+	else if (e->mFunc == fVarFunction) opcode = ASSIGNMENT_OPCODE_LOAD_FVAR;
+	else if (e->mFunc == sysVarFunction) opcode = ASSIGNMENT_OPCODE_LOAD_SYSVAR;
+	else if (e->mFunc == sysFVarFunction) opcode = ASSIGNMENT_OPCODE_LOAD_SYSFVAR;
+	else if (e->mFunc == globalVarFunction) opcode = ASSIGNMENT_OPCODE_LOAD_GLOBALVAR;
+	else if (e->mFunc == globalFVarFunction) opcode = ASSIGNMENT_OPCODE_LOAD_GLOBALFVAR;
+	else return -1;
 
-static AssignmentReturnValue* evaluateGlobalFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getGlobalFloatVariable(id));
-}
+	int index = compileAssignmentNode(tCompiler, &e->mIndex, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC);
+	if (index < 0) return -1;
 
-static AssignmentReturnValue* evaluateGlobalSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeStringAssignmentReturn(getGlobalStringVariable(id).data());
+	int target = addCompiledRegister(tCompiler);
+	addCompiledInstruction(tCompiler, opcode, target, index);
+	return target;
 }
 
-static AssignmentReturnValue* evaluateRootSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(getDolmexicaStoryRootInstance(), id).data());
-}
+static int compileRangeComparison(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, int tIsNegated) {
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	DreamMugenRangeAssignment* range = (DreamMugenRangeAssignment*)e->b;
+	if (range->a->mType != MUGEN_ASSIGNMENT_TYPE_VECTOR) return -1;
+	DreamMugenDependOnTwoAssignment* bounds = (DreamMugenDependOnTwoAssignment*)range->a;
+	if (isPossiblePlayerAccessAssignment(bounds->a)) return -1;
 
-static AssignmentReturnValue* evaluateRootFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(getDolmexicaStoryRootInstance(), id));
-}
+	int lower = compileAssignmentNode(tCompiler, &bounds->a, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC);
+	if (lower < 0) return -1;
+	int upper = compileAssignmentNode(tCompiler, &bounds->b, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC);
+	if (upper < 0) return -1;
+	int value = compileAssignmentNode(tCompiler, &e->a, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC);
+	if (value < 0) return -1;
 
-static AssignmentReturnValue* evaluateRootVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(getDolmexicaStoryRootInstance(), id));
+	int target = addCompiledRegister(tCompiler);
+	int instruction = addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_IN_RANGE, target, value, lower, upper);
+	tCompiler->mInstructions[instruction].mInteger = (range->mExcludeLeft ? 1 : 0) | (range->mExcludeRight ? 2 : 0);
+	if (tIsNegated) {
+		addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_NOT, target, target);
+	}
+	return target;
 }
 
-static AssignmentReturnValue* evaluateParentSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(getDolmexicaStoryInstanceParent(tInstance), id).data());
-}
+static int compileComparison(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, int tIsNegated) {
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	if (e->a->mType == MUGEN_ASSIGNMENT_TYPE_VECTOR || isRawVariableOrNegatedRawVariable(e->a)) return -1;
 
-static AssignmentReturnValue* evaluateParentFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(getDolmexicaStoryInstanceParent(tInstance), id));
-}
+	if (e->b->mType == MUGEN_ASSIGNMENT_TYPE_RANGE) {
+		return compileRangeComparison(tCompiler, tAssignment, tIsNegated);
+	}
 
-static AssignmentReturnValue* evaluateParentVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(getDolmexicaStoryInstanceParent(tInstance), id));
+	return compileBinaryOperation(tCompiler, tAssignment, tIsNegated ? ASSIGNMENT_OPCODE_NOT_EQUAL : ASSIGNMENT_OPCODE_EQUAL, ASSIGNMENT_COMPILE_CONTEXT_EXACT, ASSIGNMENT_COMPILE_CONTEXT_EXACT, 1);
 }
 
-static AssignmentReturnValue* evaluateNumHelperStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
-	int id = convertAssignmentReturnToNumber(tIndex);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(getDolmexicaStoryGetHelperAmount(id));
-}
+static int compileOrdinalComparison(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentOpcode tOpcode) {
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)*tAssignment;
+	if (e->a->mType == MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE) return -1;
 
-static AssignmentReturnValue* evaluateNameIDStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
-	string text;
-	convertAssignmentReturnToString(text, tIndex);
-	int id = getDolmexicaStoryIDFromString(text.data(), tInstance);
-	*tIsStatic = 0;
-	return makeNumberAssignmentReturn(id);
+	return compileBinaryOperation(tCompiler, tAssignment, tOpcode, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 1);
 }
 
-static AssignmentReturnValue* animTimeStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateAnimTimeStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), (StoryInstance*)tPlayer, tIsStatic); }
-static AssignmentReturnValue* rootAnimTimeStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateRootAnimTimeStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), tIsStatic); }
+static int compileAssignmentNodeNative(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment) {
+	int target;
+	switch ((*tAssignment)->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+		target = addCompiledRegister(tCompiler);
+		tCompiler->mInstructions[addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_LOAD_NUMBER, target)].mInteger = ((DreamMugenNumberAssignment*)*tAssignment)->mValue;
+		return target;
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		target = addCompiledRegister(tCompiler);
+		tCompiler->mInstructions[addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_LOAD_FLOAT, target)].mFloat = ((DreamMugenFloatAssignment*)*tAssignment)->mValue;
+		return target;
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+		target = addCompiledRegister(tCompiler);
+		tCompiler->mInstructions[addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_LOAD_BOOLEAN, target)].mInteger = ((DreamMugenFixedBooleanAssignment*)*tAssignment)->mValue;
+		return target;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		if (isStringVariableFunction(((DreamMugenVariableAssignment*)*tAssignment)->mFunc)) return -1;
+		target = addCompiledRegister(tCompiler);
+		tCompiler->mInstructions[addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_CALL_VARIABLE, target)].mFunc = ((DreamMugenVariableAssignment*)*tAssignment)->mFunc;
+		return target;
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return compileArrayAssignment(tCompiler, tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		target = addCompiledRegister(tCompiler);
+		tCompiler->mInstructions[addCompiledInstruction(tCompiler, ASSIGNMENT_OPCODE_EVALUATE_TREE, target)].mTree = tAssignment;
+		return target;
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+		return compileShortCircuitOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_JUMP_IF_FALSE);
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+		return compileShortCircuitOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_JUMP_IF_TRUE);
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		return compileUnaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_NOT, ASSIGNMENT_COMPILE_CONTEXT_BOOLEAN);
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		return compileUnaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_NEGATE, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC);
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_ADD, ASSIGNMENT_COMPILE_CONTEXT_EXACT, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_SUBTRACT, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_MULTIPLY, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_DIVIDE, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_MODULO, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_EXPONENTIATE, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_BITWISE_AND, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		return compileBinaryOperation(tCompiler, tAssignment, ASSIGNMENT_OPCODE_BITWISE_OR, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, ASSIGNMENT_COMPILE_CONTEXT_NUMERIC, 0);
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+		return compileComparison(tCompiler, tAssignment, 0);
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+		return compileComparison(tCompiler, tAssignment, 1);
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+		return compileOrdinalComparison(tCompiler, tAssignment, ASSIGNMENT_OPCODE_LESS);
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+		return compileOrdinalComparison(tCompiler, tAssignment, ASSIGNMENT_OPCODE_LESS_OR_EQUAL);
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+		return compileOrdinalComparison(tCompiler, tAssignment, ASSIGNMENT_OPCODE_GREATER);
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+		return compileOrdinalComparison(tCompiler, tAssignment, ASSIGNMENT_OPCODE_GREATER_OR_EQUAL);
+	default:
+		return -1;
+	}
+}
+
+static int compileAssignmentNode(AssignmentCompiler* tCompiler, DreamMugenAssignment** tAssignment, AssignmentCompileContext tContext) {
+	size_t previousInstructionAmount = tCompiler->mInstructions.size();
+	int previousRegisterAmount = tCompiler->mRegisterAmount;
+
+	int target = compileAssignmentNodeNative(tCompiler, tAssignment);
+	if (target >= 0 || tContext == ASSIGNMENT_COMPILE_CONTEXT_EXACT) return target;
+
+	tCompiler->mInstructions.resize(previousInstructionAmount);
+	tCompiler->mRegisterAmount = previousRegisterAmount;
+	target = addCompiledRegister(tCompiler);
+	AssignmentOpcode opcode = tContext == ASSIGNMENT_COMPILE_CONTEXT_BOOLEAN ? ASSIGNMENT_OPCODE_EVALUATE_TREE_AS_BOOLEAN : ASSIGNMENT_OPCODE_EVALUATE_TREE;
+	tCompiler->mInstructions[addCompiledInstruction(tCompiler, opcode, target)].mTree = tAssignment;
+	return target;
+}
+
+static int isLiteralAssignment(DreamMugenAssignment* tAssignment) {
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return ((DreamMugenVariableAssignment*)tAssignment)->mFunc == (void*)eFunction || ((DreamMugenVariableAssignment*)tAssignment)->mFunc == (void*)piFunction;
+	default:
+		return 0;
+	}
+}
+
+static int isPureArrayFunction(void* tFunc) {
+	return tFunc == (void*)absFunction || tFunc == (void*)expFunction || tFunc == (void*)lnFunction || tFunc == (void*)logFunction || tFunc == (void*)cosFunction || tFunc == (void*)acosFunction || tFunc == (void*)sinFunction || tFunc == (void*)asinFunction || tFunc == (void*)tanFunction || tFunc == (void*)atanFunction || tFunc == (void*)floorFunction || tFunc == (void*)ceilFunction;
+}
+
+static int isLiteralArrayIndex(DreamMugenAssignment* tAssignment) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_VECTOR) return isLiteralAssignment(tAssignment);
+	DreamMugenDependOnTwoAssignment* e = (DreamMugenDependOnTwoAssignment*)tAssignment;
+	return isLiteralAssignment(e->a) && isLiteralAssignment(e->b);
+}
+
+static int isFoldableAssignment(DreamMugenAssignment* tAssignment) {
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		return isLiteralAssignment(((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		return isLiteralAssignment(((DreamMugenDependOnTwoAssignment*)tAssignment)->a) && isLiteralAssignment(((DreamMugenDependOnTwoAssignment*)tAssignment)->b);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return isPureArrayFunction(((DreamMugenArrayAssignment*)tAssignment)->mFunc) && isLiteralArrayIndex(((DreamMugenArrayAssignment*)tAssignment)->mIndex);
+	default:
+		return 0;
+	}
+}
+
+static void foldConstantAssignment(DreamMugenAssignment** tAssignment) {
+	switch ((*tAssignment)->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		foldConstantAssignment(&((DreamMugenDependOnOneAssignment*)*tAssignment)->a);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		foldConstantAssignment(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->a);
+		foldConstantAssignment(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->b);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		foldConstantAssignment(&((DreamMugenRangeAssignment*)*tAssignment)->a);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		foldConstantAssignment(&((DreamMugenArrayAssignment*)*tAssignment)->mIndex);
+		break;
+	default:
+		break;
+	}
+
+	if (!isFoldableAssignment(*tAssignment)) return;
+
+	int previousFreePointer = gAssignmentEvaluator.mFreePointer;
+	int isStatic;
+	AssignmentReturnValue* value = evaluateAssignmentInternal(tAssignment, NULL, &isStatic);
+
+	// the previous subtree is left in place since it may live on the assignment memory stack
+	DreamMugenAssignment* folded;
+	switch (value->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+		folded = makeDreamNumberMugenAssignment(convertAssignmentReturnToNumber(value));
+		break;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		folded = makeDreamFloatMugenAssignment(convertAssignmentReturnToFloat(value));
+		break;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		folded = convertAssignmentReturnToBool(value) ? makeDreamTrueMugenAssignment() : makeDreamFalseMugenAssignment();
+		break;
+	default:
+		folded = NULL;
+		break;
+	}
+	gAssignmentEvaluator.mFreePointer = previousFreePointer;
+
+	if (folded) {
+		*tAssignment = folded;
+		gPruneAmount++;
+	}
+}
+
+static int isDefinitionConstantAssignmentInternal(DreamMugenAssignment* tAssignment, int* oHasConstant) {
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		if (!((DreamMugenVariableAssignment*)tAssignment)->mIsDefinitionConstant) return 0;
+		*oHasConstant = 1;
+		return 1;
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		return isDefinitionConstantAssignmentInternal(((DreamMugenDependOnOneAssignment*)tAssignment)->a, oHasConstant);
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+		return isDefinitionConstantAssignmentInternal(((DreamMugenDependOnTwoAssignment*)tAssignment)->a, oHasConstant) && isDefinitionConstantAssignmentInternal(((DreamMugenDependOnTwoAssignment*)tAssignment)->b, oHasConstant);
+	default:
+		return 0;
+	}
+}
+
+static int isDefinitionConstantExpression(DreamMugenAssignment* tAssignment) {
+	if (tAssignment->mType == MUGEN_ASSIGNMENT_TYPE_VARIABLE) return 0;
+	int hasConstant = 0;
+	return isDefinitionConstantAssignmentInternal(tAssignment, &hasConstant) && hasConstant;
+}
+
+static void foldDefinitionConstantAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer) {
+	if (isDefinitionConstantExpression(*tAssignment)) {
+		int previousFreePointer = gAssignmentEvaluator.mFreePointer;
+		if (!tPlayer) {
+			// without a player the value is filled in by bindDreamStaticMugenAssignment once the cached image is loaded
+			*tAssignment = makeStaticDreamMugenAssignment(*tAssignment, makeBottomAssignmentReturn(), NULL);
+		}
+		else {
+			int isStatic;
+			AssignmentReturnValue* value = evaluateAssignmentInternal(tAssignment, tPlayer, &isStatic);
+			if (value->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER || value->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT) {
+				*tAssignment = makeStaticDreamMugenAssignment(*tAssignment, value, tPlayer);
+			}
+		}
+		gAssignmentEvaluator.mFreePointer = previousFreePointer;
+		return;
+	}
+
+	switch ((*tAssignment)->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		foldDefinitionConstantAssignment(&((DreamMugenDependOnOneAssignment*)*tAssignment)->a, tPlayer);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		foldDefinitionConstantAssignment(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->a, tPlayer);
+		foldDefinitionConstantAssignment(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->b, tPlayer);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		foldDefinitionConstantAssignment(&((DreamMugenRangeAssignment*)*tAssignment)->a, tPlayer);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		foldDefinitionConstantAssignment(&((DreamMugenArrayAssignment*)*tAssignment)->mIndex, tPlayer);
+		break;
+	default:
+		break;
+	}
+}
+
+void setDreamAssignmentFoldingPlayer(DreamPlayer* tPlayer) {
+	gAssignmentEvaluator.mFoldingPlayer = tPlayer;
+}
+
+void setDreamAssignmentFoldingDeferred() {
+	gAssignmentEvaluator.mIsFoldingDeferred = 1;
+}
+
+void resetDreamAssignmentFoldingPlayer() {
+	gAssignmentEvaluator.mFoldingPlayer = NULL;
+	gAssignmentEvaluator.mIsFoldingDeferred = 0;
+}
+
+void bindDreamStaticMugenAssignment(DreamMugenAssignment* tAssignment, DreamPlayer* tPlayer) {
+	if (tAssignment->mType != MUGEN_ASSIGNMENT_TYPE_STATIC) return;
+	DreamMugenStaticAssignment* e = (DreamMugenStaticAssignment*)tAssignment;
+
+	int previousFreePointer = gAssignmentEvaluator.mFreePointer;
+	int isStatic;
+	AssignmentReturnValue* value = evaluateAssignmentInternal(&e->mOriginal, tPlayer, &isStatic);
+	if (value->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER || value->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT) {
+		e->mValue = *value;
+		e->mOwner = tPlayer->mHeader;
+	}
+	gAssignmentEvaluator.mFreePointer = previousFreePointer;
+}
+
+void compileDreamAssignment(DreamMugenAssignment** tAssignment) {
+	if (!(*tAssignment) || (*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_COMPILED) return;
+
+	foldConstantAssignment(tAssignment);
+	if (gAssignmentEvaluator.mFoldingPlayer || gAssignmentEvaluator.mIsFoldingDeferred) {
+		foldDefinitionConstantAssignment(tAssignment, gAssignmentEvaluator.mFoldingPlayer);
+	}
+	if ((*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_STATIC) return;
+
+	AssignmentCompiler compiler;
+	compiler.mRegisterAmount = 0;
+	int result = compileAssignmentNodeNative(&compiler, tAssignment);
+	if (result < 0 || compiler.mRegisterAmount > MAXIMUM_COMPILED_REGISTER_AMOUNT || compiler.mInstructions.size() > UINT16_MAX) return;
+
+	DreamMugenCompiledAssignment* e = (DreamMugenCompiledAssignment*)allocMemory(sizeof(DreamMugenCompiledAssignment));
+	e->mType = MUGEN_ASSIGNMENT_TYPE_COMPILED;
+	e->mRegisterAmount = (uint8_t)compiler.mRegisterAmount;
+	e->mResultRegister = (uint8_t)result;
+	e->mInstructionAmount = (uint16_t)compiler.mInstructions.size();
+	e->mInstructions = (DreamMugenAssignmentInstruction*)allocMemory(sizeof(DreamMugenAssignmentInstruction) * e->mInstructionAmount);
+	memcpy(e->mInstructions, compiler.mInstructions.data(), sizeof(DreamMugenAssignmentInstruction) * e->mInstructionAmount);
+	e->mTree = *tAssignment;
+
+	*tAssignment = (DreamMugenAssignment*)e;
+	gCompiledAssignmentAmount++;
+}
+
+static uint32_t getAssignmentCacheImageSize(uint8_t tType) {
+	switch (tType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+		return sizeof(DreamMugenFixedBooleanAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		return sizeof(DreamMugenDependOnOneAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+		return sizeof(DreamMugenDependOnTwoAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return sizeof(DreamMugenArrayAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		return sizeof(DreamMugenRangeAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return sizeof(DreamMugenVariableAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		return sizeof(DreamMugenRawVariableAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+		return sizeof(DreamMugenNumberAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+		return sizeof(DreamMugenFloatAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		return sizeof(DreamMugenStringAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		return sizeof(DreamMugenStaticAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_COMPILED:
+		return sizeof(DreamMugenCompiledAssignment);
+	default:
+		return 0;
+	}
+}
+
+uint32_t getDreamAssignmentCacheLayoutStamp() {
+	uint32_t ret = addDreamCharacterCacheImageLayoutStamp(2166136261u, DREAM_CHARACTER_CACHE_BUILD_ID);
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)MUGEN_ASSIGNMENT_TYPE_AMOUNT);
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenAssignmentInstruction));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenCompiledAssignment));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenStaticAssignment));
+	return ret;
+}
+
+static void writeCompiledAssignmentInstructionsCacheImage(DreamCharacterCacheImage* tImage, uint32_t tOffset, DreamMugenCompiledAssignment* tAssignment) {
+	setDreamCharacterCacheImagePointer(tImage, tOffset + offsetof(DreamMugenCompiledAssignment, mInstructions), tAssignment->mInstructions);
+	if (!tAssignment->mInstructions) return;
+
+	int isNew;
+	const uint32_t instructionOffset = addDreamCharacterCacheImageBlock(tImage, tAssignment->mInstructions, sizeof(DreamMugenAssignmentInstruction) * tAssignment->mInstructionAmount, &isNew);
+	if (!isNew) return;
+
+	int i;
+	for (i = 0; i < tAssignment->mInstructionAmount; i++) {
+		DreamMugenAssignmentInstruction* instruction = &tAssignment->mInstructions[i];
+		const uint32_t slot = instructionOffset + i * sizeof(DreamMugenAssignmentInstruction) + offsetof(DreamMugenAssignmentInstruction, mFunc);
+		if (instruction->mOpcode == ASSIGNMENT_OPCODE_CALL_VARIABLE) {
+			setDreamCharacterCacheImageFunction(tImage, slot, instruction->mFunc);
+		}
+		else if (instruction->mOpcode == ASSIGNMENT_OPCODE_EVALUATE_TREE || instruction->mOpcode == ASSIGNMENT_OPCODE_EVALUATE_TREE_AS_BOOLEAN) {
+			// points at a child slot inside the tree, which is written below
+			setDreamCharacterCacheImagePointer(tImage, slot, instruction->mTree);
+		}
+	}
+}
+
+void writeDreamMugenAssignmentCacheImage(DreamCharacterCacheImage* tImage, uint32_t tSlot, DreamMugenAssignment* tAssignment) {
+	setDreamCharacterCacheImagePointer(tImage, tSlot, tAssignment);
+	if (!tAssignment) return;
+
+	const uint32_t size = getAssignmentCacheImageSize(tAssignment->mType);
+	if (!size) {
+		failDreamCharacterCacheImage(tImage, "unrecognized assignment type");
+		return;
+	}
+
+	int isNew;
+	const uint32_t offset = addDreamCharacterCacheImageBlock(tImage, tAssignment, size, &isNew);
+	if (!isNew) return;
+
+	switch (tAssignment->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenDependOnOneAssignment, a), ((DreamMugenDependOnOneAssignment*)tAssignment)->a);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_SET_VARIABLE:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenDependOnTwoAssignment, a), ((DreamMugenDependOnTwoAssignment*)tAssignment)->a);
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenDependOnTwoAssignment, b), ((DreamMugenDependOnTwoAssignment*)tAssignment)->b);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		setDreamCharacterCacheImageFunction(tImage, offset + offsetof(DreamMugenArrayAssignment, mFunc), ((DreamMugenArrayAssignment*)tAssignment)->mFunc);
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenArrayAssignment, mIndex), ((DreamMugenArrayAssignment*)tAssignment)->mIndex);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenRangeAssignment, a), ((DreamMugenRangeAssignment*)tAssignment)->a);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		setDreamCharacterCacheImageFunction(tImage, offset + offsetof(DreamMugenVariableAssignment, mFunc), ((DreamMugenVariableAssignment*)tAssignment)->mFunc);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		setDreamCharacterCacheImageString(tImage, offset + offsetof(DreamMugenRawVariableAssignment, mName), ((DreamMugenRawVariableAssignment*)tAssignment)->mName);
+		setDreamCharacterCacheImageFunction(tImage, offset + offsetof(DreamMugenRawVariableAssignment, mComparisonFunc), ((DreamMugenRawVariableAssignment*)tAssignment)->mComparisonFunc);
+		setDreamCharacterCacheImageFunction(tImage, offset + offsetof(DreamMugenRawVariableAssignment, mOrdinalFunc), ((DreamMugenRawVariableAssignment*)tAssignment)->mOrdinalFunc);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		setDreamCharacterCacheImageString(tImage, offset + offsetof(DreamMugenStringAssignment, mValue), ((DreamMugenStringAssignment*)tAssignment)->mValue);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		// the folded value belongs to the player that was loaded, it gets rebound by bindDreamStaticMugenAssignment
+		clearDreamCharacterCacheImageBytes(tImage, offset + offsetof(DreamMugenStaticAssignment, mValue), sizeof(AssignmentReturnValue));
+		setDreamCharacterCacheImagePointer(tImage, offset + offsetof(DreamMugenStaticAssignment, mOwner), NULL);
+		addDreamCharacterCacheImageStaticAssignment(tImage, offset);
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenStaticAssignment, mOriginal), ((DreamMugenStaticAssignment*)tAssignment)->mOriginal);
+		break;
+	case MUGEN_ASSIGNMENT_TYPE_COMPILED:
+		writeCompiledAssignmentInstructionsCacheImage(tImage, offset, (DreamMugenCompiledAssignment*)tAssignment);
+		writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DreamMugenCompiledAssignment, mTree), ((DreamMugenCompiledAssignment*)tAssignment)->mTree);
+		break;
+	default:
+		break;
+	}
+}
+
+static uint8_t getVariableAssignmentDependencies(DreamMugenVariableAssignment* tAssignment) {
+	if (tAssignment->mIsDefinitionConstant) return MUGEN_ASSIGNMENT_DEPENDENCY_NONE;
+
+	if (tAssignment->mFunc == (void*)stateNoFunction || tAssignment->mFunc == (void*)prevStateNoFunction || tAssignment->mFunc == (void*)ctrlFunction) {
+		return MUGEN_ASSIGNMENT_DEPENDENCY_STATE;
+	}
+	else {
+		return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+	}
+}
+
+static uint8_t getRawVariableAssignmentDependencies(DreamMugenRawVariableAssignment* tAssignment) {
+	if (tAssignment->mRedirectionType != MUGEN_REDIRECTION_TYPE_NONE || tAssignment->mOrdinalFunc) return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+
+	switch (tAssignment->mComparisonType) {
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_NONE:
+		return MUGEN_ASSIGNMENT_DEPENDENCY_NONE;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_COMMAND:
+		return MUGEN_ASSIGNMENT_DEPENDENCY_COMMAND;
+	case MUGEN_RAW_VARIABLE_COMPARISON_TYPE_FUNCTION:
+		if (tAssignment->mComparisonFunc == (void*)stateTypeComparisonFunction || tAssignment->mComparisonFunc == (void*)moveTypeComparisonFunction) {
+			return MUGEN_ASSIGNMENT_DEPENDENCY_STATE;
+		}
+		return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+	default:
+		return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+	}
+}
+
+static uint8_t getArrayAssignmentDependencies(DreamMugenArrayAssignment* tAssignment) {
+	if (tAssignment->mFunc != (void*)varFunction && tAssignment->mFunc != (void*)fVarFunction && tAssignment->mFunc != (void*)sysVarFunction && tAssignment->mFunc != (void*)sysFVarFunction) {
+		return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+	}
+
+	return MUGEN_ASSIGNMENT_DEPENDENCY_VARIABLES | getDreamAssignmentDependencies(&tAssignment->mIndex);
+}
+
+uint8_t getDreamAssignmentDependencies(DreamMugenAssignment** tAssignment) {
+	if (!(*tAssignment)) return MUGEN_ASSIGNMENT_DEPENDENCY_NONE;
+
+	switch ((*tAssignment)->mType) {
+	case MUGEN_ASSIGNMENT_TYPE_FIXED_BOOLEAN:
+	case MUGEN_ASSIGNMENT_TYPE_NULL:
+	case MUGEN_ASSIGNMENT_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_TYPE_FLOAT:
+	case MUGEN_ASSIGNMENT_TYPE_STRING:
+		return MUGEN_ASSIGNMENT_DEPENDENCY_NONE;
+	case MUGEN_ASSIGNMENT_TYPE_VARIABLE:
+		return getVariableAssignmentDependencies((DreamMugenVariableAssignment*)*tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_RAW_VARIABLE:
+		return getRawVariableAssignmentDependencies((DreamMugenRawVariableAssignment*)*tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_ARRAY:
+		return getArrayAssignmentDependencies((DreamMugenArrayAssignment*)*tAssignment);
+	case MUGEN_ASSIGNMENT_TYPE_RANGE:
+		return getDreamAssignmentDependencies(&((DreamMugenRangeAssignment*)*tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_NEGATION:
+	case MUGEN_ASSIGNMENT_TYPE_UNARY_MINUS:
+		return getDreamAssignmentDependencies(&((DreamMugenDependOnOneAssignment*)*tAssignment)->a);
+	case MUGEN_ASSIGNMENT_TYPE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_OR:
+	case MUGEN_ASSIGNMENT_TYPE_COMPARISON:
+	case MUGEN_ASSIGNMENT_TYPE_INEQUALITY:
+	case MUGEN_ASSIGNMENT_TYPE_LESS_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER_OR_EQUAL:
+	case MUGEN_ASSIGNMENT_TYPE_VECTOR:
+	case MUGEN_ASSIGNMENT_TYPE_LESS:
+	case MUGEN_ASSIGNMENT_TYPE_GREATER:
+	case MUGEN_ASSIGNMENT_TYPE_ADDITION:
+	case MUGEN_ASSIGNMENT_TYPE_MULTIPLICATION:
+	case MUGEN_ASSIGNMENT_TYPE_MODULO:
+	case MUGEN_ASSIGNMENT_TYPE_SUBTRACTION:
+	case MUGEN_ASSIGNMENT_TYPE_DIVISION:
+	case MUGEN_ASSIGNMENT_TYPE_EXPONENTIATION:
+	case MUGEN_ASSIGNMENT_TYPE_OPERATOR_ARGUMENT:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_AND:
+	case MUGEN_ASSIGNMENT_TYPE_BITWISE_OR:
+		return getDreamAssignmentDependencies(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->a) | getDreamAssignmentDependencies(&((DreamMugenDependOnTwoAssignment*)*tAssignment)->b);
+	case MUGEN_ASSIGNMENT_TYPE_STATIC:
+		return getDreamAssignmentDependencies(&((DreamMugenStaticAssignment*)*tAssignment)->mOriginal);
+	case MUGEN_ASSIGNMENT_TYPE_COMPILED:
+		return getDreamAssignmentDependencies(&((DreamMugenCompiledAssignment*)*tAssignment)->mTree);
+	default:
+		return MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED;
+	}
+}
+
+static int convertAssignmentRegisterToNumber(AssignmentRegister* tRegister) {
+	switch (tRegister->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		return (int)tRegister->mFloat;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		return tRegister->mInteger;
+	default:
+		return 0;
+	}
+}
+
+static double convertAssignmentRegisterToFloat(AssignmentRegister* tRegister) {
+	switch (tRegister->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		return tRegister->mFloat;
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		return tRegister->mInteger;
+	default:
+		return 0;
+	}
+}
+
+static int convertAssignmentRegisterToBool(AssignmentRegister* tRegister) {
+	return convertAssignmentRegisterToNumber(tRegister);
+}
+
+static AssignmentReturnValue* convertAssignmentRegisterToAssignmentReturn(AssignmentRegister* tRegister) {
+	switch (tRegister->mType) {
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT:
+		return makeFloatAssignmentReturn(tRegister->mFloat);
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER:
+		return makeNumberAssignmentReturn(tRegister->mInteger);
+	case MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN:
+		return makeBooleanAssignmentReturn(tRegister->mInteger);
+	default:
+		return makeBottomAssignmentReturn();
+	}
+}
+
+static void setAssignmentRegisterNumber(AssignmentRegister* oRegister, int tValue) {
+	oRegister->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_NUMBER;
+	oRegister->mInteger = tValue;
+}
+
+static void setAssignmentRegisterFloat(AssignmentRegister* oRegister, double tValue) {
+	oRegister->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+	oRegister->mFloat = tValue;
+}
+
+static void setAssignmentRegisterBoolean(AssignmentRegister* oRegister, int tValue) {
+	oRegister->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN;
+	oRegister->mInteger = tValue;
+}
+
+static void setAssignmentRegisterBottom(AssignmentRegister* oRegister) {
+	oRegister->mType = MUGEN_ASSIGNMENT_RETURN_TYPE_BOTTOM;
+	oRegister->mInteger = 0;
+}
+
+static void setAssignmentRegisterFromAssignmentReturn(AssignmentRegister* oRegister, AssignmentReturnValue* tValue) {
+	if (isFloatReturn(tValue)) {
+		setAssignmentRegisterFloat(oRegister, convertAssignmentReturnToFloat(tValue));
+	}
+	else if (tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_BOOLEAN) {
+		setAssignmentRegisterBoolean(oRegister, convertAssignmentReturnToBool(tValue));
+	}
+	else {
+		setAssignmentRegisterNumber(oRegister, convertAssignmentReturnToNumber(tValue));
+	}
+}
+
+static int isEitherAssignmentRegisterFloat(AssignmentRegister* a, AssignmentRegister* b) {
+	return a->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT || b->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT;
+}
+
+static void executeCompiledAssignment(DreamMugenCompiledAssignment* tCompiled, DreamPlayer* tPlayer, AssignmentRegister* oResult) {
+	if (gAssignmentEvaluator.mRegisterPointer + tCompiled->mRegisterAmount > REGISTER_STACK_SIZE) {
+		int isStatic;
+		setAssignmentRegisterFromAssignmentReturn(oResult, evaluateAssignmentInternal(&tCompiled->mTree, tPlayer, &isStatic));
+		return;
+	}
+
+	AssignmentRegister* r = &gAssignmentEvaluator.mRegisters[gAssignmentEvaluator.mRegisterPointer];
+	gAssignmentEvaluator.mRegisterPointer += tCompiled->mRegisterAmount;
+
+	int isStatic;
+	int pc = 0;
+	while (pc < tCompiled->mInstructionAmount) {
+		DreamMugenAssignmentInstruction* e = &tCompiled->mInstructions[pc++];
+		AssignmentRegister* target = &r[e->mTarget];
+		AssignmentRegister* a = &r[e->mA];
+		AssignmentRegister* b = &r[e->mB];
+		switch (e->mOpcode) {
+		case ASSIGNMENT_OPCODE_LOAD_NUMBER:
+			setAssignmentRegisterNumber(target, e->mInteger);
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_FLOAT:
+			setAssignmentRegisterFloat(target, e->mFloat);
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_BOOLEAN:
+			setAssignmentRegisterBoolean(target, e->mInteger);
+			break;
+		case ASSIGNMENT_OPCODE_CALL_VARIABLE:
+			setAssignmentRegisterFromAssignmentReturn(target, ((VariableFunction)e->mFunc)(tPlayer));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_VAR:
+			setAssignmentRegisterNumber(target, getPlayerVariable(tPlayer, convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_FVAR:
+			setAssignmentRegisterFloat(target, getPlayerFloatVariable(tPlayer, convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_SYSVAR:
+			setAssignmentRegisterNumber(target, getPlayerSystemVariable(tPlayer, convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_SYSFVAR:
+			setAssignmentRegisterFloat(target, getPlayerSystemFloatVariable(tPlayer, convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_GLOBALVAR:
+			setAssignmentRegisterNumber(target, getGlobalVariable(convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_LOAD_GLOBALFVAR:
+			setAssignmentRegisterFloat(target, getGlobalFloatVariable(convertAssignmentRegisterToNumber(a)));
+			break;
+		case ASSIGNMENT_OPCODE_EVALUATE_TREE:
+			setAssignmentRegisterFromAssignmentReturn(target, evaluateAssignmentInternal(e->mTree, tPlayer, &isStatic));
+			break;
+		case ASSIGNMENT_OPCODE_EVALUATE_TREE_AS_BOOLEAN:
+			setAssignmentRegisterBoolean(target, convertAssignmentReturnToBool(evaluateAssignmentInternal(e->mTree, tPlayer, &isStatic)));
+			break;
+		case ASSIGNMENT_OPCODE_TO_BOOLEAN:
+			setAssignmentRegisterBoolean(target, convertAssignmentRegisterToBool(a));
+			break;
+		case ASSIGNMENT_OPCODE_NOT:
+			setAssignmentRegisterBoolean(target, !convertAssignmentRegisterToBool(a));
+			break;
+		case ASSIGNMENT_OPCODE_NEGATE:
+			if (a->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_FLOAT) setAssignmentRegisterFloat(target, -a->mFloat);
+			else setAssignmentRegisterNumber(target, -convertAssignmentRegisterToNumber(a));
+			break;
+		case ASSIGNMENT_OPCODE_ADD:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterFloat(target, convertAssignmentRegisterToFloat(a) + convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) + convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_SUBTRACT:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterFloat(target, convertAssignmentRegisterToFloat(a) - convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) - convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_MULTIPLY:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterFloat(target, convertAssignmentRegisterToFloat(a) * convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) * convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_DIVIDE:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterFloat(target, convertAssignmentRegisterToFloat(a) / convertAssignmentRegisterToFloat(b));
+			else if (!convertAssignmentRegisterToNumber(b)) setAssignmentRegisterBottom(target);
+			else setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) / convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_MODULO:
+			if (isEitherAssignmentRegisterFloat(a, b) || !convertAssignmentRegisterToNumber(b)) setAssignmentRegisterBottom(target);
+			else setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) % convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_EXPONENTIATE:
+			if (isEitherAssignmentRegisterFloat(a, b) || convertAssignmentRegisterToNumber(b) < 0) setAssignmentRegisterFloat(target, pow(convertAssignmentRegisterToFloat(a), convertAssignmentRegisterToFloat(b)));
+			else setAssignmentRegisterNumber(target, powI(convertAssignmentRegisterToNumber(a), convertAssignmentRegisterToNumber(b)));
+			break;
+		case ASSIGNMENT_OPCODE_BITWISE_AND:
+			setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) & convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_BITWISE_OR:
+			setAssignmentRegisterNumber(target, convertAssignmentRegisterToNumber(a) | convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_EQUAL:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) == convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) == convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_NOT_EQUAL:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) != convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) != convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_LESS:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) < convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) < convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_LESS_OR_EQUAL:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) <= convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) <= convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_GREATER:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) > convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) > convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_GREATER_OR_EQUAL:
+			if (isEitherAssignmentRegisterFloat(a, b)) setAssignmentRegisterBoolean(target, convertAssignmentRegisterToFloat(a) >= convertAssignmentRegisterToFloat(b));
+			else setAssignmentRegisterBoolean(target, convertAssignmentRegisterToNumber(a) >= convertAssignmentRegisterToNumber(b));
+			break;
+		case ASSIGNMENT_OPCODE_IN_RANGE:
+		{
+			int value = convertAssignmentRegisterToNumber(a);
+			int lower = convertAssignmentRegisterToNumber(b) + ((e->mInteger & 1) ? 1 : 0);
+			int upper = convertAssignmentRegisterToNumber(&r[e->mC]) - ((e->mInteger & 2) ? 1 : 0);
+			setAssignmentRegisterBoolean(target, value >= lower && value <= upper);
+			break;
+		}
+		case ASSIGNMENT_OPCODE_JUMP_IF_FALSE:
+			if (!convertAssignmentRegisterToBool(a)) pc = e->mInteger;
+			break;
+		case ASSIGNMENT_OPCODE_JUMP_IF_TRUE:
+			if (convertAssignmentRegisterToBool(a)) pc = e->mInteger;
+			break;
+		default:
+			logWarningFormat("Unrecognized assignment opcode %d. Defaulting to bottom.", e->mOpcode);
+			setAssignmentRegisterBottom(target);
+			break;
+		}
+	}
+
+	*oResult = r[tCompiled->mResultRegister];
+	gAssignmentEvaluator.mRegisterPointer -= tCompiled->mRegisterAmount;
+}
+
+static AssignmentReturnValue* evaluateCompiledAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, int* tIsStatic) {
+	DreamMugenCompiledAssignment* compiled = (DreamMugenCompiledAssignment*)*tAssignment;
+	*tIsStatic = 0;
+
+	AssignmentRegister result;
+	executeCompiledAssignment(compiled, tPlayer, &result);
+	return convertAssignmentRegisterToAssignmentReturn(&result);
+}
+
+static int isCompiledAssignment(DreamMugenAssignment** tAssignment) {
+	return (*tAssignment)->mType == MUGEN_ASSIGNMENT_TYPE_COMPILED;
+}
+
+static void evaluateCompiledAssignmentStart(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer, AssignmentRegister* oResult) {
+	gAssignmentEvaluator.mFreePointer = 0;
+
+	executeCompiledAssignment((DreamMugenCompiledAssignment*)*tAssignment, tPlayer, oResult);
+
+	if (!gAssignmentEvaluator.mEmergencyStack.empty()) gAssignmentEvaluator.mEmergencyStack.clear();
+}
+
+static AssignmentReturnValue* timeStoryFunction(DreamPlayer* tPlayer) { return makeNumberAssignmentReturn(getDolmexicaStoryTimeInState((StoryInstance*)tPlayer)); }
+
+static void setupStoryVariableAssignments() {
+	gVariableHandler.mVariables.clear();
+	gVariableHandler.mVariables["time"] = timeStoryFunction;
+	gVariableHandler.mVariables["random"] = randomFunction;
+	gVariableHandler.mVariables["platform"] = platformFunction;
+}
+
+//static AssignmentReturnValue* movementDownFrictionThresholdFunction(DreamPlayer* tPlayer) { return makeFloatAssignmentReturn(getPlayerLyingDownFrictionThreshold(tPlayer)); }
+
+static AssignmentReturnValue* evaluateAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryAnimationTimeLeft(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateRootAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryAnimationTimeLeft(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateAnimPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryAnimationPositionX(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateCharPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryCharacterPositionX(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateRootCharPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryCharacterPositionX(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateRootTextPosXStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryTextBasePositionX(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateRootTextPosYStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryTextBasePositionY(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateRootTextVisibleStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeBooleanAssignmentReturn(isDolmexicaStoryTextVisible(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateCharAnimStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterAnimation(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateRootCharAnimStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterAnimation(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateCharAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	string val;
+	convertAssignmentReturnToString(val, tIndex);
+	int id = getDolmexicaStoryIDFromString(val.data(), tInstance);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterTimeLeft(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateRootCharAnimTimeStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	string val;
+	convertAssignmentReturnToString(val, tIndex);
+	int id = getDolmexicaStoryIDFromString(val.data(), tInstance);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryCharacterTimeLeft(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(tInstance, id).data());
+}
+
+static AssignmentReturnValue* evaluateFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(tInstance, id));
+}
+
+static AssignmentReturnValue* evaluateGlobalVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getGlobalVariable(id));
+}
+
+static AssignmentReturnValue* evaluateGlobalFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getGlobalFloatVariable(id));
+}
+
+static AssignmentReturnValue* evaluateGlobalSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeStringAssignmentReturn(getGlobalStringVariable(id).data());
+}
+
+static AssignmentReturnValue* evaluateRootSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(getDolmexicaStoryRootInstance(), id).data());
+}
+
+static AssignmentReturnValue* evaluateRootFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateRootVarStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(getDolmexicaStoryRootInstance(), id));
+}
+
+static AssignmentReturnValue* evaluateParentSVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeStringAssignmentReturn(getDolmexicaStoryStringVariable(getDolmexicaStoryInstanceParent(tInstance), id).data());
+}
+
+static AssignmentReturnValue* evaluateParentFVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeFloatAssignmentReturn(getDolmexicaStoryFloatVariable(getDolmexicaStoryInstanceParent(tInstance), id));
+}
+
+static AssignmentReturnValue* evaluateParentVarStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryIntegerVariable(getDolmexicaStoryInstanceParent(tInstance), id));
+}
+
+static AssignmentReturnValue* evaluateNumHelperStoryArrayAssignment(AssignmentReturnValue* tIndex, int* tIsStatic) {
+	int id = convertAssignmentReturnToNumber(tIndex);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(getDolmexicaStoryGetHelperAmount(id));
+}
+
+static AssignmentReturnValue* evaluateNameIDStoryArrayAssignment(AssignmentReturnValue* tIndex, StoryInstance* tInstance, int* tIsStatic) {
+	string text;
+	convertAssignmentReturnToString(text, tIndex);
+	int id = getDolmexicaStoryIDFromString(text.data(), tInstance);
+	*tIsStatic = 0;
+	return makeNumberAssignmentReturn(id);
+}
+
+static AssignmentReturnValue* animTimeStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateAnimTimeStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), (StoryInstance*)tPlayer, tIsStatic); }
+static AssignmentReturnValue* rootAnimTimeStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateRootAnimTimeStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), tIsStatic); }
 static AssignmentReturnValue* animPosXStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateAnimPosXStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), (StoryInstance*)tPlayer, tIsStatic); }
 static AssignmentReturnValue* charPosXStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateCharPosXStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), (StoryInstance*)tPlayer, tIsStatic); }
 static AssignmentReturnValue* rootCharPosXStoryFunction(DreamMugenAssignment** tIndexAssignment, DreamPlayer* tPlayer, int* tIsStatic) { return evaluateRootCharPosXStoryArrayAssignment(evaluateAssignmentDependency(tIndexAssignment, tPlayer, tIsStatic), tIsStatic); }
@@ -2894,6 +3978,7 @@ void setupDreamStoryAssignmentEvaluator()
 	setupStoryVariableAssignments();
 	setupStoryArrayAssignments();
 	setupStoryComparisons();
+	setupAssignmentFunctionTable();
 }
 
 void shutdownDreamAssignmentEvaluator()
@@ -2901,11 +3986,18 @@ void shutdownDreamAssignmentEvaluator()
 	gVariableHandler.mComparisons.clear();
 	gVariableHandler.mArrays.clear();
 	gVariableHandler.mVariables.clear();
+	gVariableHandler.mFunctionTable.clear();
+	gVariableHandler.mFunctionIDs.clear();
 }
 
 int evaluateDreamAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
+	if (isCompiledAssignment(tAssignment)) {
+		AssignmentRegister result;
+		evaluateCompiledAssignmentStart(tAssignment, tPlayer, &result);
+		return convertAssignmentRegisterToBool(&result);
+	}
 
 	int isStatic;
 	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
@@ -2915,6 +4007,11 @@ int evaluateDreamAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPl
 double evaluateDreamAssignmentAndReturnAsFloat(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
+	if (isCompiledAssignment(tAssignment)) {
+		AssignmentRegister result;
+		evaluateCompiledAssignmentStart(tAssignment, tPlayer, &result);
+		return convertAssignmentRegisterToFloat(&result);
+	}
 
 	int isStatic;
 	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
@@ -2924,6 +4021,11 @@ double evaluateDreamAssignmentAndReturnAsFloat(DreamMugenAssignment** tAssignmen
 int evaluateDreamAssignmentAndReturnAsInteger(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return 0;
+	if (isCompiledAssignment(tAssignment)) {
+		AssignmentRegister result;
+		evaluateCompiledAssignmentStart(tAssignment, tPlayer, &result);
+		return convertAssignmentRegisterToNumber(&result);
+	}
 
 	int isStatic;
 	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
@@ -2942,50 +4044,55 @@ void evaluateDreamAssignmentAndReturnAsString(string& oString, DreamMugenAssignm
 	convertAssignmentReturnToString(oString, ret);
 }
 
+static int getAssignmentReturnVectorComponents(AssignmentReturnValue* tValue, AssignmentReturnValue** oComponents, int tOffset, int tMaximum) {
+	if (tOffset >= tMaximum) return tOffset;
+
+	if (tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_VECTOR || tValue->mType == MUGEN_ASSIGNMENT_RETURN_TYPE_RANGE) {
+		tOffset = getAssignmentReturnVectorComponents(getVectorAssignmentReturnFirstDependency(tValue), oComponents, tOffset, tMaximum);
+		return getAssignmentReturnVectorComponents(getVectorAssignmentReturnSecondDependency(tValue), oComponents, tOffset, tMaximum);
+	}
+
+	// bottom components like var(1)/0 keep their slot and convert to 0
+	oComponents[tOffset] = tValue;
+	return tOffset + 1;
+}
+
 Vector3D evaluateDreamAssignmentAndReturnAsVector3D(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer)
 {
 	if (!(*tAssignment)) return makePosition(0, 0, 0);
+	if (isCompiledAssignment(tAssignment)) {
+		AssignmentRegister result;
+		evaluateCompiledAssignmentStart(tAssignment, tPlayer, &result);
+		return makePosition(convertAssignmentRegisterToFloat(&result), 0, 0);
+	}
 
 	int isStatic;
 	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	string test;
-	convertAssignmentReturnToString(test, ret);
-
-	double x, y, z;
-	char tX[100], comma1[20], tY[100], comma2[20], tZ[100];
-
-	int items = sscanf(test.data(), "%99s %19s %99s %19s %99s", tX, comma1, tY, comma2, tZ);
-
-	if (items >= 1) x = atof(tX);
-	else x = 0;
-	if (items >= 3) y = atof(tY);
-	else y = 0;
-	if (items >= 5) z = atof(tZ);
-	else z = 0;
+	AssignmentReturnValue* components[3];
+	int items = getAssignmentReturnVectorComponents(ret, components, 0, 3);
 
+	double x = items >= 1 ? convertAssignmentReturnToFloat(components[0]) : 0;
+	double y = items >= 2 ? convertAssignmentReturnToFloat(components[1]) : 0;
+	double z = items >= 3 ? convertAssignmentReturnToFloat(components[2]) : 0;
 	return makePosition(x, y, z);
 }
 
 Vector3DI evaluateDreamAssignmentAndReturnAsVector3DI(DreamMugenAssignment** tAssignment, DreamPlayer * tPlayer)
 {
 	if (!(*tAssignment)) return makeVector3DI(0, 0, 0);
+	if (isCompiledAssignment(tAssignment)) {
+		AssignmentRegister result;
+		evaluateCompiledAssignmentStart(tAssignment, tPlayer, &result);
+		return makeVector3DI(convertAssignmentRegisterToNumber(&result), 0, 0);
+	}
 
 	int isStatic;
 	AssignmentReturnValue* ret = evaluateAssignmentStart(tAssignment, tPlayer, &isStatic);
-	string test;
-	convertAssignmentReturnToString(test, ret);
-
-	int x, y, z;
-	char tX[100], comma1[20], tY[100], comma2[20], tZ[100];
-
-	int items = sscanf(test.data(), "%99s %19s %99s %19s %99s", tX, comma1, tY, comma2, tZ);
-
-	if (items >= 1) x = atoi(tX);
-	else x = 0;
-	if (items >= 3) y = atoi(tY);
-	else y = 0;
-	if (items >= 5) z = atoi(tZ);
-	else z = 0;
+	AssignmentReturnValue* components[3];
+	int items = getAssignmentReturnVectorComponents(ret, components, 0, 3);
 
+	int x = items >= 1 ? convertAssignmentReturnToNumber(components[0]) : 0;
+	int y = items >= 2 ? convertAssignmentReturnToNumber(components[1]) : 0;
+	int z = items >= 3 ? convertAssignmentReturnToNumber(components[2]) : 0;
 	return makeVector3DI(x, y, z);
 }
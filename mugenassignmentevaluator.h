@@ -4,11 +4,27 @@
 
 #include "mugenassignment.h"
 #include "playerdefinition.h"
+#include "charactercacheimage.h"
 
 void setupDreamAssignmentEvaluator();
 void setupDreamStoryAssignmentEvaluator();
 void shutdownDreamAssignmentEvaluator();
 
+void bindDreamRawVariableAssignment(DreamMugenRawVariableAssignment* tAssignment);
+void setDreamAssignmentFoldingPlayer(DreamPlayer* tPlayer);
+void setDreamAssignmentFoldingDeferred();
+void resetDreamAssignmentFoldingPlayer();
+void bindDreamStaticMugenAssignment(DreamMugenAssignment* tAssignment, DreamPlayer* tPlayer);
+void compileDreamAssignment(DreamMugenAssignment** tAssignment);
+uint8_t getDreamAssignmentDependencies(DreamMugenAssignment** tAssignment);
+
+int getDreamAssignmentFunctionID(void* tFunc, uint32_t* oID);
+void* getDreamAssignmentFunctionFromID(uint32_t tID);
+uint32_t getDreamAssignmentFunctionAmount();
+uint32_t getDreamAssignmentFunctionTableStamp();
+uint32_t getDreamAssignmentCacheLayoutStamp();
+void writeDreamMugenAssignmentCacheImage(DreamCharacterCacheImage* tImage, uint32_t tSlot, DreamMugenAssignment* tAssignment);
+
 int evaluateDreamAssignment(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
 double evaluateDreamAssignmentAndReturnAsFloat(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
 int evaluateDreamAssignmentAndReturnAsInteger(DreamMugenAssignment** tAssignment, DreamPlayer* tPlayer);
@@ -13,67 +13,110 @@
 #include <prism/stlutil.h>
 
 #include "gamelogic.h"
+#include "inputrecording.h"
 
 using namespace std;
 
 typedef struct {
-	string mName;
 	int mIsActive;
 	int mNow;
 	int mBufferTime;
-	int mLookupID;
 } MugenCommandState;
 
 typedef struct {
-	unordered_map<string, MugenCommandState> mStates;
-	vector<MugenCommandState*> mStateLookup;
+	vector<MugenCommandState> mStates;
+	unordered_map<string, int> mLookupIDs;
 } MugenCommandStates;
 
+#define COMMAND_TARGET_BIT_AMOUNT 32
+#define COMMAND_INVALID_TARGET_BIT (COMMAND_TARGET_BIT_AMOUNT - 1)
+
 typedef struct {
-	string mName;
-	DreamMugenCommandInput* mInput;
-	int mStep;
-	int mNow;
-} ActiveMugenCommand;
+	uint32_t mHeldTargets;
+	uint32_t mPressedTargets;
+	uint32_t mReleasedTargets;
+	int mIsSameAsPreviousStep;
+} CompiledMugenCommandStep;
+
+typedef struct {
+	int mLookupID;
+	int mFirstStep;
+	int mStepAmount;
+	int mTime;
+	int mBufferTime;
+} CompiledMugenCommandInput;
 
 typedef struct {
-	int mIsBeingProcessed;
+	vector<CompiledMugenCommandStep> mSteps;
+	vector<CompiledMugenCommandInput> mInputs;
 
-} InternalMugenCommandState;
+	vector<int> mPressedStarts[COMMAND_TARGET_BIT_AMOUNT];
+	vector<int> mReleasedStarts[COMMAND_TARGET_BIT_AMOUNT];
+	vector<int> mHeldStarts;
+} CompiledMugenCommands;
+
+typedef struct {
+	int mInput;
+	int mStep;
+	int mNow;
+} ActiveMugenCommand;
 
 typedef struct {
 	DreamMugenCommands* tCommands;
 	MugenCommandStates tStates;
-	map<string, InternalMugenCommandState> mInternalStates;
 
-	list<ActiveMugenCommand> mActiveCommands;
+	CompiledMugenCommands mCompiledCommands;
+	vector<ActiveMugenCommand> mActiveCommands;
+	vector<int> mStartingInputs;
 
 	int mControllerID;
 	int mIsFacingRight;
+	uint32_t mActivityStamp;
+
+	uint32_t mHeldTargets;
+	uint32_t mPressedTargets;
+	uint32_t mReleasedTargets;
 } RegisteredMugenCommand;
 
-static struct {
-	vector<RegisteredMugenCommand> mRegisteredCommands;
-	int mRegisteredCommandAmount;
+typedef struct {
+	uint32_t mInputMask; // controller state as recorded and played back
+	uint32_t mPreviousInputMask;
+	uint32_t mHeldMask; // input mask as seen by commands
+	uint32_t mPreviousHeldMask;
 
-	uint32_t mHeldMask[2];
-	uint32_t mPreviousHeldMask[2];
+	int mOsuInputAllowedFlag;
+} MugenCommandControllerInput;
 
-	int mOsuInputAllowedFlag[2];
+static struct {
+	vector<RegisteredMugenCommand> mRegisteredCommands;
+	vector<MugenCommandControllerInput> mControllerInputs;
+	vector<uint32_t> mFrameMasks;
 } gMugenCommandHandler;
 
-#define MAXIMUM_REGISTERED_COMMAND_AMOUNT 2
-
+#define DEFAULT_COMMAND_CONTROLLER_AMOUNT 2
+
+static MugenCommandControllerInput* getControllerInput(int tControllerID) {
+	if (tControllerID >= (int)gMugenCommandHandler.mControllerInputs.size()) {
+		MugenCommandControllerInput e;
+		e.mInputMask = 0;
+		e.mPreviousInputMask = 0;
+		e.mHeldMask = 0;
+		e.mPreviousHeldMask = 0;
+		e.mOsuInputAllowedFlag = 0;
+		gMugenCommandHandler.mControllerInputs.resize(tControllerID + 1, e);
+		gMugenCommandHandler.mFrameMasks.resize(tControllerID + 1, 0);
+	}
+	return &gMugenCommandHandler.mControllerInputs[tControllerID];
+}
 
 static void loadMugenCommandHandler(void* tData) {
 	(void)tData;
-	gMugenCommandHandler.mRegisteredCommands = vector<RegisteredMugenCommand>(MAXIMUM_REGISTERED_COMMAND_AMOUNT);
-	gMugenCommandHandler.mRegisteredCommandAmount = 0;
+	gMugenCommandHandler.mRegisteredCommands.clear();
+	getControllerInput(DEFAULT_COMMAND_CONTROLLER_AMOUNT - 1);
 
 	if (getGameMode() == GAME_MODE_OSU) {
-		int i;
-		for (i = 0; i < 2; i++) {
-			gMugenCommandHandler.mOsuInputAllowedFlag[i] = 0;
+		for (size_t i = 0; i < gMugenCommandHandler.mControllerInputs.size(); i++) {
+			gMugenCommandHandler.mControllerInputs[i].mOsuInputAllowedFlag = 0;
 		}
 	}
 }
@@ -84,9 +127,10 @@ static void unloadSingleRegisteredCommand(void* tCaller, RegisteredMugenCommand&
 	(void)tCaller;
 	RegisteredMugenCommand* e = &tData;
 	e->mActiveCommands.clear();
+	e->mStartingInputs.clear();
+	e->mCompiledCommands = CompiledMugenCommands();
 	e->tStates.mStates.clear();
-	e->tStates.mStateLookup.clear();
-	e->mInternalStates.clear();
+	e->tStates.mLookupIDs.clear();
 }
 
 static void unloadMugenCommandHandler(void* tData) {
@@ -95,111 +139,228 @@ static void unloadMugenCommandHandler(void* tData) {
 	stl_delete_vector(gMugenCommandHandler.mRegisteredCommands);
 }
 
+static uint32_t getCommandTargetBit(DreamMugenCommandInputStepTarget tTarget) {
+	if (tTarget <= MUGEN_COMMAND_INPUT_STEP_TARGET_MULTIPLE || tTarget > MUGEN_COMMAND_INPUT_STEP_TARGET_MULTI_BACKWARD) return 1u << COMMAND_INVALID_TARGET_BIT;
+	return 1u << tTarget;
+}
+
+static void addConditionToCompiledStep(CompiledMugenCommandStep* tCompiledStep, DreamMugenCommandInputStep* tStep) {
+	uint32_t targetBit = getCommandTargetBit(tStep->mTarget);
+	if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_HOLDING) tCompiledStep->mHeldTargets |= targetBit;
+	else if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS) tCompiledStep->mPressedTargets |= targetBit;
+	else if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_RELEASE) tCompiledStep->mReleasedTargets |= targetBit;
+	else tCompiledStep->mHeldTargets |= 1u << COMMAND_INVALID_TARGET_BIT;
+}
+
+static int isSameCommandInputStep(DreamMugenCommandInputStep* tPreviousStep, DreamMugenCommandInputStep* tStep) {
+	if (tPreviousStep->mType != tStep->mType) return 0;
+	if (tPreviousStep->mType != MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS) return 0;
+	return tPreviousStep->mTarget == tStep->mTarget;
+}
+
+static CompiledMugenCommandStep compileCommandInputStep(DreamMugenCommandInput* tInput, int tStep) {
+	DreamMugenCommandInputStep* step = (DreamMugenCommandInputStep*)vector_get(&tInput->mInputSteps, tStep);
+
+	CompiledMugenCommandStep ret;
+	ret.mHeldTargets = 0;
+	ret.mPressedTargets = 0;
+	ret.mReleasedTargets = 0;
+	if (step->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_MULTIPLE) {
+		DreamMugenCommandInputStepMultipleTargetData* data = (DreamMugenCommandInputStepMultipleTargetData*)step->mData;
+		for (int i = 0; i < vector_size(&data->mSubSteps); i++) {
+			addConditionToCompiledStep(&ret, (DreamMugenCommandInputStep*)vector_get(&data->mSubSteps, i));
+		}
+	}
+	else {
+		addConditionToCompiledStep(&ret, step);
+	}
+
+	ret.mIsSameAsPreviousStep = tStep > 0 && isSameCommandInputStep((DreamMugenCommandInputStep*)vector_get(&tInput->mInputSteps, tStep - 1), step);
+	return ret;
+}
+
+static int getLowestTargetBitIndex(uint32_t tTargets) {
+	int ret = 0;
+	while (!(tTargets & (1u << ret))) ret++;
+	return ret;
+}
+
+static void addCompiledInputStart(CompiledMugenCommands* tCompiledCommands, int tInputIndex) {
+	CompiledMugenCommandInput* input = &tCompiledCommands->mInputs[tInputIndex];
+	CompiledMugenCommandStep* firstStep = &tCompiledCommands->mSteps[input->mFirstStep];
+
+	if (firstStep->mPressedTargets) {
+		tCompiledCommands->mPressedStarts[getLowestTargetBitIndex(firstStep->mPressedTargets)].push_back(tInputIndex);
+	}
+	else if (firstStep->mReleasedTargets) {
+		tCompiledCommands->mReleasedStarts[getLowestTargetBitIndex(firstStep->mReleasedTargets)].push_back(tInputIndex);
+	}
+	else {
+		tCompiledCommands->mHeldStarts.push_back(tInputIndex);
+	}
+}
+
+static void compileCommandInput(CompiledMugenCommands* tCompiledCommands, DreamMugenCommandInput* tInput, int tLookupID) {
+	if (!vector_size(&tInput->mInputSteps)) return;
+
+	CompiledMugenCommandInput e;
+	e.mLookupID = tLookupID;
+	e.mFirstStep = (int)tCompiledCommands->mSteps.size();
+	e.mStepAmount = vector_size(&tInput->mInputSteps);
+	e.mTime = tInput->mTime;
+	e.mBufferTime = tInput->mBufferTime;
+	for (int i = 0; i < e.mStepAmount; i++) {
+		tCompiledCommands->mSteps.push_back(compileCommandInputStep(tInput, i));
+	}
+
+	tCompiledCommands->mInputs.push_back(e);
+	addCompiledInputStart(tCompiledCommands, (int)tCompiledCommands->mInputs.size() - 1);
+}
+
+static void compileCommand(CompiledMugenCommands* tCompiledCommands, DreamMugenCommand* tCommand, int tLookupID) {
+	for (int i = 0; i < vector_size(&tCommand->mInputs); i++) {
+		compileCommandInput(tCompiledCommands, (DreamMugenCommandInput*)vector_get(&tCommand->mInputs, i), tLookupID);
+	}
+}
+
 static void addSingleMugenCommandState(RegisteredMugenCommand* tCaller, const string &tKey, DreamMugenCommand& tData) {
-	(void)tData;
 	RegisteredMugenCommand* s = (RegisteredMugenCommand*)tCaller;
 
 	MugenCommandState e;
-	e.mName = tKey;
 	e.mIsActive = 0;
-	e.mLookupID = s->tStates.mStateLookup.size();
-	s->tStates.mStates[tKey] = e;
-	s->tStates.mStateLookup.push_back(&s->tStates.mStates[tKey]);
-
-	InternalMugenCommandState internalState;
-	internalState.mIsBeingProcessed = 0;
-	
-	s->mInternalStates[tKey] = internalState;
+	e.mNow = 0;
+	e.mBufferTime = 0;
+	int lookupID = (int)s->tStates.mStates.size();
+	s->tStates.mStates.push_back(e);
+	s->tStates.mLookupIDs[tKey] = lookupID;
+	compileCommand(&s->mCompiledCommands, &tData, lookupID);
 }
 
 static void setupMugenCommandStates(RegisteredMugenCommand* e) {
 	e->tStates.mStates.clear();
-	e->tStates.mStateLookup.clear();
+	e->tStates.mLookupIDs.clear();
 	stl_string_map_map(e->tCommands->mCommands, addSingleMugenCommandState, e);
 }
 
-static int getNewRegisteredCommandIndex() {
-	int ret = gMugenCommandHandler.mRegisteredCommandAmount;
-	gMugenCommandHandler.mRegisteredCommandAmount++;
-	return ret;
-}
-
 int registerDreamMugenCommands(int tControllerID, DreamMugenCommands * tCommands)
 {
 	
 	RegisteredMugenCommand e;
 	e.mActiveCommands.clear();
 	e.tCommands = tCommands;
-	e.mInternalStates.clear();
 	e.mControllerID = tControllerID;
 	e.mIsFacingRight = 1;
+	e.mActivityStamp = 0;
+	e.mHeldTargets = 0;
+	e.mPressedTargets = 0;
+	e.mReleasedTargets = 0;
+
+	getControllerInput(tControllerID);
 
-	int returnIndex = getNewRegisteredCommandIndex();
-	gMugenCommandHandler.mRegisteredCommands[returnIndex] = e;
+	int returnIndex = (int)gMugenCommandHandler.mRegisteredCommands.size();
+	gMugenCommandHandler.mRegisteredCommands.push_back(e);
 	setupMugenCommandStates(&gMugenCommandHandler.mRegisteredCommands[returnIndex]);
 
 	return returnIndex;
 }
 
+static int getCommandLookupID(RegisteredMugenCommand* tRegisteredCommand, const char* tCommandName) {
+	unordered_map<string, int>::iterator it = tRegisteredCommand->tStates.mLookupIDs.find(tCommandName);
+	if (it == tRegisteredCommand->tStates.mLookupIDs.end()) return -1;
+	return it->second;
+}
+
+static int isValidCommandLookupID(RegisteredMugenCommand* tRegisteredCommand, int tLookupIndex) {
+	return tLookupIndex >= 0 && tLookupIndex < (int)tRegisteredCommand->tStates.mStates.size();
+}
+
 int isDreamCommandActive(int tID, const char * tCommandName)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	string key(tCommandName);
-	if (!stl_map_contains(e->tStates.mStates, key)) {
+	int lookupID = getCommandLookupID(e, tCommandName);
+	if (lookupID == -1) {
 		logWarningFormat("Querying nonexistant command name %s.", tCommandName);
 		return 0;
 	}
-	MugenCommandState* state = &e->tStates.mStates[key];
 	
-	return state->mIsActive;
+	return e->tStates.mStates[lookupID].mIsActive;
 }
 
 int isDreamCommandActiveByLookupIndex(int tID, int tLookupIndex)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	if (tLookupIndex < 0 || tLookupIndex >= (int)e->tStates.mStateLookup.size()) {
+	if (!isValidCommandLookupID(e, tLookupIndex)) {
 		logWarningFormat("Querying nonexistant command lookup %d.", tLookupIndex);
 		return 0;
 	}
-	MugenCommandState* state = e->tStates.mStateLookup[tLookupIndex];
 
-	return state->mIsActive;
+	return e->tStates.mStates[tLookupIndex].mIsActive;
 }
 
-static void setCommandStateActive(RegisteredMugenCommand* tRegisteredCommand, const string& tName, int tBufferTime);
+uint32_t getDreamCommandActivityStamp(int tID)
+{
+	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
+	return e->mActivityStamp;
+}
+
+static void setCommandStateActiveByLookupID(RegisteredMugenCommand* tRegisteredCommand, int tLookupID, int tBufferTime);
 
 int isDreamCommandForLookup(int tID, const char * tCommandName, int * oLookupIndex)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	string key(tCommandName);
-	if (!stl_map_contains(e->tStates.mStates, key)) {
+	int lookupID = getCommandLookupID(e, tCommandName);
+	if (lookupID == -1) {
 		return 0;
 	}
-	MugenCommandState* state = &e->tStates.mStates[key];
-	*oLookupIndex = state->mLookupID;
+	*oLookupIndex = lookupID;
+	return 1;
+}
+
+int isDreamCommandForLookupInCommands(DreamMugenCommands* tCommands, const char* tCommandName, int* oLookupIndex)
+{
+	// matches the lookup IDs handed out by setupMugenCommandStates, which follow the map order
+	auto it = tCommands->mCommands.find(tCommandName);
+	if (it == tCommands->mCommands.end()) {
+		return 0;
+	}
+	*oLookupIndex = (int)std::distance(tCommands->mCommands.begin(), it);
 	return 1;
 }
 
 void setDreamPlayerCommandActiveForAI(int tID, const char * tCommandName, int tBufferTime)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	setCommandStateActive(e, tCommandName, tBufferTime);
+	int lookupID = getCommandLookupID(e, tCommandName);
+	if (lookupID == -1) {
+		logWarningFormat("Trying to set nonexistant command name %s active.", tCommandName);
+		return;
+	}
+	setCommandStateActiveByLookupID(e, lookupID, tBufferTime);
+}
+
+void setDreamPlayerCommandActiveForAIByLookupIndex(int tID, int tLookupIndex, int tBufferTime)
+{
+	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
+	if (!isValidCommandLookupID(e, tLookupIndex)) {
+		logWarningFormat("Trying to set nonexistant command lookup %d active.", tLookupIndex);
+		return;
+	}
+	setCommandStateActiveByLookupID(e, tLookupIndex, tBufferTime);
 }
 
 int setDreamPlayerCommandNumberActiveForDebug(int tID, int tCommandNumber)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	if (tCommandNumber >= (int)e->tCommands->mCommands.size()) return 0;
-	auto command = stl_map_get_pair_by_index(e->tCommands->mCommands, tCommandNumber);
+	if (!isValidCommandLookupID(e, tCommandNumber)) return 0;
 
-	setDreamPlayerCommandActiveForAI(tID, command->first.data(), 2);
+	setCommandStateActiveByLookupID(e, tCommandNumber, 2);
 	return 1;
 }
 
 int getDreamPlayerCommandAmount(int tID)
 {
 	RegisteredMugenCommand* e = &gMugenCommandHandler.mRegisteredCommands[tID];
-	return e->tCommands->mCommands.size();
+	return (int)e->tStates.mStates.size();
 }
 
 void setDreamMugenCommandFaceDirection(int tID, FaceDirection tDirection)
@@ -210,58 +371,17 @@ void setDreamMugenCommandFaceDirection(int tID, FaceDirection tDirection)
 
 void allowOsuPlayerCommandInputOneFrame(int tRootIndex)
 {
-	gMugenCommandHandler.mOsuInputAllowedFlag[tRootIndex] = 1;
+	getControllerInput(tRootIndex)->mOsuInputAllowedFlag = 1;
 }
 
 void resetOsuPlayerCommandInputAllowed(int tRootIndex)
 {
-	gMugenCommandHandler.mOsuInputAllowedFlag[tRootIndex] = 0;
+	getControllerInput(tRootIndex)->mOsuInputAllowedFlag = 0;
 }
 
 int isOsuPlayerCommandInputAllowed(int tRootIndex)
 {
-	return gMugenCommandHandler.mOsuInputAllowedFlag[tRootIndex];
-}
-
-static int handleSingleCommandInputStepAndReturnIfActive(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight);
-
-typedef struct {
-	int isActiveAmount;
-	int isStepOverAmount;
-	int mControllerID;
-	int mIsFacingRight;
-} MultipleCommandInputStepCaller;
-
-static void handleSingleMultipleCommandInputStep(void* tCaller, void* tData) {
-	MultipleCommandInputStepCaller* caller = (MultipleCommandInputStepCaller*)tCaller;
-	DreamMugenCommandInputStep* step = (DreamMugenCommandInputStep*)tData;
-
-	int isStepOver = 0;
-	int isActive = handleSingleCommandInputStepAndReturnIfActive(step, &isStepOver, caller->mControllerID, caller->mIsFacingRight);
-
-	caller->isActiveAmount += isActive;
-	caller->isStepOverAmount += isStepOver;
-}
-
-static int handleMultipleCommandInputStep(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight) {
-	DreamMugenCommandInputStepMultipleTargetData* data = (DreamMugenCommandInputStepMultipleTargetData*)tStep->mData;
-	assert(tStep->mTarget == MUGEN_COMMAND_INPUT_STEP_TARGET_MULTIPLE);
-
-	MultipleCommandInputStepCaller caller;
-	caller.isActiveAmount = 0;
-	caller.isStepOverAmount = 0;
-	caller.mControllerID = tControllerID;
-	caller.mIsFacingRight = tIsFacingRight;
-	vector_map(&data->mSubSteps, handleSingleMultipleCommandInputStep, &caller);
-
-	if (caller.isActiveAmount < vector_size(&data->mSubSteps)) return 0;
-
-	assert(caller.isStepOverAmount == 0 || caller.isStepOverAmount == vector_size(&data->mSubSteps));
-
-	if (caller.isStepOverAmount) *oIsStepOver = 1;
-	else *oIsStepOver = 0;
-
-	return 1;
+	return getControllerInput(tRootIndex)->mOsuInputAllowedFlag;
 }
 
 #define MASK_A (1 << 0)
@@ -349,246 +469,225 @@ static int isButtonCommandActive(DreamMugenCommandInputStepTarget tTarget, uint3
 	}
 }
 
-static int isTargetHeld(DreamMugenCommandInputStepTarget tTarget, int tControllerID, int tIsFacingRight) {
-	return isButtonCommandActive(tTarget, gMugenCommandHandler.mHeldMask[tControllerID], tIsFacingRight);
-}
-
-static int isTargetPressed(DreamMugenCommandInputStepTarget tTarget, int tControllerID, int tIsFacingRight) {
-	return isButtonCommandActive(tTarget, gMugenCommandHandler.mHeldMask[tControllerID], tIsFacingRight) && !isButtonCommandActive(tTarget, gMugenCommandHandler.mPreviousHeldMask[tControllerID], tIsFacingRight);
-}
-
-static int isTargetReleased(DreamMugenCommandInputStepTarget tTarget, int tControllerID, int tIsFacingRight) {
-	return !isButtonCommandActive(tTarget, gMugenCommandHandler.mHeldMask[tControllerID], tIsFacingRight) && isButtonCommandActive(tTarget, gMugenCommandHandler.mPreviousHeldMask[tControllerID], tIsFacingRight);
-}
-
-static int handleHoldingCommandInputStep(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight) {
-	int ret = isTargetHeld(tStep->mTarget, tControllerID, tIsFacingRight);
-	*oIsStepOver = 1; // TODO add to active steps for command and always check (https://dev.azure.com/captdc/DogmaRnDA/_workitems/edit/387)
-
-	return ret;
-}
-
-static int handlePressingCommandInputStep(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight) {
-	int ret = isTargetPressed(tStep->mTarget, tControllerID, tIsFacingRight);
-	*oIsStepOver = 1;
-
+static uint32_t getActiveCommandTargets(uint32_t tMask, int tIsFacingRight) {
+	uint32_t ret = 0;
+	for (int target = MUGEN_COMMAND_INPUT_STEP_TARGET_DOWN; target <= MUGEN_COMMAND_INPUT_STEP_TARGET_MULTI_BACKWARD; target++) {
+		if (isButtonCommandActive((DreamMugenCommandInputStepTarget)target, tMask, tIsFacingRight)) ret |= 1u << target;
+	}
 	return ret;
 }
 
-static int handleReleasingCommandInputStep(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight) {
-	int ret = isTargetReleased(tStep->mTarget, tControllerID, tIsFacingRight);
-	*oIsStepOver = 1; 
-
-	return ret;
+static void updateCommandTargets(RegisteredMugenCommand* tRegisteredCommand) {
+	MugenCommandControllerInput* input = &gMugenCommandHandler.mControllerInputs[tRegisteredCommand->mControllerID];
+	uint32_t held = getActiveCommandTargets(input->mHeldMask, tRegisteredCommand->mIsFacingRight);
+	uint32_t previousHeld = getActiveCommandTargets(input->mPreviousHeldMask, tRegisteredCommand->mIsFacingRight);
+	tRegisteredCommand->mHeldTargets = held;
+	tRegisteredCommand->mPressedTargets = held & ~previousHeld;
+	tRegisteredCommand->mReleasedTargets = ~held & previousHeld;
 }
 
-
-
-static int handleSingleCommandInputStepAndReturnIfActive(DreamMugenCommandInputStep* tStep, int* oIsStepOver, int tControllerID, int tIsFacingRight) {
-
-	if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_MULTIPLE) {
-		return handleMultipleCommandInputStep(tStep, oIsStepOver, tControllerID, tIsFacingRight);
-	}
-	else if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_HOLDING) {
-		return handleHoldingCommandInputStep(tStep, oIsStepOver, tControllerID, tIsFacingRight);
-	}
-	else if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS) {
-		return handlePressingCommandInputStep(tStep, oIsStepOver, tControllerID, tIsFacingRight);
-	}
-	else if (tStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_RELEASE) {
-		return handleReleasingCommandInputStep(tStep, oIsStepOver, tControllerID, tIsFacingRight);
-	}
-	else {
-		return 0;
-	}
+static int isCompiledStepActive(RegisteredMugenCommand* tRegisteredCommand, CompiledMugenCommandStep* tStep) {
+	return (tRegisteredCommand->mHeldTargets & tStep->mHeldTargets) == tStep->mHeldTargets
+		&& (tRegisteredCommand->mPressedTargets & tStep->mPressedTargets) == tStep->mPressedTargets
+		&& (tRegisteredCommand->mReleasedTargets & tStep->mReleasedTargets) == tStep->mReleasedTargets;
 }
 
-static void removeActiveCommand(ActiveMugenCommand* tCommand, RegisteredMugenCommand* tRegisteredCommand) {
-	InternalMugenCommandState* state = &tRegisteredCommand->mInternalStates[tCommand->mName];
-	state->mIsBeingProcessed = 0;
+static void activateCommandState(RegisteredMugenCommand* tRegisteredCommand, MugenCommandState* tState, int tBufferTime) {
+	if (!tState->mIsActive) tRegisteredCommand->mActivityStamp++;
+	tState->mIsActive = 1;
+	tState->mNow = 0;
+	tState->mBufferTime = tBufferTime;
 }
 
-static void setCommandStateActive(RegisteredMugenCommand* tRegisteredCommand, const string& tName, int tBufferTime) {
-	MugenCommandState* state = &tRegisteredCommand->tStates.mStates[tName];
-	state->mIsActive = 1;
-	state->mNow = 0;
-	state->mBufferTime = tBufferTime;
+static void setCommandStateActiveByLookupID(RegisteredMugenCommand* tRegisteredCommand, int tLookupID, int tBufferTime) {
+	activateCommandState(tRegisteredCommand, &tRegisteredCommand->tStates.mStates[tLookupID], tBufferTime);
 }
 
 static void setCommandStateInactive(MugenCommandState* tState) {
 	tState->mIsActive = 0;
 }
 
-static int isSameStepAsBefore(ActiveMugenCommand* tCommand) {
-	assert(tCommand->mStep > 0);
-	assert(tCommand->mStep < vector_size(&tCommand->mInput->mInputSteps));
-
-	DreamMugenCommandInputStep* mPreviousStep = (DreamMugenCommandInputStep*)vector_get(&tCommand->mInput->mInputSteps, tCommand->mStep - 1);
-	DreamMugenCommandInputStep* mStep = (DreamMugenCommandInputStep*)vector_get(&tCommand->mInput->mInputSteps, tCommand->mStep);
-
-	int isSameType = mPreviousStep->mType == mStep->mType;
-	if (!isSameType) return 0;
+static int updateSingleActiveMugenCommand(RegisteredMugenCommand* tRegisteredCommand, ActiveMugenCommand* tCommand) {
+	CompiledMugenCommandInput* input = &tRegisteredCommand->mCompiledCommands.mInputs[tCommand->mInput];
 
-	int isPressType = mPreviousStep->mType == MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS;
-	if (!isPressType) return 0;
+	if (tCommand->mNow >= input->mTime) return 1;
+	tCommand->mNow++;
 
-	int haveSameTarget = mPreviousStep->mTarget == mStep->mTarget;
-	return haveSameTarget;
-}
-
-static int updateSingleActiveMugenCommand(RegisteredMugenCommand* tCaller, ActiveMugenCommand& tData) {
-	RegisteredMugenCommand* registeredCommand = (RegisteredMugenCommand*)tCaller;
-	ActiveMugenCommand* command = &tData;
+	while (1) {
+		CompiledMugenCommandStep* step = &tRegisteredCommand->mCompiledCommands.mSteps[input->mFirstStep + tCommand->mStep];
+		if (!isCompiledStepActive(tRegisteredCommand, step)) return 0;
 
-	if (command->mNow >= command->mInput->mTime) {
-		removeActiveCommand(command, registeredCommand);
-		return 1;
-	}
-	command->mNow++;
-
-	int isRunning = 1;
-	while (isRunning) {
-		DreamMugenCommandInputStep* step = (DreamMugenCommandInputStep*)vector_get(&command->mInput->mInputSteps, command->mStep);
-
-		int isStepOver = 0;
-		int isActive = handleSingleCommandInputStepAndReturnIfActive(step, &isStepOver, registeredCommand->mControllerID, registeredCommand->mIsFacingRight);
-		if (!isActive) return 0;
-
-		if (isStepOver) {
-			command->mStep++;
-			if (command->mStep == vector_size(&command->mInput->mInputSteps)) {
-				setCommandStateActive(registeredCommand, command->mName, command->mInput->mBufferTime);
-				removeActiveCommand(command, registeredCommand);
-				return 1;
-			}
-
-			if (isSameStepAsBefore(command)) break;
+		tCommand->mStep++;
+		if (tCommand->mStep == input->mStepAmount) {
+			setCommandStateActiveByLookupID(tRegisteredCommand, input->mLookupID, input->mBufferTime);
+			return 1;
 		}
-	}
 
-	return 0;
+		if (tRegisteredCommand->mCompiledCommands.mSteps[input->mFirstStep + tCommand->mStep].mIsSameAsPreviousStep) return 0;
+	}
 }
 
 static void updateActiveMugenCommands(RegisteredMugenCommand* tCommand) {
-	stl_list_remove_predicate(tCommand->mActiveCommands, updateSingleActiveMugenCommand, tCommand);
+	size_t remainingAmount = 0;
+	for (size_t i = 0; i < tCommand->mActiveCommands.size(); i++) {
+		if (updateSingleActiveMugenCommand(tCommand, &tCommand->mActiveCommands[i])) continue;
+		tCommand->mActiveCommands[remainingAmount++] = tCommand->mActiveCommands[i];
+	}
+	tCommand->mActiveCommands.resize(remainingAmount);
 }
 
-typedef struct {
-	RegisteredMugenCommand* mRegisteredCommand;
-	const string& mName;
-} StaticMugenCommandInputCaller;
+static void addNewActiveMugenCommand(RegisteredMugenCommand* tRegisteredCommand, int tInputIndex) {
+	CompiledMugenCommandInput* input = &tRegisteredCommand->mCompiledCommands.mInputs[tInputIndex];
 
-static void addNewActiveMugenCommand(DreamMugenCommandInput* tInput, RegisteredMugenCommand* tRegisteredCommand, const string& tName, int mIsStepOver) {
-	
-	if (vector_size(&tInput->mInputSteps) == 1) {
-		setCommandStateActive(tRegisteredCommand, tName, tInput->mBufferTime);
+	if (input->mStepAmount == 1) {
+		setCommandStateActiveByLookupID(tRegisteredCommand, input->mLookupID, input->mBufferTime);
 		return;
 	}
 
 	ActiveMugenCommand e;
-	e.mInput = tInput;
-	e.mName = tName;
+	e.mInput = tInputIndex;
 	e.mNow = 0;
-	e.mStep = min(1, mIsStepOver);
+	e.mStep = 1;
 
 	int isAlreadyOver = 0;
-	if (!isSameStepAsBefore(&e)) {
-		isAlreadyOver = updateSingleActiveMugenCommand(tRegisteredCommand, e);
+	if (!tRegisteredCommand->mCompiledCommands.mSteps[input->mFirstStep + 1].mIsSameAsPreviousStep) {
+		isAlreadyOver = updateSingleActiveMugenCommand(tRegisteredCommand, &e);
 	}
-	if(!isAlreadyOver) tRegisteredCommand->mActiveCommands.push_back(e);
+	if (!isAlreadyOver) tRegisteredCommand->mActiveCommands.push_back(e);
 }
 
-static void updateSingleStaticMugenCommandInput(void* tCaller, void* tData) {
-	DreamMugenCommandInput* input = (DreamMugenCommandInput*)tData;
-	StaticMugenCommandInputCaller* caller = (StaticMugenCommandInputCaller*)tCaller;
+static void addStartingMugenCommandInputs(RegisteredMugenCommand* tRegisteredCommand, vector<int>& tInputs) {
+	for (size_t i = 0; i < tInputs.size(); i++) {
+		CompiledMugenCommandInput* input = &tRegisteredCommand->mCompiledCommands.mInputs[tInputs[i]];
+		if (!isCompiledStepActive(tRegisteredCommand, &tRegisteredCommand->mCompiledCommands.mSteps[input->mFirstStep])) continue;
+
+		tRegisteredCommand->mStartingInputs.push_back(tInputs[i]);
+	}
+}
 
-	DreamMugenCommandInputStep* firstStep = (DreamMugenCommandInputStep*)vector_get(&input->mInputSteps, 0);
+static void updateStaticMugenCommands(RegisteredMugenCommand* tCommand) {
+	CompiledMugenCommands* compiledCommands = &tCommand->mCompiledCommands;
+	tCommand->mStartingInputs.clear();
+	for (int i = 0; i < COMMAND_TARGET_BIT_AMOUNT; i++) {
+		if (tCommand->mPressedTargets & (1u << i)) addStartingMugenCommandInputs(tCommand, compiledCommands->mPressedStarts[i]);
+		if (tCommand->mReleasedTargets & (1u << i)) addStartingMugenCommandInputs(tCommand, compiledCommands->mReleasedStarts[i]);
+	}
+	addStartingMugenCommandInputs(tCommand, compiledCommands->mHeldStarts);
 
-	int mIsStepOver = 0;
-	int mIsActive = handleSingleCommandInputStepAndReturnIfActive(firstStep, &mIsStepOver, caller->mRegisteredCommand->mControllerID, caller->mRegisteredCommand->mIsFacingRight);
+	// inputs are started in definition order, so the last completed input of a command keeps deciding its buffer time
+	sort(tCommand->mStartingInputs.begin(), tCommand->mStartingInputs.end());
+	for (size_t i = 0; i < tCommand->mStartingInputs.size(); i++) {
+		addNewActiveMugenCommand(tCommand, tCommand->mStartingInputs[i]);
+	}
+}
 
-	if (!mIsActive) return;
+static void updateSingleCommandState(RegisteredMugenCommand* tRegisteredCommand, MugenCommandState* tState) {
+	if (!tState->mIsActive) return;
 
-	addNewActiveMugenCommand(input, caller->mRegisteredCommand, caller->mName, mIsStepOver);
+	if (tState->mNow >= tState->mBufferTime) {
+		setCommandStateInactive(tState);
+		tRegisteredCommand->mActivityStamp++;
+	}
+	tState->mNow++;
 }
 
-static void updateSingleStaticMugenCommand(RegisteredMugenCommand* tCaller, const string& tKey, DreamMugenCommand& tData) {
-	RegisteredMugenCommand* registeredCommand = (RegisteredMugenCommand*)tCaller;
-	DreamMugenCommand* command = &tData;
-	
-	InternalMugenCommandState* internalState = &registeredCommand->mInternalStates[tKey];
-	if (internalState->mIsBeingProcessed) return;
+static void updateCommandStates(RegisteredMugenCommand* tCommand) {
+	for (size_t i = 0; i < tCommand->tStates.mStates.size(); i++) {
+		updateSingleCommandState(tCommand, &tCommand->tStates.mStates[i]);
+	}
+}
+
+#define MASK_BUTTONS (MASK_A | MASK_B | MASK_C | MASK_X | MASK_Y | MASK_Z | MASK_START)
+#define MASK_DIRECTIONS (MASK_LEFT | MASK_RIGHT | MASK_UP | MASK_DOWN)
+
+static uint32_t getLiveInputMask(int i) {
+	uint32_t mask = 0;
+	if (hasPressedASingle(i)) mask |= MASK_A;
+	if (hasPressedBSingle(i)) mask |= MASK_B;
+	if (hasPressedRSingle(i)) mask |= MASK_C;
+	if (hasPressedXSingle(i)) mask |= MASK_X;
+	if (hasPressedYSingle(i)) mask |= MASK_Y;
+	if (hasPressedLSingle(i)) mask |= MASK_Z;
 
-	StaticMugenCommandInputCaller caller = {
-		registeredCommand,
-		tKey
-	};
-	vector_map(&command->mInputs, updateSingleStaticMugenCommandInput, &caller);
+	if (hasPressedStartSingle(i)) mask |= MASK_START;
+
+	if (hasPressedLeftSingle(i)) mask |= MASK_LEFT;
+	if (hasPressedRightSingle(i)) mask |= MASK_RIGHT;
+	if (hasPressedUpSingle(i)) mask |= MASK_UP;
+	if (hasPressedDownSingle(i)) mask |= MASK_DOWN;
+	return mask;
 }
 
-static void updateStaticMugenCommands(RegisteredMugenCommand* tCommand) {
-	stl_string_map_map(tCommand->tCommands->mCommands, updateSingleStaticMugenCommand, tCommand);
+static void updateInputMask(int i, uint32_t tInputMask) {
+	MugenCommandControllerInput* input = &gMugenCommandHandler.mControllerInputs[i];
+	input->mPreviousInputMask = input->mInputMask;
+	input->mInputMask = tInputMask;
+
+	int isButtonAllowed = getGameMode() != GAME_MODE_OSU || input->mOsuInputAllowedFlag;
+	input->mPreviousHeldMask = input->mHeldMask;
+	input->mHeldMask = isButtonAllowed ? tInputMask : (tInputMask & MASK_DIRECTIONS);
 }
 
-static void updateSingleCommandState(void* tCaller, const string& tKey, MugenCommandState& tData) {
-	(void)tCaller;
-	(void)tKey;
-	MugenCommandState* state = &tData;
-	if (!state->mIsActive) return;
+static void updateInputMasks() {
+	int amount = (int)gMugenCommandHandler.mControllerInputs.size();
+	int i;
+	if (isDreamInputPlaybackActive()) {
+		readDreamInputPlaybackFrame(gMugenCommandHandler.mFrameMasks.data(), amount);
+	}
+	else {
+		for (i = 0; i < amount; i++) {
+			gMugenCommandHandler.mFrameMasks[i] = getLiveInputMask(i);
+		}
+		if (isDreamInputRecordingActive()) {
+			recordDreamInputFrame(gMugenCommandHandler.mFrameMasks.data(), amount);
+		}
+	}
 
-	if (state->mNow >= state->mBufferTime) {
-		setCommandStateInactive(state);
+	for (i = 0; i < amount; i++) {
+		updateInputMask(i, gMugenCommandHandler.mFrameMasks[i]);
 	}
-	state->mNow++;
 }
 
-static void updateCommandStates(RegisteredMugenCommand* tCommand) {
-	stl_string_map_map(tCommand->tStates.mStates, updateSingleCommandState);
+static int hasControllerPressedFlank(int tControllerID, uint32_t tMask) {
+	MugenCommandControllerInput* input = getControllerInput(tControllerID);
+	return (input->mInputMask & ~input->mPreviousInputMask & tMask) != 0;
 }
 
-static void updateSingleInputMaskEntry(int i, uint32_t tMask, int tHoldValue) {
-	gMugenCommandHandler.mHeldMask[i] |= (tMask * min(tHoldValue, 1));
+int hasDreamControllerPressedStartFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_START);
 }
 
-static void updateInputMaskGeneral(int i, int tButtonPrecondition) {
-	gMugenCommandHandler.mPreviousHeldMask[i] = gMugenCommandHandler.mHeldMask[i];
-	gMugenCommandHandler.mHeldMask[i] = 0;
-
-	updateSingleInputMaskEntry(i, MASK_A, tButtonPrecondition && hasPressedASingle(i));
-	updateSingleInputMaskEntry(i, MASK_B, tButtonPrecondition && hasPressedBSingle(i));
-	updateSingleInputMaskEntry(i, MASK_C, tButtonPrecondition && hasPressedRSingle(i));
-	updateSingleInputMaskEntry(i, MASK_X, tButtonPrecondition && hasPressedXSingle(i));
-	updateSingleInputMaskEntry(i, MASK_Y, tButtonPrecondition && hasPressedYSingle(i));
-	updateSingleInputMaskEntry(i, MASK_Z, tButtonPrecondition && hasPressedLSingle(i));
+int hasDreamControllerPressedAFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_A);
+}
 
-	updateSingleInputMaskEntry(i, MASK_START, tButtonPrecondition && hasPressedStartSingle(i));
+int hasDreamControllerPressedBFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_B);
+}
 
-	updateSingleInputMaskEntry(i, MASK_LEFT, hasPressedLeftSingle(i));
-	updateSingleInputMaskEntry(i, MASK_RIGHT, hasPressedRightSingle(i));
-	updateSingleInputMaskEntry(i, MASK_UP, hasPressedUpSingle(i));
-	updateSingleInputMaskEntry(i, MASK_DOWN, hasPressedDownSingle(i));	
+int hasDreamControllerPressedXFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_X);
 }
 
-static void updateInputMask(int i) {
-	if (getGameMode() != GAME_MODE_OSU) {
-		updateInputMaskGeneral(i, 1);
-	}
-	else {
-		updateInputMaskGeneral(i, gMugenCommandHandler.mOsuInputAllowedFlag[i]);
-	}
+int hasDreamControllerPressedYFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_Y);
 }
 
-static void updateInputMasks() {
-	int i;
-	for (i = 0; i < 2; i++) {
-		updateInputMask(i);
-	}
+int hasDreamControllerPressedAnyButtonFlank(int tControllerID)
+{
+	return hasControllerPressedFlank(tControllerID, MASK_BUTTONS);
 }
 
 static void updateSingleRegisteredCommand(RegisteredMugenCommand& tData) {
 	RegisteredMugenCommand* command = &tData;
 
 	updateCommandStates(command);
+	updateCommandTargets(command);
 	updateActiveMugenCommands(command);
 	updateStaticMugenCommands(command);
 }
@@ -597,7 +696,7 @@ static void updateMugenCommandHandler(void* tData) {
 	(void)tData;
 	updateInputMasks();
 
-	for (int i = 0; i < gMugenCommandHandler.mRegisteredCommandAmount; i++) {
+	for (int i = 0; i < (int)gMugenCommandHandler.mRegisteredCommands.size(); i++) {
 		updateSingleRegisteredCommand(gMugenCommandHandler.mRegisteredCommands[i]);
 	}
 }
@@ -11,7 +11,10 @@ int registerDreamMugenCommands(int tControllerID, DreamMugenCommands* tCommands)
 int isDreamCommandActive(int tID, const char* tCommandName);
 int isDreamCommandActiveByLookupIndex(int tID, int tLookupIndex);
 int isDreamCommandForLookup(int tID, const char* tCommandName, int* oLookupIndex);
+int isDreamCommandForLookupInCommands(DreamMugenCommands* tCommands, const char* tCommandName, int* oLookupIndex);
+uint32_t getDreamCommandActivityStamp(int tID);
 void setDreamPlayerCommandActiveForAI(int tID, const char* tCommandName, int tBufferTime);
+void setDreamPlayerCommandActiveForAIByLookupIndex(int tID, int tLookupIndex, int tBufferTime);
 int setDreamPlayerCommandNumberActiveForDebug(int tID, int tCommandNumber);
 int getDreamPlayerCommandAmount(int tID);
 
@@ -20,4 +23,11 @@ void allowOsuPlayerCommandInputOneFrame(int tRootIndex);
 void resetOsuPlayerCommandInputAllowed(int tRootIndex);
 int isOsuPlayerCommandInputAllowed(int tRootIndex);
 
+int hasDreamControllerPressedStartFlank(int tControllerID);
+int hasDreamControllerPressedAFlank(int tControllerID);
+int hasDreamControllerPressedBFlank(int tControllerID);
+int hasDreamControllerPressedXFlank(int tControllerID);
+int hasDreamControllerPressedYFlank(int tControllerID);
+int hasDreamControllerPressedAnyButtonFlank(int tControllerID);
+
 ActorBlueprint getDreamMugenCommandHandler();
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 #include <prism/datastructures.h>
 #include <prism/animation.h>
+#include <prism/mugendefreader.h>
 
 typedef enum {
 	MUGEN_COMMAND_INPUT_STEP_TYPE_PRESS,
@@ -72,4 +73,5 @@ typedef struct {
 } DreamMugenCommands;
 
 DreamMugenCommands loadDreamMugenCommandFile(char* tPath);
+DreamMugenCommands loadDreamMugenCommandsFromScript(MugenDefScript* tScript);
 void unloadDreamMugenCommandFile(DreamMugenCommands* tCommands);
\ No newline at end of file
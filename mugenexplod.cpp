@@ -5,15 +5,18 @@
 #include <prism/datastructures.h>
 #include <prism/memoryhandler.h>
 #include <prism/mugenanimationhandler.h>
-#include <prism/physicshandler.h>
 #include <prism/log.h>
 #include <prism/system.h>
-#include <prism/stlutil.h>
 
 #include "fightui.h"
 #include "stage.h"
 #include "mugenstagehandler.h"
 
+#include <string.h>
+#include <map>
+#include <set>
+#include <vector>
+
 using namespace std;
 
 typedef struct {
@@ -30,13 +33,7 @@ typedef struct {
 	int mIsFlippedHorizontally;
 	int mIsFlippedVertically;
 
-	int mBindTime;
-
-	Velocity mVelocity;
-	Acceleration mAcceleration;
-
 	Vector3DI mRandomOffset;
-	int mRemoveTime = -2;
 	int mIsSuperMove;
 
 	int mSuperMoveTime;
@@ -58,33 +55,144 @@ typedef struct {
 	DreamExplodTransparencyType mTransparencyType;
 
 	int mIsFacingRight;
-	PhysicsHandlerElement* mPhysicsElement;
 	MugenAnimationHandlerElement* mAnimationElement;
-	int mNow;
 
 } Explod;
 
+#define INITIAL_EXPLOD_AMOUNT 64
+
+typedef pair<DreamPlayer*, int> ExplodIDKey;
 
 static struct {
-	map<int, Explod> mExplods;
+	vector<Explod> mExplods;
+
+	vector<Position> mPositions;
+	vector<Velocity> mVelocities;
+	vector<Acceleration> mAccelerations;
+	vector<int> mRemoveTimes;
+	vector<int> mNows;
+	vector<int> mBindTimes;
+	vector<uint8_t> mIsActive;
+	vector<uint8_t> mIsAdvancing;
+	vector<uint8_t> mIsExpired;
+
+	vector<int> mFreeSlots;
+	int mSlotAmount;
+
+	map<DreamPlayer*, set<int>> mPlayerExplods;
+	map<ExplodIDKey, set<int>> mPlayerIDExplods;
 } gMugenExplod;
 
+static void clearExplodIndices() {
+	gMugenExplod.mPlayerExplods.clear();
+	gMugenExplod.mPlayerIDExplods.clear();
+}
+
+static void explodAnimationFinishedCB(void* tCaller);
+
+static void resizeExplodPool(int tAmount) {
+	gMugenExplod.mExplods.resize(tAmount);
+	gMugenExplod.mPositions.resize(tAmount);
+	gMugenExplod.mVelocities.resize(tAmount);
+	gMugenExplod.mAccelerations.resize(tAmount);
+	gMugenExplod.mRemoveTimes.resize(tAmount);
+	gMugenExplod.mNows.resize(tAmount);
+	gMugenExplod.mBindTimes.resize(tAmount);
+	gMugenExplod.mIsActive.resize(tAmount);
+	gMugenExplod.mIsAdvancing.resize(tAmount);
+	gMugenExplod.mIsExpired.resize(tAmount);
+}
+
+// the animations point into the pool, so they are moved along whenever it grows
+static void growExplodPool() {
+	const int previousAmount = (int)gMugenExplod.mExplods.size();
+	const int amount = previousAmount ? previousAmount * 2 : INITIAL_EXPLOD_AMOUNT;
+	resizeExplodPool(amount);
+
+	int i;
+	for (i = amount - 1; i >= previousAmount; i--) {
+		gMugenExplod.mFreeSlots.push_back(i);
+	}
+	for (i = 0; i < gMugenExplod.mSlotAmount; i++) {
+		Explod* e = &gMugenExplod.mExplods[i];
+		if (!gMugenExplod.mIsActive[i] || !e->mAnimationElement) continue;
+		setMugenAnimationBasePosition(e->mAnimationElement, &gMugenExplod.mPositions[i]);
+		setMugenAnimationCallback(e->mAnimationElement, explodAnimationFinishedCB, e);
+	}
+}
+
+static void resetExplodPool() {
+	resizeExplodPool(0);
+	gMugenExplod.mFreeSlots.clear();
+	gMugenExplod.mSlotAmount = 0;
+	clearExplodIndices();
+}
+
 static void loadExplods(void* tData) {
 	(void)tData;
-	gMugenExplod.mExplods.clear();
+	resetExplodPool();
 }
 
 static void unloadExplods(void* tData) {
 	(void)tData;
-	gMugenExplod.mExplods.clear();
+	resetExplodPool();
+}
+
+static void addExplodToIndices(Explod* e) {
+	gMugenExplod.mPlayerExplods[e->mPlayer].insert(e->mInternalID);
+	gMugenExplod.mPlayerIDExplods[ExplodIDKey(e->mPlayer, e->mExternalID)].insert(e->mInternalID);
+}
+
+static void removeExplodFromIndices(Explod* e) {
+	auto playerIt = gMugenExplod.mPlayerExplods.find(e->mPlayer);
+	playerIt->second.erase(e->mInternalID);
+	if (playerIt->second.empty()) {
+		gMugenExplod.mPlayerExplods.erase(playerIt);
+	}
+
+	auto idIt = gMugenExplod.mPlayerIDExplods.find(ExplodIDKey(e->mPlayer, e->mExternalID));
+	idIt->second.erase(e->mInternalID);
+	if (idIt->second.empty()) {
+		gMugenExplod.mPlayerIDExplods.erase(idIt);
+	}
+}
+
+static const set<int>* getPlayerExplods(DreamPlayer* tPlayer) {
+	auto it = gMugenExplod.mPlayerExplods.find(tPlayer);
+	return it == gMugenExplod.mPlayerExplods.end() ? NULL : &it->second;
+}
+
+static const set<int>* getPlayerExplodsWithID(DreamPlayer* tPlayer, int tExplodID) {
+	auto it = gMugenExplod.mPlayerIDExplods.find(ExplodIDKey(tPlayer, tExplodID));
+	return it == gMugenExplod.mPlayerIDExplods.end() ? NULL : &it->second;
 }
 
 int addExplod(DreamPlayer* tPlayer)
 {
-	int id = stl_int_map_push_back(gMugenExplod.mExplods, Explod());
+	if (gMugenExplod.mFreeSlots.empty()) {
+		growExplodPool();
+	}
+
+	int id = gMugenExplod.mFreeSlots.back();
+	gMugenExplod.mFreeSlots.pop_back();
 	Explod& e = gMugenExplod.mExplods[id];
+	e = Explod();
 	e.mPlayer = tPlayer;
 	e.mInternalID = id;
+
+	gMugenExplod.mPositions[id] = makePosition(0, 0, 0);
+	gMugenExplod.mVelocities[id] = makePosition(0, 0, 0);
+	gMugenExplod.mAccelerations[id] = makePosition(0, 0, 0);
+	gMugenExplod.mRemoveTimes[id] = -2;
+	gMugenExplod.mNows[id] = 0;
+	gMugenExplod.mBindTimes[id] = 0;
+	gMugenExplod.mIsActive[id] = 1;
+	gMugenExplod.mIsAdvancing[id] = 0;
+	gMugenExplod.mIsExpired[id] = 0;
+	if (id >= gMugenExplod.mSlotAmount) {
+		gMugenExplod.mSlotAmount = id + 1;
+	}
+	addExplodToIndices(&e);
 	return e.mInternalID;
 }
 
@@ -98,7 +206,9 @@ void setExplodAnimation(int tID, int tIsInFightDefFile, int tAnimationNumber)
 void setExplodID(int tID, int tExternalID)
 {
 	Explod* e = &gMugenExplod.mExplods[tID];
+	removeExplodFromIndices(e);
 	e->mExternalID = tExternalID;
+	addExplodToIndices(e);
 }
 
 void setExplodPosition(int tID, int tOffsetX, int tOffsetY)
@@ -127,20 +237,17 @@ void setExplodVerticalFacing(int tID, int tFacing)
 
 void setExplodBindTime(int tID, int tBindTime)
 {
-	Explod* e = &gMugenExplod.mExplods[tID];
-	e->mBindTime = tBindTime;
+	gMugenExplod.mBindTimes[tID] = tBindTime;
 }
 
 void setExplodVelocity(int tID, double tX, double tY)
 {
-	Explod* e = &gMugenExplod.mExplods[tID];
-	e->mVelocity = makePosition(tX, tY, 0);
+	gMugenExplod.mVelocities[tID] = makePosition(tX, tY, 0);
 }
 
 void setExplodAcceleration(int tID, double tX, double tY)
 {
-	Explod* e = &gMugenExplod.mExplods[tID];
-	e->mAcceleration = makePosition(tX, tY, 0);
+	gMugenExplod.mAccelerations[tID] = makePosition(tX, tY, 0);
 }
 
 void setExplodRandomOffset(int tID, int tX, int tY)
@@ -151,8 +258,7 @@ void setExplodRandomOffset(int tID, int tX, int tY)
 
 void setExplodRemoveTime(int tID, int tRemoveTime)
 {
-	Explod* e = &gMugenExplod.mExplods[tID];
-	e->mRemoveTime = tRemoveTime;
+	gMugenExplod.mRemoveTimes[tID] = tRemoveTime;
 }
 
 void setExplodSuperMove(int tID, int tIsSuperMove)
@@ -222,8 +328,6 @@ void setExplodTransparencyType(int tID, int tHasTransparencyType, DreamExplodTra
 	e->mTransparencyType = tTransparencyType;
 }
 
-static void explodAnimationFinishedCB(void* tCaller);
-
 static Position getFinalExplodPositionFromPositionType(DreamExplodPositionType tPositionType, Position mOffset, DreamPlayer* tPlayer) {
 	if (tPositionType == EXPLOD_POSITION_TYPE_RELATIVE_TO_P1) {
 		DreamPlayer* target = tPlayer;
@@ -301,165 +405,113 @@ void finalizeExplod(int tID)
 		e->mIsFacingRight = 1;
 	}
 
-	e->mPhysicsElement = addToPhysicsHandler(makePosition(0, 0, 0));
-
+	int slot = e->mInternalID;
+	gMugenExplod.mPositions[slot] = makePosition(0, 0, 0);
 	if (!e->mIsFacingRight) {
-		e->mVelocity.x = -e->mVelocity.x;
-		e->mAcceleration.x = -e->mAcceleration.x;
+		gMugenExplod.mVelocities[slot].x = -gMugenExplod.mVelocities[slot].x;
+		gMugenExplod.mAccelerations[slot].x = -gMugenExplod.mAccelerations[slot].x;
 		e->mIsFlippedHorizontally = !e->mIsFlippedHorizontally;
 	}
-	addAccelerationToHandledPhysics(e->mPhysicsElement, e->mVelocity);
 
 	Position p = getDreamStageCoordinateSystemOffset(getPlayerCoordinateP(e->mPlayer)) + getFinalExplodPositionFromPositionType(e->mPositionType, e->mPosition, e->mPlayer);
 	p.z = PLAYER_Z + 1 * e->mSpritePriority;
 	e->mAnimationElement = addMugenAnimation(animation, sprites, p);
-	setMugenAnimationBasePosition(e->mAnimationElement, getHandledPhysicsPositionReference(e->mPhysicsElement));
+	setMugenAnimationBasePosition(e->mAnimationElement, &gMugenExplod.mPositions[slot]);
 	setMugenAnimationCameraPositionReference(e->mAnimationElement, getDreamMugenStageHandlerCameraPositionReference());
 	setMugenAnimationCallback(e->mAnimationElement, explodAnimationFinishedCB, e);
 	setMugenAnimationFaceDirection(e->mAnimationElement, !e->mIsFlippedHorizontally);
 	setMugenAnimationVerticalFaceDirection(e->mAnimationElement, !e->mIsFlippedVertically);
 	setMugenAnimationDrawScale(e->mAnimationElement, e->mScale);
 
-	e->mNow = 0;
+	gMugenExplod.mNows[slot] = 0;
 }
 
 
 static void unloadExplod(Explod* e) {
 	removeMugenAnimation(e->mAnimationElement);
-	removeFromPhysicsHandler(e->mPhysicsElement);
 }
 
-typedef struct {
-	DreamPlayer* mPlayer;
-	int mExplodID;
-
-} RemoveExplodsCaller;
+static void freeExplodSlot(int tSlot) {
+	gMugenExplod.mIsActive[tSlot] = 0;
+	gMugenExplod.mIsAdvancing[tSlot] = 0;
+	gMugenExplod.mIsExpired[tSlot] = 0;
+	gMugenExplod.mVelocities[tSlot] = makePosition(0, 0, 0);
+	gMugenExplod.mAccelerations[tSlot] = makePosition(0, 0, 0);
+	gMugenExplod.mFreeSlots.push_back(tSlot);
 
-
-static int removeSingleExplodWithID(RemoveExplodsCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer == tCaller->mPlayer && e->mExternalID == tCaller->mExplodID) {
-		unloadExplod(e);
-		return 1;
+	while (gMugenExplod.mSlotAmount > 0 && !gMugenExplod.mIsActive[gMugenExplod.mSlotAmount - 1]) {
+		gMugenExplod.mSlotAmount--;
 	}
-
-	return 0;
 }
 
-void removeExplodsWithID(DreamPlayer * tPlayer, int tExplodID)
-{
-	RemoveExplodsCaller caller;
-	caller.mPlayer = tPlayer;
-	caller.mExplodID = tExplodID;
-	stl_int_map_remove_predicate(gMugenExplod.mExplods, removeSingleExplodWithID, &caller);
+static void removeExplodSlot(int tSlot) {
+	Explod* e = &gMugenExplod.mExplods[tSlot];
+	unloadExplod(e);
+	removeExplodFromIndices(e);
+	freeExplodSlot(tSlot);
 }
 
-static int removeSingleExplod(RemoveExplodsCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer == tCaller->mPlayer) {
-		unloadExplod(e);
-		return 1;
+static void removeExplodsInSet(set<int> tIDs) {
+	set<int>::iterator it;
+	for (it = tIDs.begin(); it != tIDs.end(); it++) {
+		removeExplodSlot(*it);
 	}
-
-	return 0;
 }
 
-void removeAllExplodsForPlayer(DreamPlayer * tPlayer)
+void removeExplodsWithID(DreamPlayer * tPlayer, int tExplodID)
 {
-	RemoveExplodsCaller caller;
-	caller.mPlayer = tPlayer;
-	stl_int_map_remove_predicate(gMugenExplod.mExplods, removeSingleExplod, &caller);
+	const set<int>* explods = getPlayerExplodsWithID(tPlayer, tExplodID);
+	if (!explods) return;
+	removeExplodsInSet(*explods);
 }
 
-static int removeSingleExplodAlways(void* /*tCaller*/, Explod& tData) {
-	Explod* e = &tData;
-
-	unloadExplod(e);
-	return 1;
+void removeAllExplodsForPlayer(DreamPlayer * tPlayer)
+{
+	const set<int>* explods = getPlayerExplods(tPlayer);
+	if (!explods) return;
+	removeExplodsInSet(*explods);
 }
 
 void removeAllExplods()
 {
-	stl_int_map_remove_predicate(gMugenExplod.mExplods, removeSingleExplodAlways);
-}
-
-typedef struct {
-	DreamPlayer* mPlayer;
-	int mExplodID;
-	int mReturnValue;
-} FindExplodCaller;
-
-void compareSingleExplodIDToSearchID(FindExplodCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer == tCaller->mPlayer && e->mExternalID == tCaller->mExplodID) {
-		tCaller->mReturnValue = e->mInternalID;
+	int i;
+	for (i = 0; i < gMugenExplod.mSlotAmount; i++) {
+		if (!gMugenExplod.mIsActive[i]) continue;
+		unloadExplod(&gMugenExplod.mExplods[i]);
 	}
+	resetExplodPool();
 }
 
 int getExplodIndexFromExplodID(DreamPlayer* tPlayer, int tExplodID)
 {
-	FindExplodCaller caller;
-	caller.mPlayer = tPlayer;
-	caller.mExplodID = tExplodID;
-	caller.mReturnValue = -1;
-
-	stl_int_map_map(gMugenExplod.mExplods, compareSingleExplodIDToSearchID, &caller);
-
-	return caller.mReturnValue;
-}
-
-
-void compareSingleAmountSearchPlayer(FindExplodCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer == tCaller->mPlayer) {
-		tCaller->mReturnValue++;
-	}
+	const set<int>* explods = getPlayerExplodsWithID(tPlayer, tExplodID);
+	if (!explods) return -1;
+	return *explods->rbegin();
 }
 
 int getExplodAmount(DreamPlayer * tPlayer)
 {
-	FindExplodCaller caller;
-	caller.mPlayer = tPlayer;
-	caller.mReturnValue = 0;
-
-	stl_int_map_map(gMugenExplod.mExplods, compareSingleAmountSearchPlayer, &caller);
-
-	return caller.mReturnValue;
-}
-
-void compareSingleAmountSearchExplodIDToSearchID(FindExplodCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer == tCaller->mPlayer && e->mExternalID == tCaller->mExplodID) {
-		tCaller->mReturnValue++;
-	}
+	const set<int>* explods = getPlayerExplods(tPlayer);
+	return explods ? (int)explods->size() : 0;
 }
 
 int getExplodAmountWithID(DreamPlayer * tPlayer, int tID)
 {
-	FindExplodCaller caller;
-	caller.mPlayer = tPlayer;
-	caller.mExplodID = tID;
-	caller.mReturnValue = 0;
-
-	stl_int_map_map(gMugenExplod.mExplods, compareSingleAmountSearchExplodIDToSearchID, &caller);
-
-	return caller.mReturnValue;
+	const set<int>* explods = getPlayerExplodsWithID(tPlayer, tID);
+	return explods ? (int)explods->size() : 0;
 }
 
 static void explodAnimationFinishedCB(void* tCaller) {
 	Explod* e = (Explod*)tCaller;
-	if (e->mRemoveTime != -2) return;
+	int* removeTime = &gMugenExplod.mRemoveTimes[e->mInternalID];
+	if (*removeTime != -2) return;
 
-	e->mRemoveTime = 0;
+	*removeTime = 0;
 }
 
 static void updateExplodBindTime(Explod* e) {
-	if (e->mBindTime <= 0) return;
+	int* bindTime = &gMugenExplod.mBindTimes[e->mInternalID];
+	if (*bindTime <= 0) return;
 
 	if (!isPlayer(e->mPlayer)) {
 		return;
@@ -469,19 +521,7 @@ static void updateExplodBindTime(Explod* e) {
 	pos.z = PLAYER_Z + 1 * e->mSpritePriority;
 	setMugenAnimationPosition(e->mAnimationElement, pos);
 
-	e->mBindTime--;
-}
-
-
-static int updateExplodRemoveTime(Explod* e) {
-	if (e->mRemoveTime < 0) return 0;
-
-	e->mNow++;
-	return e->mNow >= e->mRemoveTime;
-}
-
-static void updateExplodPhysics(Explod* e) {
-	addAccelerationToHandledPhysics(e->mPhysicsElement, e->mAcceleration);
+	(*bindTime)--;
 }
 
 static void updateStaticExplodPosition(Explod* e) {
@@ -492,51 +532,69 @@ static void updateStaticExplodPosition(Explod* e) {
 	}
 }
 
-static int updateSingleExplod(void* tCaller, Explod& tData) {
-	(void)tCaller;
-	Explod* e = &tData;
-	updateStaticExplodPosition(e);
-	if (isPlayerPaused(e->mPlayer)) return 0;
-
-	updateExplodBindTime(e);
-	if (updateExplodRemoveTime(e)) {
-		unloadExplod(e);
-		return 1;
+static void updateExplodsWithPlayerState() {
+	int i;
+	for (i = 0; i < gMugenExplod.mSlotAmount; i++) {
+		if (!gMugenExplod.mIsActive[i]) continue;
+		Explod* e = &gMugenExplod.mExplods[i];
+		updateStaticExplodPosition(e);
+		gMugenExplod.mIsAdvancing[i] = !isPlayerPaused(e->mPlayer);
+		if (gMugenExplod.mIsAdvancing[i]) {
+			updateExplodBindTime(e);
+		}
 	}
+}
 
-	updateExplodPhysics(e);
+// branch-free over the whole pool, free slots have no velocity and never advance
+static void updateExplodPhysicsAndRemoveTimes() {
+	const int amount = gMugenExplod.mSlotAmount;
+	Position* positions = gMugenExplod.mPositions.data();
+	Velocity* velocities = gMugenExplod.mVelocities.data();
+	const Acceleration* accelerations = gMugenExplod.mAccelerations.data();
+	const int* removeTimes = gMugenExplod.mRemoveTimes.data();
+	int* nows = gMugenExplod.mNows.data();
+	const uint8_t* isAdvancing = gMugenExplod.mIsAdvancing.data();
+	uint8_t* isExpired = gMugenExplod.mIsExpired.data();
+
+	int i;
+	for (i = 0; i < amount; i++) {
+		const int isCounting = isAdvancing[i] & (removeTimes[i] >= 0);
+		nows[i] += isCounting;
+		isExpired[i] = (uint8_t)(isCounting & (nows[i] >= removeTimes[i]));
+
+		const double accelerationFactor = (double)(isAdvancing[i] & !isExpired[i]);
+		velocities[i].x += accelerations[i].x * accelerationFactor;
+		velocities[i].y += accelerations[i].y * accelerationFactor;
+		positions[i].x += velocities[i].x;
+		positions[i].y += velocities[i].y;
+	}
+}
 
-	return 0;
+static void removeExpiredExplods() {
+	int i;
+	for (i = gMugenExplod.mSlotAmount - 1; i >= 0; i--) {
+		if (!gMugenExplod.mIsExpired[i]) continue;
+		removeExplodSlot(i);
+	}
 }
 
 static void updateExplods(void* /*tData*/) {
-	stl_int_map_remove_predicate(gMugenExplod.mExplods, updateSingleExplod);
+	updateExplodsWithPlayerState();
+	updateExplodPhysicsAndRemoveTimes();
+	removeExpiredExplods();
 }
 
 ActorBlueprint getDreamExplodHandler() {
 	return makeActorBlueprint(loadExplods, unloadExplods, updateExplods);
 }
 
-typedef struct {
-	DreamPlayer* mPlayer;
-	int mID;
-	int mBindTime;
-} BindTimeSetterForIDCaller;
-
-static void setExplodBindTimeForSingleExplod(BindTimeSetterForIDCaller* tCaller, Explod& tData) {
-	Explod* e = &tData;
-
-	if (e->mPlayer != tCaller->mPlayer) return;
-	if (tCaller->mID != -1 && e->mExternalID != tCaller->mID) return;
-
-	e->mBindTime = tCaller->mBindTime;
-}
-
 void setExplodBindTimeForID(DreamPlayer * tPlayer, int tExplodID, int tBindTime)
 {
-	BindTimeSetterForIDCaller caller;
-	caller.mPlayer = tPlayer;
-	caller.mID = tExplodID;
-	caller.mBindTime = tBindTime;
-	stl_int_map_map(gMugenExplod.mExplods, setExplodBindTimeForSingleExplod, &caller);
+	const set<int>* explods = tExplodID == -1 ? getPlayerExplods(tPlayer) : getPlayerExplodsWithID(tPlayer, tExplodID);
+	if (!explods) return;
+
+	set<int>::const_iterator it;
+	for (it = explods->begin(); it != explods->end(); it++) {
+		gMugenExplod.mBindTimes[*it] = tBindTime;
+	}
 }
@@ -10,6 +10,7 @@
 
 #include "osuhandler.h"
 #include "gamelogic.h"
+#include "fileindex.h"
 
 using namespace std;
 
@@ -72,7 +73,7 @@ int isMugenBGMMusicPath(const char* tPath, const char* tStagePath) {
 
 	char inFolderPath[1024];
 	sprintf(inFolderPath, "assets/music/%s", tPath);
-	if (isFile(inFolderPath)) return 1;
+	if (isIndexedFile(inFolderPath)) return 1;
 
 	if (*tStagePath) {
 		string s;
@@ -81,10 +82,10 @@ int isMugenBGMMusicPath(const char* tPath, const char* tStagePath) {
 			s = string(tStagePath, size_t(folderEnd - tStagePath + 1));
 		}
 		sprintf(inFolderPath, "%s%s", s.data(), tPath);
-		if (isFile(inFolderPath)) return 1;
+		if (isIndexedFile(inFolderPath)) return 1;
 	}
 
-	return isFile(tPath);
+	return isIndexedFile(tPath);
 }
 
 void playMugenBGMMusicPath(const char * tPath, int tIsLooping)
@@ -131,7 +132,7 @@ void playMugenBGMMusicPath(const char* tPath, const char* tStagePath, int tIsLoo
 
 	char inFolderPath[1024];
 	sprintf(inFolderPath, "assets/music/%s", tPath); 
-	if (isFile(inFolderPath)) {
+	if (isIndexedFile(inFolderPath)) {
 		playMugenBGMMusicCompletePath(inFolderPath, tIsLooping);
 		return;
 	}
@@ -143,7 +144,7 @@ void playMugenBGMMusicPath(const char* tPath, const char* tStagePath, int tIsLoo
 			s = string(tStagePath, size_t(folderEnd - tStagePath + 1));
 		}
 		sprintf(inFolderPath, "%s%s", s.data(), tPath);
-		if (isFile(inFolderPath)) {
+		if (isIndexedFile(inFolderPath)) {
 			playMugenBGMMusicCompletePath(inFolderPath, tIsLooping);
 			return;
 		}
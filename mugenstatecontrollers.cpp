@@ -1,6 +1,7 @@
 #include "mugenstatecontrollers.h"
 
 #include <assert.h>
+#include <stddef.h>
 #include <string.h>
 #include <stdio.h>
 #include <string>
@@ -40,11 +41,15 @@ using namespace std;
 typedef void(*StateControllerParseFunction)(DreamMugenStateController*, MugenDefScriptGroup*);
 typedef int(*StateControllerHandleFunction)(DreamMugenStateController*, DreamPlayer*); // return 1 iff state changed
 typedef void(*StateControllerUnloadFunction)(DreamMugenStateController*);
+typedef void(*StateControllerCacheWriteFunction)(DreamCharacterCacheImage*, uint32_t, DreamMugenStateController*);
+
+#define STATE_CONTROLLER_TYPE_TABLE_SIZE 256
 
 static struct {
 	map<string, StateControllerParseFunction> mStateControllerParsers; 
-	map<int, StateControllerHandleFunction> mStateControllerHandlers;
-	map<int, StateControllerUnloadFunction> mStateControllerUnloaders; 
+	StateControllerHandleFunction mStateControllerHandlers[STATE_CONTROLLER_TYPE_TABLE_SIZE];
+	StateControllerUnloadFunction mStateControllerUnloaders[STATE_CONTROLLER_TYPE_TABLE_SIZE];
+	StateControllerCacheWriteFunction mStateControllerCacheWriters[STATE_CONTROLLER_TYPE_TABLE_SIZE];
 	MemoryStack* mMemoryStack;
 } gMugenStateControllerVariableHandler;
 
@@ -90,6 +95,8 @@ static int parseNumberedTriggerAndReturnIfFound(int i, DreamMugenAssignment** tR
 	return parseTriggerAndReturnIfFound(name, tRoot, tGroup);
 }
 
+int gCachedTriggerAmount;
+
 static void parseStateControllerTriggers(DreamMugenStateController* tController, MugenDefScriptGroup* tGroup) {
 	DreamMugenAssignment* allRoot = NULL;
 	parseTriggerAndReturnIfFound("triggerall", &allRoot, tGroup);
@@ -102,7 +109,11 @@ static void parseStateControllerTriggers(DreamMugenStateController* tController,
 	if (!root) {
 		root = makeDreamTrueMugenAssignment();
 	}
+	compileDreamAssignment(&root);
 	tController->mTrigger.mAssignment = root;
+	tController->mTrigger.mDependencies = getDreamAssignmentDependencies(&root);
+	tController->mTrigger.mCachedOwner = NULL;
+	if (!(tController->mTrigger.mDependencies & MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED)) gCachedTriggerAmount++;
 }
 
 static void* allocMemoryOnMemoryStackOrMemory(uint32_t tSize) {
@@ -2398,19 +2409,16 @@ static void parseStateControllerPersistence(DreamMugenStateController* tControll
 
 int gDebugStateControllerAmount;
 
-DreamMugenStateController * parseDreamMugenStateControllerFromGroup(MugenDefScriptGroup* tGroup)
+void parseDreamMugenStateControllerFromGroup(DreamMugenStateController* oController, MugenDefScriptGroup* tGroup)
 {
-	DreamMugenStateController* ret = (DreamMugenStateController*)allocMemoryOnMemoryStackOrMemory(sizeof(DreamMugenStateController));
 	gDebugStateControllerAmount++;
-	parseStateControllerType(ret, tGroup);
-	parseStateControllerTriggers(ret, tGroup);
-	parseStateControllerPersistence(ret, tGroup);
-
-	return ret;
+	parseStateControllerType(oController, tGroup);
+	parseStateControllerTriggers(oController, tGroup);
+	parseStateControllerPersistence(oController, tGroup);
 }
 
 static void unloadStateControllerType(DreamMugenStateController* tController) {
-	if (!stl_map_contains(gMugenStateControllerVariableHandler.mStateControllerUnloaders, (int)tController->mType)) {
+	if (!gMugenStateControllerVariableHandler.mStateControllerUnloaders[tController->mType]) {
 		logWarningFormat("Unable to determine state controller type %d. Defaulting to null.", tController->mType);
 		tController->mType = MUGEN_STATE_CONTROLLER_TYPE_NULL;
 	}
@@ -4699,12 +4707,12 @@ static int handleProjectile(DreamMugenStateController* tController, DreamPlayer*
 int handleDreamMugenStateControllerAndReturnWhetherStateChanged(DreamMugenStateController * tController, DreamPlayer* tPlayer)
 {
 
-	if (!stl_map_contains(gMugenStateControllerVariableHandler.mStateControllerHandlers, (int)tController->mType)) {
+	StateControllerHandleFunction func = gMugenStateControllerVariableHandler.mStateControllerHandlers[tController->mType];
+	if (!func) {
 		logWarningFormat("Unrecognized state controller %d. Ignoring.", tController->mType);
 		return 0;
 	}
 
-	StateControllerHandleFunction func = gMugenStateControllerVariableHandler.mStateControllerHandlers[tController->mType];
 	return func(tController, tPlayer);
 }
 
@@ -5122,7 +5130,7 @@ int widthHandleFunction(DreamMugenStateController* tController, DreamPlayer* tPl
 
 
 static void setupStateControllerHandlers() {
-	gMugenStateControllerVariableHandler.mStateControllerHandlers.clear();
+	memset(gMugenStateControllerVariableHandler.mStateControllerHandlers, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerHandlers));
 
 	gMugenStateControllerVariableHandler.mStateControllerHandlers[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE] = afterImageHandleFunction;
 	gMugenStateControllerVariableHandler.mStateControllerHandlers[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE_TIME] = afterImageTimeHandleFunction;
@@ -5498,7 +5506,7 @@ void victoryQuoteUnloadFunction(DreamMugenStateController* tController) { unload
 void widthUnloadFunction(DreamMugenStateController* tController) { unloadWidthController(tController); }
 
 static void setupStateControllerUnloaders() {
-	gMugenStateControllerVariableHandler.mStateControllerUnloaders.clear();
+	memset(gMugenStateControllerVariableHandler.mStateControllerUnloaders, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerUnloaders));
 
 	gMugenStateControllerVariableHandler.mStateControllerUnloaders[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE] = afterImageUnloadFunction;
 	gMugenStateControllerVariableHandler.mStateControllerUnloaders[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE_TIME] = afterImageTimeUnloadFunction;
@@ -5591,13 +5599,752 @@ static void setupStateControllerUnloaders() {
 	gMugenStateControllerVariableHandler.mStateControllerUnloaders[MUGEN_STATE_CONTROLLER_TYPE_WIDTH] = widthUnloadFunction;
 }
 
+static uint32_t addStateControllerCacheImageData(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, void* tData, uint32_t tSize) {
+	setDreamCharacterCacheImagePointer(tImage, tControllerOffset + offsetof(DreamMugenStateController, mData), tData);
+	int isNew;
+	return addDreamCharacterCacheImageBlock(tImage, tData, tSize, &isNew);
+}
+
+static void writeMugenDefStringVectorCacheImage(DreamCharacterCacheImage* tImage, uint32_t tOffset, MugenStringVector* tVector, int tHasValue) {
+	if (!tHasValue || tVector->mSize <= 0) {
+		clearDreamCharacterCacheImageBytes(tImage, tOffset, sizeof(MugenStringVector));
+		return;
+	}
+
+	setDreamCharacterCacheImagePointer(tImage, tOffset + offsetof(MugenStringVector, mElement), tVector->mElement);
+	int isNew;
+	const uint32_t elementOffset = addDreamCharacterCacheImageBlock(tImage, tVector->mElement, sizeof(char*) * tVector->mSize, &isNew);
+	int i;
+	for (i = 0; i < tVector->mSize; i++) {
+		setDreamCharacterCacheImageString(tImage, elementOffset + i * sizeof(char*), tVector->mElement[i]);
+	}
+}
+
+static void writeHitDefinitionCacheImage(DreamCharacterCacheImage* tImage, uint32_t tOffset, HitDefinitionController* e) {
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAttribute), e->mAttribute);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mHitFlag), e->mHitFlag);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardFlag), e->mGuardFlag);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAffectTeam), e->mAffectTeam);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAnimationType), e->mAnimationType);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirAnimationType), e->mAirAnimationType);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallAnimationType), e->mFallAnimationType);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPriority), e->mPriority);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mDamage), e->mDamage);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPauseTime), e->mPauseTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardPauseTime), e->mGuardPauseTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mSparkNumber), e->mSparkNumber);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardSparkNumber), e->mGuardSparkNumber);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mSparkXY), e->mSparkXY);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mHitSound), e->mHitSound);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardSound), e->mGuardSound);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGroundType), e->mGroundType);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirType), e->mAirType);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGroundSlideTime), e->mGroundSlideTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardSlideTime), e->mGuardSlideTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGroundHitTime), e->mGroundHitTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardHitTime), e->mGuardHitTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirHitTime), e->mAirHitTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardControlTime), e->mGuardControlTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardDistance), e->mGuardDistance);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mYAccel), e->mYAccel);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGroundVelocity), e->mGroundVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardVelocity), e->mGuardVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirVelocity), e->mAirVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirGuardVelocity), e->mAirGuardVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGroundCornerPushVelocityOffset), e->mGroundCornerPushVelocityOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirCornerPushVelocityOffset), e->mAirCornerPushVelocityOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mDownCornerPushVelocityOffset), e->mDownCornerPushVelocityOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardCornerPushVelocityOffset), e->mGuardCornerPushVelocityOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirGuardCornerPushVelocityOffset), e->mAirGuardCornerPushVelocityOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirGuardControlTime), e->mAirGuardControlTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirJuggle), e->mAirJuggle);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mMinimumDistance), e->mMinimumDistance);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mMaximumDistance), e->mMaximumDistance);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mSnap), e->mSnap);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayerSpritePriority1), e->mPlayerSpritePriority1);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayerSpritePriority2), e->mPlayerSpritePriority2);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer1ChangeFaceDirection), e->mPlayer1ChangeFaceDirection);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer1ChangeFaceDirectionRelativeToPlayer2), e->mPlayer1ChangeFaceDirectionRelativeToPlayer2);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer2ChangeFaceDirectionRelativeToPlayer1), e->mPlayer2ChangeFaceDirectionRelativeToPlayer1);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer1StateNumber), e->mPlayer1StateNumber);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer2StateNumber), e->mPlayer2StateNumber);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPlayer2CapableOfGettingPlayer1State), e->mPlayer2CapableOfGettingPlayer1State);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mForceStanding), e->mForceStanding);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFall), e->mFall);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallXVelocity), e->mFallXVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallYVelocity), e->mFallYVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallCanBeRecovered), e->mFallCanBeRecovered);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallRecoveryTime), e->mFallRecoveryTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallDamage), e->mFallDamage);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mAirFall), e->mAirFall);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mForceNoFall), e->mForceNoFall);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mDownVelocity), e->mDownVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mDownHitTime), e->mDownHitTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mDownBounce), e->mDownBounce);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mHitID), e->mHitID);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mChainID), e->mChainID);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mNoChainID), e->mNoChainID);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mHitOnce), e->mHitOnce);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mKill), e->mKill);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGuardKill), e->mGuardKill);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallKill), e->mFallKill);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mNumberOfHits), e->mNumberOfHits);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGetPower), e->mGetPower);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mGivePower), e->mGivePower);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPaletteEffectTime), e->mPaletteEffectTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPaletteEffectMultiplication), e->mPaletteEffectMultiplication);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mPaletteEffectAddition), e->mPaletteEffectAddition);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mEnvironmentShakeTime), e->mEnvironmentShakeTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mEnvironmentShakeFrequency), e->mEnvironmentShakeFrequency);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mEnvironmentShakeAmplitude), e->mEnvironmentShakeAmplitude);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mEnvironmentShakePhase), e->mEnvironmentShakePhase);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallEnvironmentShakeTime), e->mFallEnvironmentShakeTime);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallEnvironmentShakeFrequency), e->mFallEnvironmentShakeFrequency);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallEnvironmentShakeAmplitude), e->mFallEnvironmentShakeAmplitude);
+	writeDreamMugenAssignmentCacheImage(tImage, tOffset + offsetof(HitDefinitionController, mFallEnvironmentShakePhase), e->mFallEnvironmentShakePhase);
+}
+
+static void writeAfterImageControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	AfterImageController* e = (AfterImageController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(AfterImageController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mLength), e->mLength);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalColor), e->mPalColor);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalInvertAll), e->mPalInvertAll);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalBright), e->mPalBright);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalContrast), e->mPalContrast);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalPostBright), e->mPalPostBright);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalAdd), e->mPalAdd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mPalMul), e->mPalMul);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mTimeGap), e->mTimeGap);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mFrameGap), e->mFrameGap);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageController, mTrans), e->mTrans);
+}
+
+static void writeAfterImageTimeControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	AfterImageTimeController* e = (AfterImageTimeController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(AfterImageTimeController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AfterImageTimeController, mTime), e->mTime);
+}
+
+static void writePalFXControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	PalFXController* e = (PalFXController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(PalFXController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mAdd), e->mAdd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mMul), e->mMul);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mSinAdd), e->mSinAdd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mInvertAll), e->mInvertAll);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PalFXController, mColor), e->mColor);
+}
+
+static void writeSingleRequiredValueControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SingleRequiredValueController* e = (SingleRequiredValueController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SingleRequiredValueController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SingleRequiredValueController, mValue), e->mValue);
+}
+
+static void writeAngleDrawControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	AngleDrawController* e = (AngleDrawController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(AngleDrawController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AngleDrawController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(AngleDrawController, mScale), e->mScale);
+}
+
+static void writeClipboardControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ClipboardController* e = (ClipboardController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ClipboardController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ClipboardController, mText), e->mText);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ClipboardController, mParams), e->mParams);
+}
+
+static void writeSpecialAssertControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SpecialAssertController* e = (SpecialAssertController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SpecialAssertController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SpecialAssertController, mFlag), e->mFlag);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SpecialAssertController, mFlag2), e->mFlag2);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SpecialAssertController, mFlag3), e->mFlag3);
+}
+
+static void writeBindControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	BindController* e = (BindController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(BindController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(BindController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(BindController, mFacing), e->mFacing);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(BindController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(BindController, mPosition), e->mPosition);
+}
+
+static void writeChangeAnimationControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ChangeAnimationController* e = (ChangeAnimationController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ChangeAnimationController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ChangeAnimationController, tNewAnimation), e->tNewAnimation);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ChangeAnimationController, tStep), e->tStep);
+}
+
+static void writeChangeStateControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ChangeStateController* e = (ChangeStateController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ChangeStateController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ChangeStateController, mState), e->mState);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ChangeStateController, mControl), e->mControl);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ChangeStateController, mAnimation), e->mAnimation);
+}
+
+static void writeNullControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	NullController* e = (NullController*)tController->mData;
+	addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(NullController));
+}
+
+static void writeControlSettingControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ControlSettingController* e = (ControlSettingController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ControlSettingController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ControlSettingController, tValue), e->tValue);
+}
+
+static void writeDefenseMultiplierControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	DefenseMultiplierController* e = (DefenseMultiplierController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(DefenseMultiplierController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DefenseMultiplierController, mValue), e->mValue);
+}
+
+static void writeDestroySelfControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	DestroySelfController* e = (DestroySelfController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(DestroySelfController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DestroySelfController, mRecursive), e->mRecursive);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(DestroySelfController, mRemoveExplods), e->mRemoveExplods);
+}
+
+static void writeEnvironmentColorControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	EnvironmentColorController* e = (EnvironmentColorController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(EnvironmentColorController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentColorController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentColorController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentColorController, mUnder), e->mUnder);
+}
+
+static void writeEnvironmentShakeControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	EnvironmentShakeController* e = (EnvironmentShakeController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(EnvironmentShakeController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentShakeController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentShakeController, mFrequency), e->mFrequency);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentShakeController, mAmplitude), e->mAmplitude);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(EnvironmentShakeController, mPhaseOffset), e->mPhaseOffset);
+}
+
+static void writeExplodControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ExplodController* e = (ExplodController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ExplodController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mAnim), e->mAnim);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mPosition), e->mPosition);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mPositionType), e->mPositionType);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mHorizontalFacing), e->mHorizontalFacing);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mVerticalFacing), e->mVerticalFacing);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mBindTime), e->mBindTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mVelocity), e->mVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mAcceleration), e->mAcceleration);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mRandomOffset), e->mRandomOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mRemoveTime), e->mRemoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mSuperMove), e->mSuperMove);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mSuperMoveTime), e->mSuperMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mPauseMoveTime), e->mPauseMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mScale), e->mScale);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mSpritePriority), e->mSpritePriority);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mOnTop), e->mOnTop);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mShadow), e->mShadow);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mOwnPalette), e->mOwnPalette);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mIsRemovedOnGetHit), e->mIsRemovedOnGetHit);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mIgnoreHitPause), e->mIgnoreHitPause);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodController, mTransparencyType), e->mTransparencyType);
+}
+
+static void writeExplodBindTimeControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ExplodBindTimeController* e = (ExplodBindTimeController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ExplodBindTimeController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodBindTimeController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ExplodBindTimeController, mTime), e->mTime);
+}
+
+static void writeForceFeedbackControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ForceFeedbackController* e = (ForceFeedbackController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ForceFeedbackController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ForceFeedbackController, mWaveform), e->mWaveform);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ForceFeedbackController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ForceFeedbackController, mFrequency), e->mFrequency);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ForceFeedbackController, mAmplitude), e->mAmplitude);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ForceFeedbackController, mSelf), e->mSelf);
+}
+
+static void writeGameMakeAnimControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	GameMakeAnimController* e = (GameMakeAnimController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(GameMakeAnimController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(GameMakeAnimController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(GameMakeAnimController, mIsUnderPlayer), e->mIsUnderPlayer);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(GameMakeAnimController, mPosOffset), e->mPosOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(GameMakeAnimController, mRandomOffset), e->mRandomOffset);
+}
+
+static void writeHelperControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	HelperController* e = (HelperController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(HelperController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mType), e->mType);
+	setDreamCharacterCacheImagePointer(tImage, offset + offsetof(HelperController, mName), NULL); // never parsed
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mPosition), e->mPosition);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mPositionType), e->mPositionType);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mFacing), e->mFacing);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mStateNumber), e->mStateNumber);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mCanControl), e->mCanControl);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mHasOwnPalette), e->mHasOwnPalette);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSuperMoveTime), e->mSuperMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mPauseMoveTime), e->mPauseMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeScaleX), e->mSizeScaleX);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeScaleY), e->mSizeScaleY);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeGroundBack), e->mSizeGroundBack);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeGroundFront), e->mSizeGroundFront);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeAirBack), e->mSizeAirBack);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeAirFront), e->mSizeAirFront);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeHeight), e->mSizeHeight);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeProjectilesDoScale), e->mSizeProjectilesDoScale);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeHeadPosition), e->mSizeHeadPosition);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeMiddlePosition), e->mSizeMiddlePosition);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HelperController, mSizeShadowOffset), e->mSizeShadowOffset);
+}
+
+static void writeNotHitByControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	NotHitByController* e = (NotHitByController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(NotHitByController));
+	writeMugenDefStringVectorCacheImage(tImage, offset + offsetof(NotHitByController, mValue), &e->mValue, e->mHasValue);
+	writeMugenDefStringVectorCacheImage(tImage, offset + offsetof(NotHitByController, mValue2), &e->mValue2, e->mHasValue2);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(NotHitByController, mTime), e->mTime);
+}
+
+static void writeHitDefinitionControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	HitDefinitionController* e = (HitDefinitionController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(HitDefinitionController));
+	writeHitDefinitionCacheImage(tImage, offset, e);
+}
+
+static void writeHitFallSetControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	HitFallSetController* e = (HitFallSetController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(HitFallSetController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitFallSetController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitFallSetController, mXVelocity), e->mXVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitFallSetController, mYVelocity), e->mYVelocity);
+}
+
+static void writeHitOverrideControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	HitOverrideController* e = (HitOverrideController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(HitOverrideController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitOverrideController, mAttributeString), e->mAttributeString);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitOverrideController, mStateNo), e->mStateNo);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitOverrideController, mSlot), e->mSlot);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitOverrideController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(HitOverrideController, mForceAir), e->mForceAir);
+}
+
+static void writeSet2DPhysicsControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	Set2DPhysicsController* e = (Set2DPhysicsController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(Set2DPhysicsController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(Set2DPhysicsController, x), e->x);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(Set2DPhysicsController, y), e->y);
+}
+
+static void writeLifeAddControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	LifeAddController* e = (LifeAddController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(LifeAddController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(LifeAddController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(LifeAddController, mCanKill), e->mCanKill);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(LifeAddController, mIsAbsolute), e->mIsAbsolute);
+}
+
+static void writeMakeDustControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	MakeDustController* e = (MakeDustController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(MakeDustController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(MakeDustController, mPositionOffset), e->mPositionOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(MakeDustController, mPositionOffset2), e->mPositionOffset2);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(MakeDustController, mSpacing), e->mSpacing);
+}
+
+// the image stores the single entry as the controller data, restoreDreamMugenStateControllerFromCacheImage wraps it in a vector again
+static void writeVarSetControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	VarSetController* controller = (VarSetController*)tController->mData;
+	VarSetControllerEntry* e = (VarSetControllerEntry*)vector_get(&controller->mVarSets, 0);
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(VarSetControllerEntry));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarSetControllerEntry, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarSetControllerEntry, mAssignment), e->mAssignment);
+}
+
+static void writePauseControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	PauseController* e = (PauseController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(PauseController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PauseController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PauseController, mBufferTimeForCommandsDuringPauseEnd), e->mBufferTimeForCommandsDuringPauseEnd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PauseController, mMoveTime), e->mMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PauseController, mDoesPauseBackground), e->mDoesPauseBackground);
+}
+
+static void writePlaySoundControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	PlaySoundController* e = (PlaySoundController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(PlaySoundController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mVolumeScale), e->mVolumeScale);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mChannel), e->mChannel);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mLowPriority), e->mLowPriority);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mFrequencyMultiplier), e->mFrequencyMultiplier);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mLoop), e->mLoop);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mPanning), e->mPanning);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PlaySoundController, mAbsolutePanning), e->mAbsolutePanning);
+}
+
+static void writePositionFreezeControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	PositionFreezeController* e = (PositionFreezeController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(PositionFreezeController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(PositionFreezeController, mValue), e->mValue);
+}
+
+static void writeProjectileControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ProjectileController* e = (ProjectileController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ProjectileController));
+	writeHitDefinitionCacheImage(tImage, offset + offsetof(ProjectileController, mHitDef), &e->mHitDef);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mAnimation), e->mAnimation);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mHitAnimation), e->mHitAnimation);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mRemoveAnimation), e->mRemoveAnimation);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mCancelAnimation), e->mCancelAnimation);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mScale), e->mScale);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mIsRemovingProjectileAfterHit), e->mIsRemovingProjectileAfterHit);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mRemoveTime), e->mRemoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mVelocity), e->mVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mRemoveVelocity), e->mRemoveVelocity);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mAcceleration), e->mAcceleration);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mVelocityMultipliers), e->mVelocityMultipliers);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mHitAmountBeforeVanishing), e->mHitAmountBeforeVanishing);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mMissTime), e->mMissTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mPriority), e->mPriority);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mSpriteSpriority), e->mSpriteSpriority);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mEdgeBound), e->mEdgeBound);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mStageBound), e->mStageBound);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mHeightBoundValues), e->mHeightBoundValues);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mOffset), e->mOffset);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mPositionType), e->mPositionType);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mShadow), e->mShadow);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mSuperMoveTime), e->mSuperMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mPauseMoveTime), e->mPauseMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mHasOwnPalette), e->mHasOwnPalette);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mRemapPalette), e->mRemapPalette);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mAfterImageTime), e->mAfterImageTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mAfterImageLength), e->mAfterImageLength);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ProjectileController, mAfterImage), e->mAfterImage);
+}
+
+static void writeRemapPaletteControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	RemapPaletteController* e = (RemapPaletteController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(RemapPaletteController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(RemapPaletteController, mSource), e->mSource);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(RemapPaletteController, mDestination), e->mDestination);
+}
+
+static void writeRemoveExplodControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	RemoveExplodController* e = (RemoveExplodController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(RemoveExplodController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(RemoveExplodController, mID), e->mID);
+}
+
+static void writeReversalDefinitionControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ReversalDefinitionController* e = (ReversalDefinitionController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ReversalDefinitionController));
+	writeMugenDefStringVectorCacheImage(tImage, offset + offsetof(ReversalDefinitionController, mAttributes), &e->mAttributes, 1);
+}
+
+static void writeScreenBoundControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	ScreenBoundController* e = (ScreenBoundController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(ScreenBoundController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ScreenBoundController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(ScreenBoundController, mMoveCameraFlags), e->mMoveCameraFlags);
+}
+
+static void writeSpritePriorityControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SpritePriorityController* e = (SpritePriorityController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SpritePriorityController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SpritePriorityController, tValue), e->tValue);
+}
+
+static void writeStateTypeSetControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	StateTypeSetController* e = (StateTypeSetController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(StateTypeSetController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(StateTypeSetController, mStateType), e->mStateType);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(StateTypeSetController, mMoveType), e->mMoveType);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(StateTypeSetController, mPhysics), e->mPhysics);
+}
+
+static void writeSoundPanControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SoundPanController* e = (SoundPanController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SoundPanController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SoundPanController, mChannel), e->mChannel);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SoundPanController, mPan), e->mPan);
+}
+
+static void writeSoundStopControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SoundStopController* e = (SoundStopController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SoundStopController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SoundStopController, mChannel), e->mChannel);
+}
+
+static void writeSuperPauseControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SuperPauseController* e = (SuperPauseController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SuperPauseController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mTime), e->mTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mBufferTimeForCommandsDuringPauseEnd), e->mBufferTimeForCommandsDuringPauseEnd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mMoveTime), e->mMoveTime);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mDoesPauseBackground), e->mDoesPauseBackground);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mAnim), e->mAnim);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mSound), e->mSound);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mPosition), e->mPosition);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mIsDarkening), e->mIsDarkening);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mPlayer2DefenseMultiplier), e->mPlayer2DefenseMultiplier);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mPowerToAdd), e->mPowerToAdd);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SuperPauseController, mSetPlayerUnhittable), e->mSetPlayerUnhittable);
+}
+
+static void writeTargetDropControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	TargetDropController* e = (TargetDropController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(TargetDropController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetDropController, mExcludeID), e->mExcludeID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetDropController, mKeepOne), e->mKeepOne);
+}
+
+static void writeSetTargetFacingControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	SetTargetFacingController* e = (SetTargetFacingController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(SetTargetFacingController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SetTargetFacingController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(SetTargetFacingController, mID), e->mID);
+}
+
+static void writeTargetLifeAddControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	TargetLifeAddController* e = (TargetLifeAddController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(TargetLifeAddController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetLifeAddController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetLifeAddController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetLifeAddController, mCanKill), e->mCanKill);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetLifeAddController, mIsAbsolute), e->mIsAbsolute);
+}
+
+static void writeTargetPowerAddControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	TargetPowerAddController* e = (TargetPowerAddController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(TargetPowerAddController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetPowerAddController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetPowerAddController, mID), e->mID);
+}
+
+static void writeTargetChangeStateControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	TargetChangeStateController* e = (TargetChangeStateController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(TargetChangeStateController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetChangeStateController, mState), e->mState);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetChangeStateController, mControl), e->mControl);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TargetChangeStateController, mID), e->mID);
+}
+
+static void writeTarget2DPhysicsControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	Target2DPhysicsController* e = (Target2DPhysicsController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(Target2DPhysicsController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(Target2DPhysicsController, mID), e->mID);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(Target2DPhysicsController, x), e->x);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(Target2DPhysicsController, y), e->y);
+}
+
+static void writeTransparencyControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	TransparencyController* e = (TransparencyController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(TransparencyController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TransparencyController, mTransparency), e->mTransparency);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(TransparencyController, mAlpha), e->mAlpha);
+}
+
+static void writeVarRandomControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	VarRandomController* e = (VarRandomController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(VarRandomController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarRandomController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarRandomController, mRange), e->mRange);
+}
+
+static void writeVarRangeSetControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	VarRangeSetController* e = (VarRangeSetController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(VarRangeSetController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarRangeSetController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarRangeSetController, mFirst), e->mFirst);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VarRangeSetController, mLast), e->mLast);
+}
+
+static void writeVictoryQuoteControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	VictoryQuoteController* e = (VictoryQuoteController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(VictoryQuoteController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(VictoryQuoteController, mValue), e->mValue);
+}
+
+static void writeWidthControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	WidthController* e = (WidthController*)tController->mData;
+	const uint32_t offset = addStateControllerCacheImageData(tImage, tControllerOffset, e, sizeof(WidthController));
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(WidthController, mValue), e->mValue);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(WidthController, mEdge), e->mEdge);
+	writeDreamMugenAssignmentCacheImage(tImage, offset + offsetof(WidthController, mPlayer), e->mPlayer);
+}
+
+static void setupStateControllerCacheWriters() {
+	memset(gMugenStateControllerVariableHandler.mStateControllerCacheWriters, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerCacheWriters));
+
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE] = writeAfterImageControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE_TIME] = writeAfterImageTimeControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PALETTE_EFFECT_ALL] = writePalFXControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_ANGLE] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_DRAW_ANGLE] = writeAngleDrawControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_MUL_ANGLE] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_ANGLE] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_APPEND_TO_CLIPBOARD] = writeClipboardControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ASSERT_SPECIAL] = writeSpecialAssertControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_ATTACK_DISTANCE] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_ATTACK_MULTIPLIER] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PALETTE_EFFECT_BACKGROUND] = writePalFXControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_BIND_TO_PARENT] = writeBindControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_BIND_TO_ROOT] = writeBindControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_BIND_TO_TARGET] = writeBindControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_CHANGE_ANIMATION] = writeChangeAnimationControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_CHANGE_ANIMATION_2] = writeChangeAnimationControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_CHANGE_STATE] = writeChangeStateControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_CLEAR_CLIPBOARD] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_CONTROL] = writeControlSettingControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_DEFENSE_MULTIPLIER] = writeDefenseMultiplierControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_DESTROY_SELF] = writeDestroySelfControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_DISPLAY_TO_CLIPBOARD] = writeClipboardControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ENVIRONMENT_COLOR] = writeEnvironmentColorControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ENVIRONMENT_SHAKE] = writeEnvironmentShakeControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_EXPLOD] = writeExplodControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_EXPLOD_BIND_TIME] = writeExplodBindTimeControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_FORCE_FEEDBACK] = writeForceFeedbackControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_FALL_ENVIRONMENT_SHAKE] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_MAKE_GAME_ANIMATION] = writeGameMakeAnimControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_GRAVITY] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HELPER] = writeHelperControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_HIT] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HIT_BY] = writeNotHitByControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HIT_DEFINITION] = writeHitDefinitionControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HIT_FALL_DAMAGE] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_HIT_FALL] = writeHitFallSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HIT_FALL_VELOCITY] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_HIT_OVERRIDE] = writeHitOverrideControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_HIT_VELOCITY] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_LIFE] = writeLifeAddControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_LIFE] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_MAKE_DUST] = writeMakeDustControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_MODIFY_EXPLOD] = writeExplodControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_RESET_MOVE_HIT] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_NOT_HIT_BY] = writeNotHitByControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_NULL] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_OFFSET] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PALETTE_EFFECT] = writePalFXControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PARENT_ADD_VARIABLE] = writeVarSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_PARENT_VARIABLE] = writeVarSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PAUSE] = writePauseControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PLAYER_PUSH] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PLAY_SOUND] = writePlaySoundControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_POSITION] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_FREEZE_POSITION] = writePositionFreezeControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_POSITION] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_POWER] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_POWER] = writeSingleRequiredValueControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PROJECTILE] = writeProjectileControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_REMAP_PALETTE] = writeRemapPaletteControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_REMOVE_EXPLOD] = writeRemoveExplodControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_REVERSAL_DEFINITION] = writeReversalDefinitionControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SCREEN_BOUND] = writeScreenBoundControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_SELF_STATE] = writeChangeStateControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SPRITE_PRIORITY] = writeSpritePriorityControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_STATE_TYPE] = writeStateTypeSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_PAN_SOUND] = writeSoundPanControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_STOP_SOUND] = writeSoundStopControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SUPER_PAUSE] = writeSuperPauseControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_BIND_TARGET] = writeBindControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_DROP_TARGET] = writeTargetDropControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_TARGET_FACING] = writeSetTargetFacingControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_TARGET_LIFE] = writeTargetLifeAddControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_TARGET_POWER] = writeTargetPowerAddControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_TARGET_STATE] = writeTargetChangeStateControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_TARGET_ADD_VELOCITY] = writeTarget2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_TARGET_SET_VELOCITY] = writeTarget2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_TRANSPARENCY] = writeTransparencyControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_TURN] = writeNullControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_VARIABLE] = writeVarSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_VARIABLE_RANDOM] = writeVarRandomControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_VARIABLE_RANGE] = writeVarRangeSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_VARIABLE] = writeVarSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_ADD_VELOCITY] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_MULTIPLY_VELOCITY] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_SET_VELOCITY] = writeSet2DPhysicsControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_VICTORY_QUOTE] = writeVictoryQuoteControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_WIDTH] = writeWidthControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_GLOBAL_VAR_SET] = writeVarSetControllerCacheImage;
+	gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_GLOBAL_VAR_ADD] = writeVarSetControllerCacheImage;
+}
+
+static int isVarSetStateControllerType(uint8_t tType) {
+	return tType == MUGEN_STATE_CONTROLLER_TYPE_SET_VARIABLE || tType == MUGEN_STATE_CONTROLLER_TYPE_ADD_VARIABLE || tType == MUGEN_STATE_CONTROLLER_TYPE_PARENT_ADD_VARIABLE || tType == MUGEN_STATE_CONTROLLER_TYPE_SET_PARENT_VARIABLE || tType == MUGEN_STATE_CONTROLLER_TYPE_GLOBAL_VAR_SET || tType == MUGEN_STATE_CONTROLLER_TYPE_GLOBAL_VAR_ADD;
+}
+
+// the controller data structs are defined in this file, so its build id covers every layout the writers above copy
+uint32_t getDreamMugenStateControllerCacheLayoutStamp() {
+	uint32_t ret = addDreamCharacterCacheImageLayoutStamp(2166136261u, DREAM_CHARACTER_CACHE_BUILD_ID);
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenStateController));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(HitDefinitionController));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(VarSetControllerEntry));
+	return ret;
+}
+
+void writeDreamMugenStateControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController) {
+	const uint32_t triggerOffset = tControllerOffset + offsetof(DreamMugenStateController, mTrigger);
+	writeDreamMugenAssignmentCacheImage(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mAssignment), tController->mTrigger.mAssignment);
+	clearDreamCharacterCacheImageBytes(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mCachedResult), sizeof(uint8_t));
+	setDreamCharacterCacheImagePointer(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mCachedOwner), NULL);
+	clearDreamCharacterCacheImageBytes(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mCachedVariableStamp), sizeof(uint32_t));
+	clearDreamCharacterCacheImageBytes(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mCachedStateStamp), sizeof(uint32_t));
+	clearDreamCharacterCacheImageBytes(tImage, triggerOffset + offsetof(DreamMugenStateControllerTrigger, mCachedCommandStamp), sizeof(uint32_t));
+
+	StateControllerCacheWriteFunction func = gMugenStateControllerVariableHandler.mStateControllerCacheWriters[tController->mType];
+	if (!func) {
+		failDreamCharacterCacheImage(tImage, "state controller type without cache writer");
+		return;
+	}
+	func(tImage, tControllerOffset, tController);
+}
+
+void restoreDreamMugenStateControllerFromCacheImage(DreamMugenStateController* tController) {
+	if (!isVarSetStateControllerType(tController->mType)) return;
+
+	VarSetController* e = (VarSetController*)allocMemory(sizeof(VarSetController));
+	e->mVarSets = new_vector();
+	vector_push_back(&e->mVarSets, tController->mData);
+	tController->mData = e;
+}
+
+void releaseDreamMugenStateControllerFromCacheImage(DreamMugenStateController* tController) {
+	if (!isVarSetStateControllerType(tController->mType)) return;
+
+	VarSetController* e = (VarSetController*)tController->mData;
+	delete_vector(&e->mVarSets);
+	freeMemory(e);
+}
+
 void setupDreamMugenStateControllerHandler(MemoryStack* tMemoryStack) {
 	setupStateControllerParsers();
 	setupStateControllerHandlers();
 	setupStateControllerUnloaders();
+	setupStateControllerCacheWriters();
 	gMugenStateControllerVariableHandler.mMemoryStack = tMemoryStack;
 }
 
+// story mode only sets up the parsers and handlers, so the cache writers tell whether the fight controllers are available
+int isDreamMugenStateControllerHandlerActive() {
+	return gMugenStateControllerVariableHandler.mStateControllerCacheWriters[MUGEN_STATE_CONTROLLER_TYPE_AFTER_IMAGE] != NULL;
+}
+
 
 typedef struct {
 	DreamMugenAssignment* mID;
@@ -7251,7 +7998,7 @@ int cameraFocusStoryHandleFunction(DreamMugenStateController* tController, Dream
 int cameraZoomStoryHandleFunction(DreamMugenStateController* tController, DreamPlayer* tPlayer) { return handleCameraZoomStoryController(tController, (StoryInstance*)tPlayer); }
 
 static void setupStoryStateControllerHandlers() {
-	gMugenStateControllerVariableHandler.mStateControllerHandlers.clear();
+	memset(gMugenStateControllerVariableHandler.mStateControllerHandlers, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerHandlers));
 	
 	gMugenStateControllerVariableHandler.mStateControllerHandlers[MUGEN_STORY_STATE_CONTROLLER_TYPE_NULL] = nullStoryHandleFunction;
 	gMugenStateControllerVariableHandler.mStateControllerHandlers[MUGEN_STORY_STATE_CONTROLLER_TYPE_CREATE_ANIMATION] = createAnimationStoryHandleFunction;
@@ -7317,7 +8064,8 @@ void setupDreamMugenStoryStateControllerHandler()
 void shutdownDreamMugenStateControllerHandler()
 {
 	gMugenStateControllerVariableHandler.mStateControllerParsers.clear();
-	gMugenStateControllerVariableHandler.mStateControllerHandlers.clear();
-	gMugenStateControllerVariableHandler.mStateControllerUnloaders.clear();
+	memset(gMugenStateControllerVariableHandler.mStateControllerHandlers, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerHandlers));
+	memset(gMugenStateControllerVariableHandler.mStateControllerUnloaders, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerUnloaders));
+	memset(gMugenStateControllerVariableHandler.mStateControllerCacheWriters, 0, sizeof(gMugenStateControllerVariableHandler.mStateControllerCacheWriters));
 	gMugenStateControllerVariableHandler.mMemoryStack = NULL;
 }
@@ -5,12 +5,18 @@
 
 #include "mugenassignment.h"
 #include "playerdefinition.h"
+#include "charactercacheimage.h"
 
 
-DreamMugenStateController* parseDreamMugenStateControllerFromGroup(MugenDefScriptGroup* tGroup);
+void parseDreamMugenStateControllerFromGroup(DreamMugenStateController* oController, MugenDefScriptGroup* tGroup);
 void unloadDreamMugenStateController(DreamMugenStateController* tController);
+uint32_t getDreamMugenStateControllerCacheLayoutStamp();
+void writeDreamMugenStateControllerCacheImage(DreamCharacterCacheImage* tImage, uint32_t tControllerOffset, DreamMugenStateController* tController);
+void restoreDreamMugenStateControllerFromCacheImage(DreamMugenStateController* tController);
+void releaseDreamMugenStateControllerFromCacheImage(DreamMugenStateController* tController);
 int handleDreamMugenStateControllerAndReturnWhetherStateChanged(DreamMugenStateController* tController, DreamPlayer* tPlayer);
 
 void setupDreamMugenStateControllerHandler(MemoryStack* tMemoryStack);
+int isDreamMugenStateControllerHandlerActive();
 void setupDreamMugenStoryStateControllerHandler();
 void shutdownDreamMugenStateControllerHandler();
\ No newline at end of file
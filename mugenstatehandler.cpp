@@ -1,6 +1,7 @@
 #include "mugenstatehandler.h"
 
 #include <assert.h>
+#include <deque>
 
 #include <prism/datastructures.h>
 #include <prism/system.h>
@@ -15,6 +16,11 @@
 
 using namespace std;
 
+#define INLINE_VISITED_STATE_AMOUNT 16
+#define REGISTERED_STATE_SLOT_INDEX_BITS 16
+#define REGISTERED_STATE_SLOT_INDEX_MASK ((1 << REGISTERED_STATE_SLOT_INDEX_BITS) - 1)
+#define REGISTERED_STATE_SLOT_GENERATION_MASK 0x7FFF
+
 typedef struct {
 	DreamMugenStates* mStates;
 	int mIsUsingTemporaryOtherStateMachine;
@@ -30,12 +36,23 @@ typedef struct {
 	int mIsInputControlDisabled;
 	int mIsDisabled;
 	int mWasUpdatedOutsideHandler;
+	int mIsPooled;
 
 	int mCurrentJugglePoints;
 } RegisteredState;
 
+typedef struct {
+	RegisteredState mState;
+	uint16_t mGeneration;
+	uint8_t mIsActive;
+	int mUpdateOrderIndex;
+} RegisteredStateSlot;
+
 static struct {
-	map<int, RegisteredState> mRegisteredStates;
+	deque<RegisteredStateSlot> mRegisteredStates;
+	vector<int> mFreeRegisteredStateSlots;
+	vector<int> mUpdateOrder; // IDs in registration order, -1 for removed entries until the next compaction
+	int mUpdateOrderHoleAmount;
 	int mIsInStoryMode;
 
 	double mTimeDilatationNow;
@@ -46,6 +63,9 @@ static void loadStateHandler(void* tData) {
 	(void)tData;
 	
 	gMugenStateHandlerData.mRegisteredStates.clear();
+	gMugenStateHandlerData.mFreeRegisteredStateSlots.clear();
+	gMugenStateHandlerData.mUpdateOrder.clear();
+	gMugenStateHandlerData.mUpdateOrderHoleAmount = 0;
 	gMugenStateHandlerData.mTimeDilatationNow = 0.0;
 	gMugenStateHandlerData.mTimeDilatation = 1.0;
 }
@@ -53,6 +73,61 @@ static void loadStateHandler(void* tData) {
 static void unloadStateHandler(void* tData) {
 	(void)tData;
 	gMugenStateHandlerData.mRegisteredStates.clear();
+	gMugenStateHandlerData.mFreeRegisteredStateSlots.clear();
+	gMugenStateHandlerData.mUpdateOrder.clear();
+}
+
+static int getRegisteredStateSlotIndex(int tID) {
+	return tID & REGISTERED_STATE_SLOT_INDEX_MASK;
+}
+
+static int getRegisteredStateSlotGeneration(int tID) {
+	return (tID >> REGISTERED_STATE_SLOT_INDEX_BITS) & REGISTERED_STATE_SLOT_GENERATION_MASK;
+}
+
+static int isValidRegisteredStateID(int tID) {
+	int index = getRegisteredStateSlotIndex(tID);
+	if (tID < 0 || index >= (int)gMugenStateHandlerData.mRegisteredStates.size()) return 0;
+	RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[index];
+	return slot->mIsActive && slot->mGeneration == getRegisteredStateSlotGeneration(tID);
+}
+
+static RegisteredState* getRegisteredState(int tID) {
+	assert(isValidRegisteredStateID(tID));
+	return &gMugenStateHandlerData.mRegisteredStates[getRegisteredStateSlotIndex(tID)].mState;
+}
+
+static void appendRegisteredStateToUpdateOrder(int tID) {
+	RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[getRegisteredStateSlotIndex(tID)];
+	slot->mUpdateOrderIndex = (int)gMugenStateHandlerData.mUpdateOrder.size();
+	gMugenStateHandlerData.mUpdateOrder.push_back(tID);
+}
+
+static void removeRegisteredStateFromUpdateOrder(RegisteredStateSlot* tSlot) {
+	gMugenStateHandlerData.mUpdateOrder[tSlot->mUpdateOrderIndex] = -1;
+	gMugenStateHandlerData.mUpdateOrderHoleAmount++;
+}
+
+static void compactRegisteredStateUpdateOrder() {
+	if (!gMugenStateHandlerData.mUpdateOrderHoleAmount) return;
+
+	vector<int>& order = gMugenStateHandlerData.mUpdateOrder;
+	int amount = 0;
+	for (int i = 0; i < (int)order.size(); i++) {
+		if (order[i] < 0) continue;
+		gMugenStateHandlerData.mRegisteredStates[getRegisteredStateSlotIndex(order[i])].mUpdateOrderIndex = amount;
+		order[amount++] = order[i];
+	}
+	order.resize(amount);
+	gMugenStateHandlerData.mUpdateOrderHoleAmount = 0;
+}
+
+static void removeRegisteredStateSlot(int tIndex) {
+	RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[tIndex];
+	removeRegisteredStateFromUpdateOrder(slot);
+	slot->mIsActive = 0;
+	slot->mGeneration = (slot->mGeneration + 1) & REGISTERED_STATE_SLOT_GENERATION_MASK;
+	gMugenStateHandlerData.mFreeRegisteredStateSlots.push_back(tIndex);
 }
 
 typedef struct {
@@ -62,28 +137,47 @@ typedef struct {
 	int mHasChangedState;
 } MugenStateControllerCaller;
 
+static int isTriggerCacheValid(DreamMugenStateControllerTrigger* tTrigger, DreamPlayer* tPlayer) {
+	if (tTrigger->mCachedOwner != tPlayer) return 0;
+	if ((tTrigger->mDependencies & MUGEN_ASSIGNMENT_DEPENDENCY_VARIABLES) && tTrigger->mCachedVariableStamp != getPlayerVariableStamp(tPlayer)) return 0;
+	if ((tTrigger->mDependencies & MUGEN_ASSIGNMENT_DEPENDENCY_STATE) && tTrigger->mCachedStateStamp != getPlayerStateStamp(tPlayer)) return 0;
+	if ((tTrigger->mDependencies & MUGEN_ASSIGNMENT_DEPENDENCY_COMMAND) && tTrigger->mCachedCommandStamp != getPlayerCommandStamp(tPlayer)) return 0;
+
+	return 1;
+}
+
 static int evaluateTrigger(DreamMugenStateControllerTrigger* tTrigger, DreamPlayer* tPlayer) {
-	return evaluateDreamAssignment(&tTrigger->mAssignment, tPlayer);
+	if (gMugenStateHandlerData.mIsInStoryMode || !tPlayer || (tTrigger->mDependencies & MUGEN_ASSIGNMENT_DEPENDENCY_UNTRACKED)) {
+		return evaluateDreamAssignment(&tTrigger->mAssignment, tPlayer);
+	}
+
+	if (isTriggerCacheValid(tTrigger, tPlayer)) {
+		return tTrigger->mCachedResult;
+	}
+
+	tTrigger->mCachedResult = (uint8_t)evaluateDreamAssignment(&tTrigger->mAssignment, tPlayer);
+	tTrigger->mCachedOwner = tPlayer;
+	tTrigger->mCachedVariableStamp = getPlayerVariableStamp(tPlayer);
+	tTrigger->mCachedStateStamp = getPlayerStateStamp(tPlayer);
+	tTrigger->mCachedCommandStamp = getPlayerCommandStamp(tPlayer);
+	return tTrigger->mCachedResult;
 }
 
-static void updateSingleController(void* tCaller, void* tData) {
-	MugenStateControllerCaller* caller = (MugenStateControllerCaller*)tCaller;
-	DreamMugenStateController* controller = (DreamMugenStateController*)tData;
-	
-	if (!gMugenStateHandlerData.mIsInStoryMode && caller->mRegisteredState->mPlayer && isPlayerDestroyed(caller->mRegisteredState->mPlayer)) return;
-	if (caller->mHasChangedState) return;
-	if (!evaluateTrigger(&controller->mTrigger, caller->mRegisteredState->mPlayer)) return;
-
-	controller->mAccessAmount++;
-	int testValue = controller->mAccessAmount - 1;
-	if (controller->mPersistence) {
-		if (testValue % controller->mPersistence != 0) return;
+static void updateSingleController(MugenStateControllerCaller* tCaller, DreamMugenStateController* tController) {
+	if (!gMugenStateHandlerData.mIsInStoryMode && tCaller->mRegisteredState->mPlayer && isPlayerDestroyed(tCaller->mRegisteredState->mPlayer)) return;
+	if (tCaller->mHasChangedState) return;
+	if (!evaluateTrigger(&tController->mTrigger, tCaller->mRegisteredState->mPlayer)) return;
+
+	tController->mAccessAmount++;
+	int testValue = tController->mAccessAmount - 1;
+	if (tController->mPersistence) {
+		if (testValue % tController->mPersistence != 0) return;
 	}
 	else {
 		if (testValue) return;
 	}
 
-	caller->mHasChangedState = handleDreamMugenStateControllerAndReturnWhetherStateChanged(controller, caller->mRegisteredState->mPlayer);
+	tCaller->mHasChangedState = handleDreamMugenStateControllerAndReturnWhetherStateChanged(tController, tCaller->mRegisteredState->mPlayer);
 }
 
 static DreamMugenStates* getCurrentStateMachineStates(RegisteredState* tRegisteredState) {
@@ -95,27 +189,60 @@ static DreamMugenStates* getCurrentStateMachineStates(RegisteredState* tRegister
 	}
 }
 
+typedef struct {
+	int mInlineStates[INLINE_VISITED_STATE_AMOUNT];
+	int mInlineStateAmount;
+	vector<int> mOverflowStates;
+} VisitedStates;
+
+int gDebugStateMachineAllocationAmount;
+
+static void addVisitedState(VisitedStates* tVisitedStates, int tState) {
+	if (tVisitedStates->mInlineStateAmount < INLINE_VISITED_STATE_AMOUNT) {
+		tVisitedStates->mInlineStates[tVisitedStates->mInlineStateAmount++] = tState;
+		return;
+	}
+
+	if (tVisitedStates->mOverflowStates.size() == tVisitedStates->mOverflowStates.capacity()) {
+		gDebugStateMachineAllocationAmount++;
+	}
+	tVisitedStates->mOverflowStates.push_back(tState);
+}
+
+static int hasVisitedState(VisitedStates* tVisitedStates, int tState) {
+	for (int i = 0; i < tVisitedStates->mInlineStateAmount; i++) {
+		if (tVisitedStates->mInlineStates[i] == tState) return 1;
+	}
+	for (size_t i = 0; i < tVisitedStates->mOverflowStates.size(); i++) {
+		if (tVisitedStates->mOverflowStates[i] == tState) return 1;
+	}
+	return 0;
+}
+
 static void updateSingleState(RegisteredState* tRegisteredState, int tState, int tForceOwnStates) {
 	if (!gMugenStateHandlerData.mIsInStoryMode && tRegisteredState->mPlayer && (!isPlayer(tRegisteredState->mPlayer) || isPlayerDestroyed(tRegisteredState->mPlayer))) return;
 
-	set<int> visitedStates;
+	VisitedStates visitedStates;
+	visitedStates.mInlineStateAmount = 0;
 	
 	int isEvaluating = 1;
 	while (isEvaluating) {
 		DreamMugenStates* states = tForceOwnStates ? tRegisteredState->mStates : getCurrentStateMachineStates(tRegisteredState);
-		if (!stl_map_contains(states->mStates, tState)) break;
-		visitedStates.insert(tState);
-		DreamMugenState* state = &states->mStates[tState];
+		DreamMugenState* state = getDreamMugenStateOrNull(states, tState);
+		if (!state) break;
+		addVisitedState(&visitedStates, tState);
 		MugenStateControllerCaller caller;
 		caller.mRegisteredState = tRegisteredState;
 		caller.mState = state;
 		caller.mHasChangedState = 0;
-		vector_map(&state->mControllers, updateSingleController, &caller);
+		for (int i = 0; i < state->mControllerAmount && !caller.mHasChangedState; i++) {
+			updateSingleController(&caller, &state->mControllers[i]);
+		}
 		
 		if (!caller.mHasChangedState) break;
 		else {
 			if (tState < 0) break;
-			if (stl_set_contains(visitedStates, tRegisteredState->mState)) {
+			if (hasVisitedState(&visitedStates, tRegisteredState->mState)) {
 				tRegisteredState->mTimeInState--;
 				break;
 			}
@@ -139,17 +266,15 @@ static int updateSingleStateMachineByReference(RegisteredState* tRegisteredState
 	}
 	updateSingleState(tRegisteredState, tRegisteredState->mState, 0);
 
-	return !gMugenStateHandlerData.mIsInStoryMode && tRegisteredState->mPlayer && isPlayerDestroyed(tRegisteredState->mPlayer);
+	return !gMugenStateHandlerData.mIsInStoryMode && tRegisteredState->mPlayer && !tRegisteredState->mIsPooled && isPlayerDestroyed(tRegisteredState->mPlayer);
 }
 
-static int updateSingleStateMachine(void* tCaller, RegisteredState& tData) {
-	(void)tCaller;
-	RegisteredState* registeredState = &tData;
-	if (!registeredState->mWasUpdatedOutsideHandler) {
-		return updateSingleStateMachineByReference(registeredState);
+static int updateSingleStateMachine(RegisteredState* tRegisteredState) {
+	if (!tRegisteredState->mWasUpdatedOutsideHandler) {
+		return updateSingleStateMachineByReference(tRegisteredState);
 	}
 	else {
-		registeredState->mWasUpdatedOutsideHandler = 0;
+		tRegisteredState->mWasUpdatedOutsideHandler = 0;
 		return 0;
 	}
 }
@@ -160,7 +285,17 @@ static void updateStateHandler(void* tData) {
 	int updateAmount = (int)gMugenStateHandlerData.mTimeDilatationNow;
 	gMugenStateHandlerData.mTimeDilatationNow -= updateAmount;
 	while (updateAmount--) {
-		stl_int_map_remove_predicate(gMugenStateHandlerData.mRegisteredStates, updateSingleStateMachine);
+		// walks registration order like the old ID map, so machines registered during the sweep still run this tick
+		for (int i = 0; i < (int)gMugenStateHandlerData.mUpdateOrder.size(); i++) {
+			int id = gMugenStateHandlerData.mUpdateOrder[i];
+			if (id < 0) continue;
+
+			RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[getRegisteredStateSlotIndex(id)];
+			if (updateSingleStateMachine(&slot->mState) && isValidRegisteredStateID(id)) {
+				removeRegisteredStateSlot(getRegisteredStateSlotIndex(id));
+			}
+		}
+		compactRegisteredStateUpdateOrder();
 	}
 }
 
@@ -168,23 +303,46 @@ ActorBlueprint getDreamMugenStateHandler() {
 	return makeActorBlueprint(loadStateHandler, unloadStateHandler, updateStateHandler);
 }
 
+static void initRegisteredState(RegisteredState* e, DreamMugenStates* tStates, DreamPlayer* tPlayer) {
+	e->mStates = tStates;
+	e->mIsUsingTemporaryOtherStateMachine = 0;
+	e->mPreviousState = 0;
+	e->mState = 0;
+	e->mTimeInState = -1;
+	e->mPlayer = tPlayer;
+	e->mIsPaused = 0;
+	e->mIsInHelperMode = 0;
+	e->mIsInputControlDisabled = 0;
+	e->mIsDisabled = 0;
+	e->mWasUpdatedOutsideHandler = 0;
+	e->mIsPooled = 0;
+	e->mCurrentJugglePoints = 0;
+}
+
 int registerDreamMugenStateMachine(DreamMugenStates * tStates, DreamPlayer* tPlayer)
 {
 	RegisteredState e;
-	e.mStates = tStates;
-	e.mIsUsingTemporaryOtherStateMachine = 0;
-	e.mPreviousState = 0;
-	e.mState = 0;
-	e.mTimeInState = -1;
-	e.mPlayer = tPlayer;
-	e.mIsPaused = 0;
-	e.mIsInHelperMode = 0;
-	e.mIsInputControlDisabled = 0;
-	e.mIsDisabled = 0;
-	e.mWasUpdatedOutsideHandler = 0;
-	e.mCurrentJugglePoints = 0;
-
-	return stl_int_map_push_back(gMugenStateHandlerData.mRegisteredStates, e);
+	initRegisteredState(&e, tStates, tPlayer);
+
+	int index;
+	if (gMugenStateHandlerData.mFreeRegisteredStateSlots.empty()) {
+		index = (int)gMugenStateHandlerData.mRegisteredStates.size();
+		assert(index <= REGISTERED_STATE_SLOT_INDEX_MASK);
+		RegisteredStateSlot slot;
+		slot.mGeneration = 0;
+		gMugenStateHandlerData.mRegisteredStates.push_back(slot);
+	}
+	else {
+		index = gMugenStateHandlerData.mFreeRegisteredStateSlots.back();
+		gMugenStateHandlerData.mFreeRegisteredStateSlots.pop_back();
+	}
+
+	RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[index];
+	slot->mState = e;
+	slot->mIsActive = 1;
+	int id = (slot->mGeneration << REGISTERED_STATE_SLOT_INDEX_BITS) | index;
+	appendRegisteredStateToUpdateOrder(id);
+	return id;
 }
 
 int registerDreamMugenStoryStateMachine(DreamMugenStates * tStates, StoryInstance* tInstance)
@@ -198,44 +356,39 @@ int registerDreamMugenStoryStateMachine(DreamMugenStates * tStates, StoryInstanc
 
 void removeDreamRegisteredStateMachine(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	gMugenStateHandlerData.mRegisteredStates.erase(tID);
+	assert(isValidRegisteredStateID(tID));
+	removeRegisteredStateSlot(getRegisteredStateSlotIndex(tID));
 }
 
 int getDreamRegisteredStateState(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
 	return e->mState;
 }
 
 int getDreamRegisteredStatePreviousState(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
 	return e->mPreviousState;
 }
 
 int isDreamRegisteredStateMachinePaused(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	return e->mIsPaused;
 }
 
 void pauseDreamRegisteredStateMachine(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsPaused = 1;
 }
 
 void unpauseDreamRegisteredStateMachine(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	if (e->mIsDisabled) return;
 	e->mIsPaused = 0;
 }
@@ -248,89 +401,95 @@ void setDreamRegisteredStateMachinePauseStatus(int tID, int tIsPaused)
 
 void disableDreamRegisteredStateMachine(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsDisabled = 1;
 	pauseDreamRegisteredStateMachine(tID);
 }
 
 int getDreamRegisteredStateJugglePoints(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
 	return e->mCurrentJugglePoints;
 }
 
 int getDreamRegisteredStateTimeInState(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
 	return e->mTimeInState;
 }
 
 void setDreamRegisteredStateTimeInState(int tID, int tTime)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
 	e->mTimeInState = tTime;
 }
 
 void setDreamRegisteredStateToHelperMode(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsInHelperMode = 1;
 }
 
 void setDreamRegisteredStateDisableCommandState(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsInputControlDisabled = 1;
 }
 
+void setDreamRegisteredStateToPooledMode(int tID)
+{
+	RegisteredState* e = getRegisteredState(tID);
+	e->mIsPooled = 1;
+}
+
+void resetDreamRegisteredStateMachine(int tID)
+{
+	RegisteredState* e = getRegisteredState(tID);
+	int isPooled = e->mIsPooled;
+	initRegisteredState(e, e->mStates, e->mPlayer);
+	e->mIsPooled = isPooled;
+
+	// a reset machine updates like a fresh registration: after everything registered before it, starting this tick
+	RegisteredStateSlot* slot = &gMugenStateHandlerData.mRegisteredStates[getRegisteredStateSlotIndex(tID)];
+	removeRegisteredStateFromUpdateOrder(slot);
+	appendRegisteredStateToUpdateOrder(tID);
+}
+
 int hasDreamHandledStateMachineState(int tID, int tNewState)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	
 	DreamMugenStates* states = getCurrentStateMachineStates(e);
-	return stl_map_contains(states->mStates, tNewState);
+	return getDreamMugenStateOrNull(states, tNewState) != NULL;
 }
 
 int hasDreamHandledStateMachineStateSelf(int tID, int tNewState)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
-	return stl_map_contains(e->mStates->mStates, tNewState);
+	RegisteredState* e = getRegisteredState(tID);
+	return getDreamMugenStateOrNull(e->mStates, tNewState) != NULL;
 }
 
 int isInOwnStateMachine(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	return !e->mIsUsingTemporaryOtherStateMachine;
 }
 
-static void resetSingleStateController(void* tCaller, void* tData) {
-	(void)tCaller;
-	DreamMugenStateController* controller = (DreamMugenStateController*)tData;
-	controller->mAccessAmount = 0;
-}
-
 static void resetStateControllers(DreamMugenState* e) {
-	vector_map(&e->mControllers, resetSingleStateController, NULL);
+	for (int i = 0; i < e->mControllerAmount; i++) {
+		e->mControllers[i].mAccessAmount = 0;
+	}
 }
 
 void changeDreamHandledStateMachineState(int tID, int tNewState)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	DreamMugenStates* states = getCurrentStateMachineStates(e);
-	if (!stl_map_contains(states->mStates, tNewState)) {
+	DreamMugenState* newState = getDreamMugenStateOrNull(states, tNewState);
+	if (!newState) {
 		if (!e->mPlayer || gMugenStateHandlerData.mIsInStoryMode) {
 			logWarningFormat("ID %d trying to change into nonexistant state %d. Ignoring.", tID, tNewState);
 		}
@@ -347,11 +506,11 @@ void changeDreamHandledStateMachineState(int tID, int tNewState)
 	e->mPreviousState = e->mState;
 	e->mState = tNewState;
 	
-	DreamMugenState* newState = &states->mStates[e->mState];
 	resetStateControllers(newState);
 	
 	if (!e->mPlayer || gMugenStateHandlerData.mIsInStoryMode) return;
 
+	updatePlayerStateStamp(e->mPlayer);
 	resetPlayerMoveContactCounter(e->mPlayer);
 	setPlayerStateType(e->mPlayer, newState->mType);
 	setPlayerStateMoveType(e->mPlayer, newState->mMoveType);
@@ -408,11 +567,9 @@ void changeDreamHandledStateMachineState(int tID, int tNewState)
 
 void changeDreamHandledStateMachineStateToOtherPlayerStateMachine(int tID, int tTemporaryID, int tNewState)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tTemporaryID));
-	RegisteredState* borrowFromState = &gMugenStateHandlerData.mRegisteredStates[tTemporaryID];
+	RegisteredState* borrowFromState = getRegisteredState(tTemporaryID);
 
 	e->mIsUsingTemporaryOtherStateMachine = 1;
 	e->mTemporaryStates = borrowFromState->mStates;
@@ -421,8 +578,7 @@ void changeDreamHandledStateMachineStateToOtherPlayerStateMachine(int tID, int t
 
 void changeDreamHandledStateMachineStateToOwnStateMachine(int tID, int tNewState)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsUsingTemporaryOtherStateMachine = 0;
 
 	changeDreamHandledStateMachineState(tID, tNewState);
@@ -430,22 +586,19 @@ void changeDreamHandledStateMachineStateToOwnStateMachine(int tID, int tNewState
 
 void changeDreamHandledStateMachineStateToOwnStateMachineWithoutChangingState(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	e->mIsUsingTemporaryOtherStateMachine = 0;
 }
 
 void updateDreamSingleStateMachineByID(int tID) {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	updateSingleStateMachineByReference(e);
 	e->mWasUpdatedOutsideHandler = 1;
 }
 
 void setDreamSingleStateMachineToUpdateAgainByID(int tID)
 {
-	assert(stl_map_contains(gMugenStateHandlerData.mRegisteredStates, tID));
-	RegisteredState* e = &gMugenStateHandlerData.mRegisteredStates[tID];
+	RegisteredState* e = getRegisteredState(tID);
 	updateSingleStateMachineByReference(e);
 	e->mWasUpdatedOutsideHandler = 0;
 }
@@ -24,6 +24,8 @@ int getDreamRegisteredStateTimeInState(int tID);
 void setDreamRegisteredStateTimeInState(int tID, int tTime);
 void setDreamRegisteredStateToHelperMode(int tID);
 void setDreamRegisteredStateDisableCommandState(int tID);
+void setDreamRegisteredStateToPooledMode(int tID);
+void resetDreamRegisteredStateMachine(int tID);
 
 int hasDreamHandledStateMachineState(int tID, int tNewState);
 int hasDreamHandledStateMachineStateSelf(int tID, int tNewState);
@@ -1,6 +1,7 @@
 #include "mugenstatereader.h"
 
 #include <assert.h>
+#include <stddef.h>
 
 #include <prism/log.h>
 #include <prism/system.h>
@@ -10,9 +11,12 @@
 #include <prism/stlutil.h>
 
 #include "mugenstatecontrollers.h"
+#include "mugenassignmentevaluator.h"
 
 using namespace std;
 
+#define MAXIMUM_DIRECT_STATE_TABLE_SIZE 10000
+
 static int isMugenStateDef(const char* tName) {
 	char firstW[100];
 	sscanf(tName, "%s", firstW);
@@ -35,9 +39,26 @@ static MugenDefScriptGroup* getFirstStateDefGroup(MugenDefScript* tScript) {
 
 static struct {
 	int mCurrentGroup;
-
+	vector<DreamMugenStateController> mControllers;
 } gMugenStateDefParseState;
 
+static void flushParsedStateControllers(DreamMugenStates* tStates) {
+	if (gMugenStateDefParseState.mControllers.empty()) return;
+
+	DreamMugenState* state = &tStates->mStates[gMugenStateDefParseState.mCurrentGroup];
+	int newAmount = state->mControllerAmount + (int)gMugenStateDefParseState.mControllers.size();
+	DreamMugenStateController* controllers = (DreamMugenStateController*)allocMemory(sizeof(DreamMugenStateController) * newAmount);
+	if (state->mControllerAmount) {
+		memcpy(controllers, state->mControllers, sizeof(DreamMugenStateController) * state->mControllerAmount);
+		freeMemory(state->mControllers);
+	}
+	memcpy(controllers + state->mControllerAmount, gMugenStateDefParseState.mControllers.data(), sizeof(DreamMugenStateController) * gMugenStateDefParseState.mControllers.size());
+
+	state->mControllers = controllers;
+	state->mControllerAmount = newAmount;
+	gMugenStateDefParseState.mControllers.clear();
+}
+
 static void handleMugenStateDefType(DreamMugenState* tState, MugenDefScriptGroupElement* tElement) {
 	char* type = getAllocatedMugenDefStringVariableAsElement(tElement);
 	turnStringLowercase(type);
@@ -235,6 +256,7 @@ static void removeState(DreamMugenStates* tStates, int tState) {
 }
 
 static void handleMugenStateDef(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
+	flushParsedStateControllers(tStates);
 
 	DreamMugenState state;
 
@@ -257,7 +279,8 @@ static void handleMugenStateDef(DreamMugenStates* tStates, MugenDefScriptGroup*
 	state.mHasFacePlayer2Info = 0;
 	state.mHasPriority = 0;
 
-	state.mControllers = new_vector();
+	state.mControllers = NULL;
+	state.mControllerAmount = 0;
 
 	MugenStateDefCaller caller;
 	caller.mState = &state;
@@ -278,11 +301,11 @@ static int isMugenStateController(const char* tName) {
 }
 
 static void handleMugenStateControllerInDefGroup(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
-	DreamMugenState* state = &tStates->mStates[gMugenStateDefParseState.mCurrentGroup];
+	(void)tStates;
 
-	DreamMugenStateController* controller = parseDreamMugenStateControllerFromGroup(tGroup);
-
-	vector_push_back_owned(&state->mControllers, controller);
+	DreamMugenStateController controller;
+	parseDreamMugenStateControllerFromGroup(&controller, tGroup);
+	gMugenStateDefParseState.mControllers.push_back(controller);
 }
 
 static void handleSingleMugenStateDefGroup(DreamMugenStates* tStates, MugenDefScriptGroup* tGroup) {
@@ -306,21 +329,79 @@ static void loadMugenStateDefinitionsFromScript(DreamMugenStates* tStates, Mugen
 		
 		current = current->mNext;
 	}
+	flushParsedStateControllers(tStates);
+}
+
+static void clearStateTable(DreamMugenStates* tStates) {
+	tStates->mSortedStates.clear();
+	tStates->mDirectStates.clear();
+	tStates->mDirectStateOffset = 0;
+}
+
+static void rebuildStateTable(DreamMugenStates* tStates) {
+	clearStateTable(tStates);
+	if (tStates->mStates.empty()) return;
+
+	tStates->mSortedStates.reserve(tStates->mStates.size());
+	std::map<int, DreamMugenState>::iterator it = tStates->mStates.begin();
+	while (it != tStates->mStates.end()) {
+		DreamMugenStateTableEntry entry;
+		entry.mID = it->first;
+		entry.mState = &it->second;
+		tStates->mSortedStates.push_back(entry);
+		it++;
+	}
+
+	int minimumID = tStates->mSortedStates.front().mID;
+	int maximumID = tStates->mSortedStates.back().mID;
+	if ((int64_t)maximumID - minimumID >= MAXIMUM_DIRECT_STATE_TABLE_SIZE) return;
+
+	tStates->mDirectStateOffset = minimumID;
+	tStates->mDirectStates.assign(maximumID - minimumID + 1, NULL);
+	for (size_t i = 0; i < tStates->mSortedStates.size(); i++) {
+		tStates->mDirectStates[tStates->mSortedStates[i].mID - minimumID] = tStates->mSortedStates[i].mState;
+	}
 }
 
 void loadDreamMugenStateDefinitionsFromFile(DreamMugenStates* tStates, char* tPath) {
 	MugenDefScript script; 
 	loadMugenDefScript(&script, tPath);
-	loadMugenStateDefinitionsFromScript(tStates, &script);
+	loadDreamMugenStateDefinitionsFromScript(tStates, &script);
 	unloadMugenDefScript(script);
 }
 
+void loadDreamMugenStateDefinitionsFromScript(DreamMugenStates* tStates, MugenDefScript* tScript) {
+	loadMugenStateDefinitionsFromScript(tStates, tScript);
+	rebuildStateTable(tStates);
+}
+
 DreamMugenStates createEmptyMugenStates() {
 	DreamMugenStates ret;
 	stl_new_map(ret.mStates);
+	clearStateTable(&ret);
 	return ret;
 }
 
+DreamMugenState* getDreamMugenStateOrNull(DreamMugenStates* tStates, int tID) {
+	if (!tStates->mDirectStates.empty()) {
+		int index = tID - tStates->mDirectStateOffset;
+		if (index < 0 || index >= (int)tStates->mDirectStates.size()) return NULL;
+		return tStates->mDirectStates[index];
+	}
+
+	int left = 0;
+	int right = (int)tStates->mSortedStates.size() - 1;
+	while (left <= right) {
+		int middle = left + (right - left) / 2;
+		int currentID = tStates->mSortedStates[middle].mID;
+		if (currentID == tID) return tStates->mSortedStates[middle].mState;
+		else if (currentID < tID) left = middle + 1;
+		else right = middle - 1;
+	}
+
+	return NULL;
+}
+
 static DreamMugenConstants makeEmptyMugenConstants() {
 	DreamMugenConstants ret;
 	ret.mStates = createEmptyMugenStates();
@@ -459,16 +540,16 @@ DreamMugenConstants loadDreamMugenConstantsFile(char * tPath)
 {
 	MugenDefScript script; 
 	loadMugenDefScript(&script, tPath);
-	DreamMugenConstants ret = makeEmptyMugenConstants();
-	loadMugenConstantsFromScript(&ret, &script);
+	DreamMugenConstants ret = loadDreamMugenConstantsFromScript(&script);
 	unloadMugenDefScript(script);
 	return ret;
 }
 
-static void unloadSingleController(void* tCaller, void* tData) {
-	(void)tCaller;
-	DreamMugenStateController* e = (DreamMugenStateController*)tData;
-	unloadDreamMugenStateController(e);
+DreamMugenConstants loadDreamMugenConstantsFromScript(MugenDefScript* tScript)
+{
+	DreamMugenConstants ret = makeEmptyMugenConstants();
+	loadMugenConstantsFromScript(&ret, tScript);
+	return ret;
 }
 
 static void unloadSingleState(DreamMugenState& e) {
@@ -497,8 +578,12 @@ static void unloadSingleState(DreamMugenState& e) {
 		destroyDreamMugenAssignment(e.mPriority);
 	}
 
-	vector_map(&e.mControllers, unloadSingleController, NULL);
-	delete_vector(&e.mControllers);
+	for (int i = 0; i < e.mControllerAmount; i++) {
+		unloadDreamMugenStateController(&e.mControllers[i]);
+	}
+	if (e.mControllerAmount) {
+		freeMemory(e.mControllers);
+	}
 }
 
 static int unloadSingleStateCB(void* tCaller, DreamMugenState& e) {
@@ -512,9 +597,124 @@ static int unloadSingleStateCB(void* tCaller, DreamMugenState& e) {
 static void unloadMugenStates(DreamMugenStates* tStates) {
 	stl_int_map_remove_predicate(tStates->mStates, unloadSingleStateCB);
 	stl_delete_map(tStates->mStates);
+	clearStateTable(tStates);
 }
 
 void unloadDreamMugenConstantsFile(DreamMugenConstants * tConstants)
 {
 	unloadMugenStates(&tConstants->mStates);
 }
+
+typedef struct {
+	DreamMugenConstantsHeader mHeader;
+	DreamMugenConstantsSizeData mSizeData;
+	DreamMugenConstantsVelocityData mVelocityData;
+	DreamMugenConstantsMovementData mMovementData;
+
+	DreamMugenState* mStates;
+	int mStateAmount;
+} DreamMugenConstantsCacheImage;
+
+uint32_t getDreamMugenConstantsCacheLayoutStamp()
+{
+	uint32_t ret = addDreamCharacterCacheImageLayoutStamp(getDreamCharacterCacheImageLayoutStamp(), DREAM_CHARACTER_CACHE_BUILD_ID);
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenConstantsCacheImage));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, (uint32_t)sizeof(DreamMugenState));
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, getDreamAssignmentCacheLayoutStamp());
+	ret = addDreamCharacterCacheImageLayoutStamp(ret, getDreamMugenStateControllerCacheLayoutStamp());
+	return ret;
+}
+
+static void writeStateAssignmentCacheImage(DreamCharacterCacheImage* tImage, uint32_t tSlot, int tIsSet, DreamMugenAssignment* tAssignment) {
+	writeDreamMugenAssignmentCacheImage(tImage, tSlot, tIsSet ? tAssignment : NULL);
+}
+
+static void writeStateCacheImage(DreamCharacterCacheImage* tImage, uint32_t tOffset, DreamMugenState* tState) {
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mAnimation), tState->mIsChangingAnimation, tState->mAnimation);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mVelocity), tState->mIsSettingVelocity, tState->mVelocity);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mControl), tState->mIsChangingControl, tState->mControl);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mSpritePriority), tState->mIsChangingSpritePriority, tState->mSpritePriority);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mPowerAdd), tState->mIsAddingPower, tState->mPowerAdd);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mJuggleRequired), tState->mDoesRequireJuggle, tState->mJuggleRequired);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mDoHitDefinitionsPersist), tState->mDoesHaveHitDefinitionsPersist, tState->mDoHitDefinitionsPersist);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mDoMoveHitInfosPersist), tState->mDoesHaveMoveHitInfosPersist, tState->mDoMoveHitInfosPersist);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mDoesHitCountPersist), tState->mDoesHaveHitCountPersist, tState->mDoesHitCountPersist);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mDoesFacePlayer2), tState->mHasFacePlayer2Info, tState->mDoesFacePlayer2);
+	writeStateAssignmentCacheImage(tImage, tOffset + offsetof(DreamMugenState, mPriority), tState->mHasPriority, tState->mPriority);
+
+	if (!tState->mControllerAmount) {
+		setDreamCharacterCacheImagePointer(tImage, tOffset + offsetof(DreamMugenState, mControllers), NULL);
+		return;
+	}
+
+	setDreamCharacterCacheImagePointer(tImage, tOffset + offsetof(DreamMugenState, mControllers), tState->mControllers);
+	int isNew;
+	const uint32_t controllerOffset = addDreamCharacterCacheImageBlock(tImage, tState->mControllers, sizeof(DreamMugenStateController) * tState->mControllerAmount, &isNew);
+	for (int i = 0; i < tState->mControllerAmount; i++) {
+		writeDreamMugenStateControllerCacheImage(tImage, controllerOffset + i * sizeof(DreamMugenStateController), &tState->mControllers[i]);
+	}
+}
+
+void writeDreamMugenConstantsCacheImage(DreamCharacterCacheImage* tImage, DreamMugenConstants* tConstants)
+{
+	DreamMugenConstantsCacheImage root;
+	memset(&root, 0, sizeof(DreamMugenConstantsCacheImage));
+	root.mHeader = tConstants->mHeader;
+	root.mSizeData = tConstants->mSizeData;
+	root.mVelocityData = tConstants->mVelocityData;
+	root.mMovementData = tConstants->mMovementData;
+	root.mStateAmount = (int)tConstants->mStates.mStates.size();
+
+	// the root is the first block, so it sits at the start of the image
+	int isNew;
+	const uint32_t rootOffset = addDreamCharacterCacheImageBlock(tImage, &root, sizeof(DreamMugenConstantsCacheImage), &isNew);
+
+	vector<DreamMugenState> states;
+	states.reserve(tConstants->mStates.mStates.size());
+	for (auto& state : tConstants->mStates.mStates) {
+		states.push_back(state.second);
+	}
+	if (states.empty()) {
+		setDreamCharacterCacheImagePointer(tImage, rootOffset + offsetof(DreamMugenConstantsCacheImage, mStates), NULL);
+		return;
+	}
+
+	setDreamCharacterCacheImagePointer(tImage, rootOffset + offsetof(DreamMugenConstantsCacheImage, mStates), states.data());
+	const uint32_t stateOffset = addDreamCharacterCacheImageBlock(tImage, states.data(), (uint32_t)(sizeof(DreamMugenState) * states.size()), &isNew);
+	for (size_t i = 0; i < states.size(); i++) {
+		writeStateCacheImage(tImage, (uint32_t)(stateOffset + i * sizeof(DreamMugenState)), &states[i]);
+	}
+}
+
+int loadDreamMugenConstantsFromCacheImage(DreamMugenConstants* oConstants, uint8_t* tImage, uint32_t tImageSize)
+{
+	if (tImageSize < sizeof(DreamMugenConstantsCacheImage)) return 0;
+
+	DreamMugenConstantsCacheImage* root = (DreamMugenConstantsCacheImage*)tImage;
+	oConstants->mHeader = root->mHeader;
+	oConstants->mSizeData = root->mSizeData;
+	oConstants->mVelocityData = root->mVelocityData;
+	oConstants->mMovementData = root->mMovementData;
+
+	oConstants->mStates = createEmptyMugenStates();
+	for (int i = 0; i < root->mStateAmount; i++) {
+		DreamMugenState* state = &root->mStates[i];
+		for (int j = 0; j < state->mControllerAmount; j++) {
+			restoreDreamMugenStateControllerFromCacheImage(&state->mControllers[j]);
+		}
+		oConstants->mStates.mStates[state->mID] = *state;
+	}
+	rebuildStateTable(&oConstants->mStates);
+	return 1;
+}
+
+void releaseDreamMugenConstantsCacheImage(uint8_t* tImage)
+{
+	DreamMugenConstantsCacheImage* root = (DreamMugenConstantsCacheImage*)tImage;
+	for (int i = 0; i < root->mStateAmount; i++) {
+		DreamMugenState* state = &root->mStates[i];
+		for (int j = 0; j < state->mControllerAmount; j++) {
+			releaseDreamMugenStateControllerFromCacheImage(&state->mControllers[j]);
+		}
+	}
+}
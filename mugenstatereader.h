@@ -1,10 +1,13 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include <prism/animation.h>
+#include <prism/mugendefreader.h>
 
 #include "mugenassignment.h"
+#include "charactercacheimage.h"
 
 enum DreamMugenStateControllerType : uint8_t{
 
@@ -159,7 +162,12 @@ enum DreamMugenStoryStateControllerType : uint8_t {
 
 typedef struct {
 	DreamMugenAssignment* mAssignment;
-
+	uint8_t mDependencies;
+	uint8_t mCachedResult;
+	void* mCachedOwner;
+	uint32_t mCachedVariableStamp;
+	uint32_t mCachedStateStamp;
+	uint32_t mCachedCommandStamp;
 } DreamMugenStateControllerTrigger;
 
 typedef struct {
@@ -293,7 +301,8 @@ typedef enum {
 } DreamMugenStatePhysics;
 
 typedef struct {
-	Vector mControllers;
+	DreamMugenStateController* mControllers;
+	int mControllerAmount;
 	int mID;
 	DreamMugenStateType mType;
 	DreamMugenStateMoveType mMoveType;
@@ -333,8 +342,17 @@ typedef struct {
 	DreamMugenAssignment* mPriority;
 } DreamMugenState;
 
+typedef struct {
+	int mID;
+	DreamMugenState* mState;
+} DreamMugenStateTableEntry;
+
 typedef struct {
 	std::map<int, DreamMugenState> mStates;
+
+	std::vector<DreamMugenStateTableEntry> mSortedStates;
+	std::vector<DreamMugenState*> mDirectStates;
+	int mDirectStateOffset;
 } DreamMugenStates;
 
 typedef struct {
@@ -347,6 +365,13 @@ typedef struct {
 } DreamMugenConstants;
 
 DreamMugenConstants loadDreamMugenConstantsFile(char* tPath);
+DreamMugenConstants loadDreamMugenConstantsFromScript(MugenDefScript* tScript);
 void unloadDreamMugenConstantsFile(DreamMugenConstants* tConstants);
+uint32_t getDreamMugenConstantsCacheLayoutStamp();
+void writeDreamMugenConstantsCacheImage(DreamCharacterCacheImage* tImage, DreamMugenConstants* tConstants);
+int loadDreamMugenConstantsFromCacheImage(DreamMugenConstants* oConstants, uint8_t* tImage, uint32_t tImageSize);
+void releaseDreamMugenConstantsCacheImage(uint8_t* tImage);
 void loadDreamMugenStateDefinitionsFromFile(DreamMugenStates* tStates, char* tPath);
-DreamMugenStates createEmptyMugenStates();
\ No newline at end of file
+void loadDreamMugenStateDefinitionsFromScript(DreamMugenStates* tStates, MugenDefScript* tScript);
+DreamMugenStates createEmptyMugenStates();
+DreamMugenState* getDreamMugenStateOrNull(DreamMugenStates* tStates, int tID);
\ No newline at end of file
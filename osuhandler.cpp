@@ -485,7 +485,7 @@ static void updateActiveHitObjectRingScale(ActiveHitObject* e) {
 }
 
 static int hasPressedOsuButtonFlank(int i){
-	return hasPressedAFlankSingle(i) || hasPressedBFlankSingle(i) || hasPressedXFlankSingle(i) || hasPressedYFlankSingle(i) || hasPressedStartFlankSingle(i);
+	return hasDreamControllerPressedAFlank(i) || hasDreamControllerPressedBFlank(i) || hasDreamControllerPressedXFlank(i) || hasDreamControllerPressedYFlank(i) || hasDreamControllerPressedStartFlank(i);
 
 }
 
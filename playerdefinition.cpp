@@ -3,6 +3,10 @@
 #include <assert.h>
 #include <string.h>
 #include <algorithm>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <vector>
 
 #include <prism/file.h>
 #include <prism/physicshandler.h>
@@ -20,6 +24,8 @@
 
 #include "mugencommandreader.h"
 #include "mugenstatereader.h"
+#include "charactercache.h"
+#include "fileindex.h"
 #include "mugencommandhandler.h"
 #include "mugenstatehandler.h"
 #include "playerhitdata.h"
@@ -48,10 +54,16 @@ using namespace std;
 #define CENTER_POINT_Z 49
 #define PLAYER_DEBUG_TEXT_Z 79
 
+typedef struct {
+	std::deque<DreamPlayer> mSlots;
+	std::vector<int> mFreeSlots;
+} DreamHelperPool;
+
 static struct {
 	DreamPlayerHeader mPlayerHeader[2];
 	DreamPlayer mPlayers[2];
 	int mUniqueIDCounter;
+	uint32_t mDependencyStampCounter;
 	int mIsInTrainingMode;
 	int mIsCollisionDebugActive;
 	MemoryStack* mMemoryStack;
@@ -59,7 +71,9 @@ static struct {
 	int mHasLoadedSprites;
 
 	List mAllPlayers; // contains DreamPlayer
-	std::map<int, DreamPlayer> mHelperStore;
+	std::deque<DreamHelperPool> mHelperPools; // a deque, so growing it keeps the pooled helpers in place
+	std::map<std::string, int> mHelperPoolSizes; // per character definition, kept between fights
+	std::map<int, DreamPlayer> mProjectileStore;
 
 	double mTimeDilatationNow;
 	int mTimeDilatationUpdates;
@@ -79,25 +93,6 @@ static void loadPlayerHeaderFromScript(DreamPlayerHeader* tHeader, MugenDefScrip
 	if (!tHeader->mConstants.mLocalCoordinates.y) tHeader->mConstants.mLocalCoordinates.y = 240;
 }
 
-static void loadOptionalStateFiles(MugenDefScript* tScript, char* tPath, DreamPlayer* tPlayer) {
-	char file[200];
-	char scriptPath[1024];
-	char name[100];
-
-	int i;
-	for (i = 0; i < 100; i++) {
-		sprintf(name, "st%d", i);
-		getMugenDefStringOrDefault(file, tScript, "Files", name, "");
-		sprintf(scriptPath, "%s%s", tPath, file);
-		if (!isFile(scriptPath)) continue;
-		
-		loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
-		logMemoryPlatform();
-	}
-
-	
-}
-
 static void setPlayerFaceDirection(DreamPlayer* p, FaceDirection tDirection);
 
 static void setPlayerExternalDependencies(DreamPlayer* tPlayer) {
@@ -128,45 +123,16 @@ static void loadPlayerFiles(char* tPath, DreamPlayer* tPlayer, MugenDefScript* t
 	getMugenDefStringOrDefault(file, tScript, "Files", "cmd", "");
 	assert(strcmp("", file));
 	sprintf(scriptPath, "%s%s", path, file);
-	tPlayer->mHeader->mFiles.mCommands = loadDreamMugenCommandFile(scriptPath);
+	tPlayer->mHeader->mFiles.mCommands = loadDreamMugenCommandFileCached(scriptPath);
 	logMemoryPlatform();
 	tPlayer->mCommandID = registerDreamMugenCommands(tPlayer->mControllerID, &tPlayer->mHeader->mFiles.mCommands);
 	logMemoryPlatform();
 
 	setDreamAssignmentCommandLookupID(tPlayer->mCommandID);
-	getMugenDefStringOrDefault(file, tScript, "Files", "cns", "");
-	assert(strcmp("", file));
-	sprintf(scriptPath, "%s%s", path, file);
-	tPlayer->mHeader->mFiles.mConstants = loadDreamMugenConstantsFile(scriptPath);
-	logMemoryPlatform();
-	
-	getMugenDefStringOrDefault(file, tScript, "Files", "stcommon", "");
-	sprintf(scriptPath, "%s%s", path, file);
-	if (isFile(scriptPath)) {
-		loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
-	}
-	else {
-		sprintf(scriptPath, "assets/data/%s", file);
-		if (isFile(scriptPath)) {
-			loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
-		}
-	}
-	logMemoryPlatform();
-
-	getMugenDefStringOrDefault(file, tScript, "Files", "st", "");
-	sprintf(scriptPath, "%s%s", path, file);
-	if (isFile(scriptPath)) {
-		loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
-	}
-	logMemoryPlatform();
-
-	loadOptionalStateFiles(tScript, path, tPlayer);
-
-	getMugenDefStringOrDefault(file, tScript, "Files", "cmd", "");
-	assert(strcmp("", file));
-	sprintf(scriptPath, "%s%s", path, file);
-	loadDreamMugenStateDefinitionsFromFile(&tPlayer->mHeader->mFiles.mConstants.mStates, scriptPath);
-
+	vector<string> statePaths;
+	getDreamCharacterStateSourcePaths(tScript, path, statePaths);
+	assert(statePaths.size() >= 2);
+	loadDreamPlayerStatesCached(tPlayer, statePaths);
 	resetDreamAssignmentCommandLookupID();
 
 	getMugenDefStringOrDefault(file, tScript, "Files", "anim", "");
@@ -192,7 +158,7 @@ static void loadPlayerFiles(char* tPath, DreamPlayer* tPlayer, MugenDefScript* t
 
 	getMugenDefStringOrDefault(file, tScript, "Files", "sound", "");
 	sprintf(scriptPath, "%s%s", path, file);
-	if (isFile(scriptPath) && !isOnDreamcast()) {
+	if (isIndexedFile(scriptPath) && !isOnDreamcast()) {
 		setSoundEffectCompression(1);
 		tPlayer->mHeader->mFiles.mSounds = loadMugenSoundFile(scriptPath);
 		setSoundEffectCompression(0);
@@ -221,6 +187,10 @@ static void initHitDefAttributeSlot(DreamHitDefAttributeSlot* tSlot) {
 	tSlot->mNow = 0;
 }
 
+static void updateDependencyStamp(uint32_t* oStamp) {
+	*oStamp = ++gPlayerDefinition.mDependencyStampCounter;
+}
+
 static void resetHelperState(DreamPlayer* p) {
 	p->mHelpers = new_list();
 	p->mProjectiles = new_int_map();
@@ -301,6 +271,8 @@ static void resetHelperState(DreamPlayer* p) {
 	p->mComboCounter = 0;
 	p->mDisplayedComboCounter = 0;
 	p->mIsDestroyed = 0;
+	updateDependencyStamp(&p->mVariableStamp);
+	updateDependencyStamp(&p->mStateStamp);
 
 	int i;
 	for (i = 0; i < 2; i++) {
@@ -383,6 +355,150 @@ static void loadPlayerDebug(DreamPlayer* p) {
 	setMugenTextAlignment(p->mDebug.mCollisionTextID, MUGEN_TEXT_ALIGNMENT_CENTER);
 }
 
+static void parkHelperPoolSlot(DreamPlayer* p) {
+	p->mIsDestroyed = 1;
+	disableDreamRegisteredStateMachine(p->mStateMachineID);
+	pauseHandledPhysics(p->mPhysicsElement);
+	*getHandledPhysicsVelocityReference(p->mPhysicsElement) = makePosition(0, 0, 0);
+	pauseMugenAnimation(p->mAnimationElement);
+	pauseMugenAnimation(p->mShadow.mAnimationElement);
+	pauseMugenAnimation(p->mReflection.mAnimationElement);
+	setMugenAnimationVisibility(p->mAnimationElement, 0);
+	setMugenAnimationVisibility(p->mShadow.mAnimationElement, 0);
+	setMugenAnimationVisibility(p->mReflection.mAnimationElement, 0);
+
+	char text[2];
+	text[0] = '\0';
+	changeMugenText(p->mDebug.mCollisionTextID, text);
+}
+
+static void ensureHelperPoolRoot(int tRootID) {
+	while (tRootID >= (int)gPlayerDefinition.mHelperPools.size()) {
+		gPlayerDefinition.mHelperPools.push_back(DreamHelperPool());
+	}
+}
+
+static DreamHelperPool* getHelperPool(int tRootID) {
+	ensureHelperPoolRoot(tRootID);
+	return &gPlayerDefinition.mHelperPools[tRootID];
+}
+
+static DreamPlayer* addHelperPoolSlot(DreamPlayer* tRoot) {
+	DreamHelperPool* pool = getHelperPool(tRoot->mRootID);
+	pool->mSlots.push_back(*tRoot);
+	DreamPlayer* helper = &pool->mSlots.back();
+	helper->mHelperIDInStore = (int)pool->mSlots.size() - 1;
+	helper->mIsHelper = 1;
+
+	setPlayerExternalDependencies(helper);
+	loadPlayerShadow(helper);
+	loadPlayerReflection(helper);
+	loadPlayerDebug(helper);
+	setDreamRegisteredStateToPooledMode(helper->mStateMachineID);
+	parkHelperPoolSlot(helper);
+	return helper;
+}
+
+static void loadHelperPool(DreamPlayer* tRoot) {
+	DreamHelperPool* pool = getHelperPool(tRoot->mRootID);
+	pool->mSlots.clear();
+	pool->mFreeSlots.clear();
+
+	int size = gPlayerDefinition.mHelperPoolSizes[tRoot->mHeader->mFiles.mDefinitionPath];
+	int i;
+	for (i = 0; i < size; i++) {
+		addHelperPoolSlot(tRoot);
+		pool->mFreeSlots.push_back(size - 1 - i);
+	}
+}
+
+static void unloadHelperPool(DreamPlayer* tRoot) {
+	DreamHelperPool* pool = getHelperPool(tRoot->mRootID);
+	int& size = gPlayerDefinition.mHelperPoolSizes[tRoot->mHeader->mFiles.mDefinitionPath];
+	size = std::max(size, (int)pool->mSlots.size());
+	pool->mSlots.clear();
+	pool->mFreeSlots.clear();
+}
+
+static DreamPlayer* getFreeHelperPoolSlot(DreamPlayer* tRoot) {
+	DreamHelperPool* pool = getHelperPool(tRoot->mRootID);
+	if (pool->mFreeSlots.empty()) {
+		return addHelperPoolSlot(tRoot);
+	}
+
+	int slot = pool->mFreeSlots.back();
+	pool->mFreeSlots.pop_back();
+	return &pool->mSlots[slot];
+}
+
+static void releaseHelperPoolSlot(DreamPlayer* p) {
+	getHelperPool(p->mRootID)->mFreeSlots.push_back(p->mHelperIDInStore);
+}
+
+static void copyPlayerToHelperPoolSlot(DreamPlayer* tHelper, DreamPlayer* tParent) {
+	int helperIDInStore = tHelper->mHelperIDInStore;
+	PhysicsHandlerElement* physicsElement = tHelper->mPhysicsElement;
+	MugenAnimationHandlerElement* animationElement = tHelper->mAnimationElement;
+	MugenAnimationHandlerElement* shadowAnimationElement = tHelper->mShadow.mAnimationElement;
+	MugenAnimationHandlerElement* reflectionAnimationElement = tHelper->mReflection.mAnimationElement;
+	int collisionTextID = tHelper->mDebug.mCollisionTextID;
+	int stateMachineID = tHelper->mStateMachineID;
+
+	*tHelper = *tParent;
+	tHelper->mHelperIDInStore = helperIDInStore;
+	tHelper->mPhysicsElement = physicsElement;
+	tHelper->mAnimationElement = animationElement;
+	tHelper->mShadow.mAnimationElement = shadowAnimationElement;
+	tHelper->mReflection.mAnimationElement = reflectionAnimationElement;
+	tHelper->mDebug.mCollisionTextID = collisionTextID;
+	tHelper->mStateMachineID = stateMachineID;
+}
+
+static void resetHelperPoolAnimationElement(MugenAnimationHandlerElement* tElement, MugenAnimation* tAnimation, MugenSpriteFile* tSprites, Position tPosition, Vector3D tScale) {
+	changeMugenAnimation(tElement, tAnimation);
+	setMugenAnimationSprites(tElement, tSprites);
+	setMugenAnimationPosition(tElement, tPosition);
+	setMugenAnimationDrawScale(tElement, tScale);
+	setMugenAnimationDrawAngle(tElement, 0);
+	setMugenAnimationFaceDirection(tElement, 1);
+	setMugenAnimationSpeed(tElement, 1);
+	unpauseMugenAnimation(tElement);
+	setMugenAnimationVisibility(tElement, 1);
+}
+
+// same end state as setPlayerExternalDependencies and loading shadow, reflection and debug text, without registering anything new
+static void activateHelperPoolSlot(DreamPlayer* p) {
+	*getHandledPhysicsPositionReference(p->mPhysicsElement) = getDreamPlayerStartingPosition(p->mRootID, p->mHeader->mConstants.mLocalCoordinates.y);
+	*getHandledPhysicsVelocityReference(p->mPhysicsElement) = makePosition(0, 0, 0);
+	*getHandledPhysicsAccelerationReference(p->mPhysicsElement) = makePosition(0, 0, 0);
+	setHandledPhysicsSpeed(p->mPhysicsElement, 1);
+	resumeHandledPhysics(p->mPhysicsElement);
+	setPlayerPhysics(p, MUGEN_STATE_PHYSICS_STANDING);
+	setPlayerStateMoveType(p, MUGEN_STATE_MOVE_TYPE_IDLE);
+	setPlayerStateType(p, MUGEN_STATE_TYPE_STANDING);
+
+	Vector3D scale = p->mHeader->mFiles.mConstants.mSizeData.mScale;
+	MugenAnimation* animation = getMugenAnimation(&p->mHeader->mFiles.mAnimations, 0);
+	MugenSpriteFile* sprites = &p->mHeader->mFiles.mSprites;
+	Position pos = getDreamStageCoordinateSystemOffset(getPlayerCoordinateP(p));
+	p->mActiveAnimations = &p->mHeader->mFiles.mAnimations;
+	pos.z = PLAYER_Z;
+	resetHelperPoolAnimationElement(p->mAnimationElement, animation, sprites, pos, scale);
+	setMugenAnimationBlendType(p->mAnimationElement, BLEND_TYPE_NORMAL);
+	setMugenAnimationTransparency(p->mAnimationElement, 1);
+	setMugenAnimationCollisionDebug(p->mAnimationElement, gPlayerDefinition.mIsCollisionDebugActive);
+
+	p->mShadow.mShadowPosition = *getHandledPhysicsPositionReference(p->mPhysicsElement);
+	pos.z = SHADOW_Z;
+	resetHelperPoolAnimationElement(p->mShadow.mAnimationElement, animation, sprites, pos, makePosition(1, -getDreamStageShadowScaleY(), 1) * scale);
+
+	p->mReflection.mPosition = *getHandledPhysicsPositionReference(p->mPhysicsElement);
+	pos.z = REFLECTION_Z;
+	resetHelperPoolAnimationElement(p->mReflection.mAnimationElement, animation, sprites, pos, makePosition(1, -1, 1) * scale);
+
+	resetDreamRegisteredStateMachine(p->mStateMachineID);
+}
+
 static void loadSinglePlayerFromMugenDefinition(DreamPlayer* p)
 {
 	MugenDefScript script; 
@@ -406,7 +522,7 @@ void loadPlayers(MemoryStack* tMemoryStack) {
 	gPlayerDefinition.mTimeDilatationNow = 0.0;
 	gPlayerDefinition.mTimeDilatation = 1.0;
 	gPlayerDefinition.mTimeDilatationUpdates = 1;
-	gPlayerDefinition.mHelperStore.clear();
+	gPlayerDefinition.mProjectileStore.clear();
 	gPlayerDefinition.mAllPlayers = new_list();
 	list_push_back(&gPlayerDefinition.mAllPlayers, &gPlayerDefinition.mPlayers[0]);
 	list_push_back(&gPlayerDefinition.mAllPlayers, &gPlayerDefinition.mPlayers[1]);
@@ -421,6 +537,9 @@ void loadPlayers(MemoryStack* tMemoryStack) {
 		gPlayerDefinition.mPlayers[i].mControllerID = i;
 		loadSinglePlayerFromMugenDefinition(&gPlayerDefinition.mPlayers[i]);
 	}
+	for (i = 0; i < 2; i++) {
+		loadHelperPool(&gPlayerDefinition.mPlayers[i]);
+	}
 
 	gPlayerDefinition.mIsLoading = 0;
 	gPlayerDefinition.mHasLoadedSprites = 0;
@@ -446,6 +565,10 @@ void loadPlayerSprites() {
 	gPlayerDefinition.mHasLoadedSprites = 1;
 }
 
+void skipPlayerSprites() {
+	gPlayerDefinition.mHasLoadedSprites = 1; // animations keep running without sprites, only drawing needs them
+}
+
 static void unloadHelperStateWithoutFreeingOwnedHelpersAndProjectile(DreamPlayer* p) {
 	// projectiles shouldn't have helpers, so no need to move them
 	delete_list(&p->mHelpers);
@@ -457,6 +580,7 @@ static void unloadHelperStateWithoutFreeingOwnedHelpersAndProjectile(DreamPlayer
 
 static void unloadPlayerFiles(DreamPlayerHeader* tHeader) {
 	//unloadDreamMugenConstantsFile(&tHeader->mFiles.mConstants);
+	releaseDreamPlayerStatesCached(&tHeader->mFiles.mConstants);
 	unloadDreamMugenCommandFile(&tHeader->mFiles.mCommands);
 	//unloadMugenAnimationFile(&tHeader->mFiles.mAnimations);
 	//unloadMugenSpriteFile(&tHeader->mFiles.mSprites);
@@ -470,7 +594,7 @@ static void unloadSinglePlayer(DreamPlayer* /*p*/, DreamPlayerHeader* tHeader) {
 }
 
 static void unloadPlayerHeader(int i) {
-	gPlayerDefinition.mPlayerHeader[i].mFiles.mConstants.mStates.mStates = std::map<int, DreamMugenState>();
+	gPlayerDefinition.mPlayerHeader[i].mFiles.mConstants.mStates = createEmptyMugenStates();
 
 	gPlayerDefinition.mPlayerHeader[i].mCustomOverrides.mHasCustomDisplayName = 0;
 }
@@ -480,9 +604,10 @@ void unloadPlayers() {
 	for (i = 0; i < 2; i++) {
 		unloadPlayerHeader(i);
 		unloadSinglePlayer(&gPlayerDefinition.mPlayers[i], &gPlayerDefinition.mPlayerHeader[i]);
+		unloadHelperPool(&gPlayerDefinition.mPlayers[i]);
 	}
 
-	gPlayerDefinition.mHelperStore.clear();
+	gPlayerDefinition.mProjectileStore.clear();
 	//delete_list(&gPlayerDefinition.mAllPlayers);
 }
 
@@ -689,7 +814,7 @@ static void updateGettingUp(DreamPlayer* p) {
 	}
 
 	p->mLyingDownTime++;
-	if (hasPressedAnyButtonFlankSingle(p->mRootID)) p->mLyingDownTime++;
+	if (hasDreamControllerPressedAnyButtonFlank(p->mRootID)) p->mLyingDownTime++;
 	if (p->mLyingDownTime >= p->mHeader->mFiles.mConstants.mHeader.mLiedownTime) {
 		p->mIsLyingDown = 0;
 		changePlayerState(p, 5120);
@@ -1156,11 +1281,11 @@ static void updatePlayerHitShake(DreamPlayer* p) {
 }
 
 static void updatePlayerDestruction(DreamPlayer* p) {
-	if (gPlayerDefinition.mHelperStore.find(p->mHelperIDInStore) == gPlayerDefinition.mHelperStore.end()) {
-		logErrorFormat("Unable to delete helper %d %d, unable to find id %d in store. Ignoring.", p->mRootID, p->mID, p->mHelperIDInStore);
+	if (p->mHelperIDInStore < 0 || p->mHelperIDInStore >= (int)getHelperPool(p->mRootID)->mSlots.size()) {
+		logErrorFormat("Unable to delete helper %d %d, unable to find id %d in pool. Ignoring.", p->mRootID, p->mID, p->mHelperIDInStore);
 		return;
 	}
-	gPlayerDefinition.mHelperStore.erase(p->mHelperIDInStore);
+	releaseHelperPoolSlot(p);
 }
 
 static int updateSinglePlayer(DreamPlayer* p) {
@@ -1453,20 +1578,16 @@ static void setPlayerHitStates(DreamPlayer* p, DreamPlayer* tOtherPlayer) {
 	}
 }
 
-static int checkPlayerHitGuardFlagsAndReturnIfGuardable(DreamPlayer* tPlayer, char* tFlags) {
+static int checkPlayerHitGuardFlagsAndReturnIfGuardable(DreamPlayer* tPlayer, uint32_t tFlags) {
 	DreamMugenStateType type = getPlayerStateType(tPlayer);
-	char test[100];
-	strcpy(test, tFlags);
-	turnStringLowercase(test);
 
 	if (type == MUGEN_STATE_TYPE_STANDING) {
-
-		return strchr(test, 'h') != NULL || strchr(test, 'm') != NULL;
+		return (tFlags & (MUGEN_GUARD_FLAG_HIGH | MUGEN_GUARD_FLAG_MID)) != 0;
 	} else  if (type == MUGEN_STATE_TYPE_CROUCHING) {
-		return strchr(test, 'l') != NULL || strchr(test, 'm') != NULL;
+		return (tFlags & (MUGEN_GUARD_FLAG_LOW | MUGEN_GUARD_FLAG_MID)) != 0;
 	}
 	else  if (type == MUGEN_STATE_TYPE_AIR) {
-		return strchr(test, 'a') != NULL;
+		return (tFlags & MUGEN_GUARD_FLAG_AIR) != 0;
 	}
 	else {
 		logWarningFormat("Unrecognized player type %d. Defaulting to unguardable.", type);
@@ -1529,7 +1650,7 @@ static void setPlayerHit(DreamPlayer* p, DreamPlayer* tOtherPlayer, void* tHitDa
 		setPlayerIsFacingRight(p, !getActiveHitDataIsFacingRight(p));
 	}
 
-	if (getPlayerUnguardableFlag(tOtherPlayer) || (isPlayerGuarding(p) && !checkPlayerHitGuardFlagsAndReturnIfGuardable(p, getActiveHitDataGuardFlag(p)))) {
+	if (getPlayerUnguardableFlag(tOtherPlayer) || (isPlayerGuarding(p) && !checkPlayerHitGuardFlagsAndReturnIfGuardable(p, getActiveHitDataGuardFlags(p)))) {
 		setPlayerUnguarding(p);
 	}
 
@@ -1637,76 +1758,24 @@ static void playPlayerHitSpark(DreamPlayer* p1, DreamPlayer* p2, int tIsInPlayer
 	playDreamHitSpark(tSparkOffset, p2, tIsInPlayerFile, tNumber, getActiveHitDataIsFacingRight(p1), getPlayerCoordinateP(p2), getPlayerCoordinateP(p2));
 }
 
-typedef struct {
-	int mFound;
-	MugenAttackType mType;
-	MugenAttackClass mClass;
-} HitDefAttributeFlag2Caller;
-
-static void checkSingleFlag2InHitDefAttributeSlot(HitDefAttributeFlag2Caller* tCaller, char* tFlag) {
-
-	if (tCaller->mClass == MUGEN_ATTACK_CLASS_NORMAL) {
-		if (tFlag[0] != 'n') return;
-	}
-	else if (tCaller->mClass == MUGEN_ATTACK_CLASS_SPECIAL) {
-		if (tFlag[0] != 's') return;
-	}
-	else if (tCaller->mClass == MUGEN_ATTACK_CLASS_HYPER) {
-		if (tFlag[0] != 'h') return;
-	}
-	else {
-		logWarningFormat("Unrecognized attack class %d. Defaulting to not found.", tCaller->mClass);
-		return;
-	}
-
-	if (tCaller->mType == MUGEN_ATTACK_TYPE_ATTACK) {
-		if (tFlag[1] != 'a') return;
-	} 
-	else if (tCaller->mType == MUGEN_ATTACK_TYPE_PROJECTILE) {
-		if (tFlag[1] != 'p') return;
-	}
-	else if (tCaller->mType == MUGEN_ATTACK_TYPE_THROW) {
-		if (tFlag[1] != 't') return;
-	}
-	else {
-		logWarningFormat("Unrecognized attack type %d. Defaulting to not found.", tCaller->mType);
-		return;
-	}
-
-	tCaller->mFound = 1;
+static int checkSingleNoHitDefSlotFlags(const DreamHitDefAttributeSlot* tSlot, uint32_t tStateTypeFlag, uint32_t tAttackFlag) {
+	if (!tSlot->mIsActive) return 1;
+	if (tSlot->mStateTypeFlags & tStateTypeFlag) return tSlot->mIsHitBy;
+	if (tSlot->mAttackFlags & tAttackFlag) return tSlot->mIsHitBy;
+	else return !tSlot->mIsHitBy;
 }
 
 static int checkSingleNoHitDefSlot(DreamHitDefAttributeSlot* tSlot, DreamPlayer* p2) {
 	if (!tSlot->mIsActive) return 1;
 
 	DreamMugenStateType type = getHitDataType(p2);
-
-	if (type == MUGEN_STATE_TYPE_STANDING) {
-		if (strchr(tSlot->mFlag1, 's') != NULL) return tSlot->mIsHitBy;
-	} 
-	else if (type == MUGEN_STATE_TYPE_CROUCHING) {
-		if (strchr(tSlot->mFlag1, 'c') != NULL) return tSlot->mIsHitBy;
-	}
-	else if (type == MUGEN_STATE_TYPE_AIR) {
-		if (strchr(tSlot->mFlag1, 'a') != NULL) return tSlot->mIsHitBy;
-	}
-	else {
+	const uint32_t stateTypeFlag = getHitDefAttributeStateTypeFlag(type);
+	if (!stateTypeFlag) {
 		logWarningFormat("Invalid hitdef type %d. Defaulting to not not hit.", type);
 		return 0;
 	}
 
-	HitDefAttributeFlag2Caller caller;
-	caller.mFound = 0;
-	caller.mType = getHitDataAttackType(p2);
-	caller.mClass = getHitDataAttackClass(p2);
-
-	int i;
-	for (i = 0; i < tSlot->mFlag2Amount; i++) {
-		checkSingleFlag2InHitDefAttributeSlot(&caller, tSlot->mFlag2[i]);
-	}
-
-	if (caller.mFound) return tSlot->mIsHitBy;
-	else return !tSlot->mIsHitBy;
+	return checkSingleNoHitDefSlotFlags(tSlot, stateTypeFlag, getHitDefAttributeAttackFlag(getHitDataAttackClass(p2), getHitDataAttackType(p2)));
 }
 
 static int checkActiveHitDefAttributeSlots(DreamPlayer* p, DreamPlayer* p2) {
@@ -1883,7 +1952,9 @@ void setPlayerStateType(DreamPlayer* p, DreamMugenStateType tType)
 		return;
 	}
 
+	if (p->mStateType == tType) return;
 	p->mStateType = tType;
+	updateDependencyStamp(&p->mStateStamp);
 }
 
 DreamMugenStateMoveType getPlayerStateMoveType(DreamPlayer* p)
@@ -1895,7 +1966,9 @@ void setPlayerStateMoveType(DreamPlayer* p, DreamMugenStateMoveType tType)
 {
 	if (tType == MUGEN_STATE_MOVE_TYPE_UNCHANGED) return;
 
+	if (p->mMoveType == tType) return;
 	p->mMoveType = tType;
+	updateDependencyStamp(&p->mStateStamp);
 }
 
 int getPlayerControl(DreamPlayer* p)
@@ -1905,7 +1978,9 @@ int getPlayerControl(DreamPlayer* p)
 
 void setPlayerControl(DreamPlayer* p, int tNewControl)
 {
+	if (p->mIsInControl == tNewControl) return;
 	p->mIsInControl = tNewControl;
+	updateDependencyStamp(&p->mStateStamp);
 }
 
 
@@ -2009,6 +2084,7 @@ int * getPlayerVariableReference(DreamPlayer * p, int tIndex)
 void setPlayerVariable(DreamPlayer* p, int tIndex, int tValue)
 {
 	p->mVars[tIndex] = tValue;
+	updateDependencyStamp(&p->mVariableStamp);
 }
 
 void addPlayerVariable(DreamPlayer * p, int tIndex, int tValue)
@@ -2026,6 +2102,7 @@ int getPlayerSystemVariable(DreamPlayer* p, int tIndex)
 void setPlayerSystemVariable(DreamPlayer* p, int tIndex, int tValue)
 {
 	p->mSystemVars[tIndex] = tValue;
+	updateDependencyStamp(&p->mVariableStamp);
 }
 
 void addPlayerSystemVariable(DreamPlayer * p, int tIndex, int tValue)
@@ -2043,6 +2120,7 @@ double getPlayerFloatVariable(DreamPlayer* p, int tIndex)
 void setPlayerFloatVariable(DreamPlayer* p, int tIndex, double tValue)
 {
 	p->mFloatVars[tIndex] = tValue;
+	updateDependencyStamp(&p->mVariableStamp);
 }
 
 void addPlayerFloatVariable(DreamPlayer * p, int tIndex, double tValue)
@@ -2060,6 +2138,7 @@ double getPlayerSystemFloatVariable(DreamPlayer* p, int tIndex)
 void setPlayerSystemFloatVariable(DreamPlayer* p, int tIndex, double tValue)
 {
 	p->mSystemFloatVars[tIndex] = tValue;
+	updateDependencyStamp(&p->mVariableStamp);
 }
 
 void addPlayerSystemFloatVariable(DreamPlayer * p, int tIndex, double tValue)
@@ -2069,6 +2148,26 @@ void addPlayerSystemFloatVariable(DreamPlayer * p, int tIndex, double tValue)
 	setPlayerSystemFloatVariable(p, tIndex, cur);
 }
 
+uint32_t getPlayerVariableStamp(DreamPlayer* p)
+{
+	return p->mVariableStamp;
+}
+
+uint32_t getPlayerStateStamp(DreamPlayer* p)
+{
+	return p->mStateStamp;
+}
+
+void updatePlayerStateStamp(DreamPlayer* p)
+{
+	updateDependencyStamp(&p->mStateStamp);
+}
+
+uint32_t getPlayerCommandStamp(DreamPlayer* p)
+{
+	return getDreamCommandActivityStamp(p->mCommandID);
+}
+
 int getPlayerTimeInState(DreamPlayer* p)
 {
 	return getDreamRegisteredStateTimeInState(p->mStateMachineID);
@@ -3922,16 +4021,11 @@ void setPlayerRelativeScaleY(DreamPlayer * p, double tScaleY)
 
 DreamPlayer * clonePlayerAsHelper(DreamPlayer * p)
 {
-	int helperIDInStore = stl_int_map_get_id();
-	DreamPlayer* helper = &gPlayerDefinition.mHelperStore[helperIDInStore];
-	*helper = *p;
-	helper->mHelperIDInStore = helperIDInStore;
+	DreamPlayer* helper = getFreeHelperPoolSlot(p->mRoot);
+	copyPlayerToHelperPoolSlot(helper, p);
 
 	resetHelperState(helper);
-	setPlayerExternalDependencies(helper);
-	loadPlayerShadow(helper);
-	loadPlayerReflection(helper);
-	loadPlayerDebug(helper);
+	activateHelperPoolSlot(helper);
 	setDreamRegisteredStateToHelperMode(helper->mStateMachineID);
 
 	helper->mParent = p;
@@ -4004,7 +4098,8 @@ void destroyPlayer(DreamPlayer * p)
 	removePlayerBoundHelpers(p);
 	removePlayerBindingInternal(p);
 	movePlayerHelpersToParent(p);
-	destroyGeneralPlayer(p);
+	removeAllExplodsForPlayer(p);
+	parkHelperPoolSlot(p);
 }
 
 int getPlayerID(DreamPlayer * p)
@@ -4034,7 +4129,7 @@ static void addProjectileToRoot(DreamPlayer* tPlayer, DreamPlayer* tProjectile)
 DreamPlayer * createNewProjectileFromPlayer(DreamPlayer * p)
 {
 	int helperIDInStore = stl_int_map_get_id();
-	DreamPlayer* helper = &gPlayerDefinition.mHelperStore[helperIDInStore];
+	DreamPlayer* helper = &gPlayerDefinition.mProjectileStore[helperIDInStore];
 	*helper = *p;
 	helper->mHelperIDInStore = helperIDInStore;
 
@@ -4374,7 +4469,8 @@ void setPlayerScreenBoundForever(DreamPlayer * p, int tIsBoundToScreen)
 }
 
 static void resetPlayerHitBySlotGeneral(DreamPlayer * p, int tSlot) {
-	p->mNotHitBy[tSlot].mFlag2Amount = 0;
+	p->mNotHitBy[tSlot].mStateTypeFlags = 0;
+	p->mNotHitBy[tSlot].mAttackFlags = 0;
 	p->mNotHitBy[tSlot].mNow = 0;
 	p->mNotHitBy[tSlot].mIsActive = 1;
 }
@@ -4393,40 +4489,17 @@ void resetPlayerNotHitBy(DreamPlayer * p, int tSlot)
 
 void setPlayerNotHitByFlag1(DreamPlayer * p, int tSlot, char * tFlag)
 {
-	strcpy(p->mNotHitBy[tSlot].mFlag1, tFlag);
-	turnStringLowercase(p->mNotHitBy[tSlot].mFlag1);
-}
-
-static string copyOverCleanFlag2(char* tSrc) {
-	int n = strlen(tSrc);
-
-	string ret;
-	int i;
-	for (i = 0; i < n; i++) {
-		if (tSrc[i] == ' ') continue;
-		ret.push_back(tSrc[i]);
-	}
-	return ret;
+	p->mNotHitBy[tSlot].mStateTypeFlags = parseHitDefAttributeStateTypeFlags(tFlag);
 }
 
 void addPlayerNotHitByFlag2(DreamPlayer * p, int tSlot, char * tFlag)
 {
-
-	if (p->mNotHitBy[tSlot].mFlag2Amount >= MAXIMUM_HITSLOT_FLAG_2_AMOUNT) {
-		logWarningFormat("Too many nothitby flags. Ignoring flag %s.", tFlag);
-		return;
-	}
-
-	string nFlag = copyOverCleanFlag2(tFlag);
-	if (nFlag.size() != 2) {
+	uint32_t flag;
+	if (!parseHitDefAttributeAttackFlag(tFlag, &flag)) {
 		logErrorFormat("Unable to parse nothitby flag %s. Ignoring.", tFlag);
 		return;
 	}
-
-	turnStringLowercase(nFlag);
-
-	strcpy(p->mNotHitBy[tSlot].mFlag2[p->mNotHitBy[tSlot].mFlag2Amount], nFlag.data());
-	p->mNotHitBy[tSlot].mFlag2Amount++;
+	p->mNotHitBy[tSlot].mAttackFlags |= flag;
 }
 
 void setPlayerNotHitByTime(DreamPlayer * p, int tSlot, int tTime)
@@ -4434,6 +4507,46 @@ void setPlayerNotHitByTime(DreamPlayer * p, int tSlot, int tTime)
 	p->mNotHitBy[tSlot].mTime = tTime;
 }
 
+void benchmarkPlayerHitAttributeSlots(int tSlotAmount, int tRepetitions)
+{
+	static const char* flag1s[] = { "S", "C", "A", "SC", "CA", "SCA", "" };
+	static const char* flag2s[] = { "NA", "SA", "HA", "NT", "ST", "HT", "NP", "SP", "HP" };
+	static const int flag1Amount = sizeof flag1s / sizeof flag1s[0];
+	static const int flag2Amount = sizeof flag2s / sizeof flag2s[0];
+	if (tSlotAmount < 1 || tRepetitions < 1) return;
+
+	vector<DreamHitDefAttributeSlot> slots(tSlotAmount);
+	int i, j;
+	for (i = 0; i < tSlotAmount; i++) {
+		DreamHitDefAttributeSlot* slot = &slots[i];
+		slot->mIsActive = 1;
+		slot->mIsHitBy = i % 2;
+		slot->mStateTypeFlags = parseHitDefAttributeStateTypeFlags(flag1s[i % flag1Amount]);
+		slot->mAttackFlags = 0;
+		for (j = 0; j < 1 + i % 4; j++) {
+			uint32_t flag;
+			parseHitDefAttributeAttackFlag(flag2s[(i + j * 2) % flag2Amount], &flag);
+			slot->mAttackFlags |= flag;
+		}
+	}
+
+	static const DreamMugenStateType stateTypes[] = { MUGEN_STATE_TYPE_STANDING, MUGEN_STATE_TYPE_CROUCHING, MUGEN_STATE_TYPE_AIR };
+	int64_t eligibleAmount = 0;
+	const auto startTime = std::chrono::steady_clock::now();
+	for (i = 0; i < tRepetitions; i++) {
+		for (j = 0; j < 27; j++) {
+			const uint32_t stateTypeFlag = getHitDefAttributeStateTypeFlag(stateTypes[j / 9]);
+			const uint32_t attackFlag = getHitDefAttributeAttackFlag(MugenAttackClass((j / 3) % 3), MugenAttackType(j % 3));
+			for (const auto& slot : slots) {
+				eligibleAmount += checkSingleNoHitDefSlotFlags(&slot, stateTypeFlag, attackFlag);
+			}
+		}
+	}
+	const auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+	const double checkAmount = double(tRepetitions) * 27 * tSlotAmount;
+	logFormat("Hit eligibility over %d nothitby slots, %.0f slot checks: %.2f ns per check, %.0f eligible.", tSlotAmount, checkAmount, duration / checkAmount, double(eligibleAmount));
+}
+
 int getDefaultPlayerSparkNumberIsInPlayerFile(DreamPlayer * p)
 {
 	return p->mHeader->mFiles.mConstants.mHeader.mIsSparkNoInPlayerFile;
@@ -4569,7 +4682,7 @@ int isPlayer(DreamPlayer * p)
 int isGeneralPlayer(DreamPlayer * p)
 {
 	if (!p) return 0;
-	if ((isPlayerHelper(p) || isPlayerProjectile(p)) && !stl_map_contains(gPlayerDefinition.mHelperStore, p->mHelperIDInStore)) return 0;
+	if (isPlayerProjectile(p) && !stl_map_contains(gPlayerDefinition.mProjectileStore, p->mHelperIDInStore)) return 0;
 	return !isPlayerDestroyed(p);
 }
 
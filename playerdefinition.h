@@ -129,6 +129,8 @@ struct DreamPlayer {
 	int mSystemVars[100];
 	double mFloatVars[100];
 	double mSystemFloatVars[100];
+	uint32_t mVariableStamp;
+	uint32_t mStateStamp;
 
 	int mCommandID;
 	int mStateMachineID;
@@ -261,6 +263,7 @@ struct DreamPlayer {
 
 void loadPlayers(MemoryStack* tMemoryStack);
 void loadPlayerSprites();
+void skipPlayerSprites();
 void unloadPlayers();
 void resetPlayers();
 void resetPlayersEntirely();
@@ -317,6 +320,11 @@ double getPlayerSystemFloatVariable(DreamPlayer* p, int tIndex);
 void setPlayerSystemFloatVariable(DreamPlayer* p, int tIndex, double tValue);
 void addPlayerSystemFloatVariable(DreamPlayer* p, int tIndex, double tValue);
 
+uint32_t getPlayerVariableStamp(DreamPlayer* p);
+uint32_t getPlayerStateStamp(DreamPlayer* p);
+void updatePlayerStateStamp(DreamPlayer* p);
+uint32_t getPlayerCommandStamp(DreamPlayer* p);
+
 int getPlayerTimeInState(DreamPlayer* p);
 int getPlayerAnimationNumber(DreamPlayer* p);
 int getPlayerAnimationStep(DreamPlayer* p);
@@ -703,6 +711,7 @@ void resetPlayerNotHitBy(DreamPlayer* p, int tSlot);
 void setPlayerNotHitByFlag1(DreamPlayer* p, int tSlot, char* tFlag);
 void addPlayerNotHitByFlag2(DreamPlayer* p, int tSlot, char* tFlag);
 void setPlayerNotHitByTime(DreamPlayer* p, int tSlot, int tTime);
+void benchmarkPlayerHitAttributeSlots(int tSlotAmount, int tRepetitions);
 
 int getDefaultPlayerSparkNumberIsInPlayerFile(DreamPlayer* p);
 int getDefaultPlayerSparkNumber(DreamPlayer* p);
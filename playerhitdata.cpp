@@ -1,6 +1,7 @@
 #include "playerhitdata.h"
 
 #include <assert.h>
+#include <ctype.h>
 
 #include <prism/datastructures.h>
 #include <prism/log.h>
@@ -184,19 +185,25 @@ void setHitDataHitFlag(DreamPlayer* tPlayer, const char * tFlag)
 	strcpy(e->mHitFlag, tFlag);
 }
 
-char* getActiveHitDataGuardFlag(DreamPlayer * tPlayer)
+uint32_t getActiveHitDataGuardFlags(DreamPlayer * tPlayer)
 {
 	assert(isGeneralPlayer(tPlayer));
 	PlayerHitData* e = &tPlayer->mActiveHitData;
-	return e->mGuardFlag;
+	return e->mGuardFlags;
 }
 
 void setHitDataGuardFlag(DreamPlayer* tPlayer, const char * tFlag)
 {
 	assert(isGeneralPlayer(tPlayer));
 	PlayerHitData* e = &tPlayer->mPassiveHitData;
-	assert(strlen(tFlag) < sizeof e->mGuardFlag);
-	strcpy(e->mGuardFlag, tFlag);
+	e->mGuardFlags = 0;
+	for (; *tFlag; tFlag++) {
+		const char c = char(tolower((unsigned char)*tFlag));
+		if (c == 'h') e->mGuardFlags |= MUGEN_GUARD_FLAG_HIGH;
+		else if (c == 'l') e->mGuardFlags |= MUGEN_GUARD_FLAG_LOW;
+		else if (c == 'a') e->mGuardFlags |= MUGEN_GUARD_FLAG_AIR;
+		else if (c == 'm') e->mGuardFlags |= MUGEN_GUARD_FLAG_MID;
+	}
 }
 
 void setHitDataAffectTeam(DreamPlayer* tPlayer, MugenAffectTeam tAffectTeam)
@@ -1569,26 +1576,15 @@ void resetHitDataReversalDef(DreamPlayer * tPlayer)
 	assert(isGeneralPlayer(tPlayer));
 	PlayerHitData* e = &tPlayer->mPassiveHitData;
 	e->mReversalDef.mIsActive = 1;
-	e->mReversalDef.mFlag2Amount = 0;
+	e->mReversalDef.mStateTypeFlags = 0;
+	e->mReversalDef.mAttackFlags = 0;
 }
 
 void setHitDataReversalDefFlag1(DreamPlayer * tPlayer, char * tFlag)
 {
 	assert(isGeneralPlayer(tPlayer));
 	PlayerHitData* e = &tPlayer->mPassiveHitData;
-	strcpy(e->mReversalDef.mFlag1, tFlag);
-}
-
-static void copyOverCleanFlag2(char* tDst, char* tSrc) {
-	int n = strlen(tSrc);
-
-	int o = 0;
-	int i;
-	for (i = 0; i < n; i++) {
-		if (tSrc[i] == ' ') continue;
-		tDst[o++] = tSrc[i];
-	}
-	tDst[o] = '\0';
+	e->mReversalDef.mStateTypeFlags = parseHitDefAttributeStateTypeFlags(tFlag);
 }
 
 void addHitDataReversalDefFlag2(DreamPlayer * tPlayer, char * tFlag)
@@ -1596,25 +1592,78 @@ void addHitDataReversalDefFlag2(DreamPlayer * tPlayer, char * tFlag)
 	assert(isGeneralPlayer(tPlayer));
 	PlayerHitData* e = &tPlayer->mPassiveHitData;
 
-	char* nFlag = (char*)allocMemory(strlen(tFlag) + 5);
-	copyOverCleanFlag2(nFlag, tFlag);
-	if (strlen(nFlag) != 2) {
-		logWarningFormat("Unparseable reversal definition flag: %s. Ignore.", nFlag);
-		freeMemory(nFlag);
+	uint32_t flag;
+	if (!parseHitDefAttributeAttackFlag(tFlag, &flag)) {
+		logWarningFormat("Unparseable reversal definition flag: %s. Ignore.", tFlag);
 		return;
 	}
-	turnStringLowercase(nFlag);
+	e->mReversalDef.mAttackFlags |= flag;
+}
 
-	if (e->mReversalDef.mFlag2Amount >= MAXIMUM_HITSLOT_FLAG_2_AMOUNT) {
-		logWarningFormat("Too many reversal definition flags. Ignoring current flag %s.", nFlag);
-		freeMemory(nFlag);
-		return;
+uint32_t getHitDefAttributeStateTypeFlag(DreamMugenStateType tStateType)
+{
+	if (tStateType == MUGEN_STATE_TYPE_STANDING) return MUGEN_HIT_STATE_TYPE_FLAG_STANDING;
+	else if (tStateType == MUGEN_STATE_TYPE_CROUCHING) return MUGEN_HIT_STATE_TYPE_FLAG_CROUCHING;
+	else if (tStateType == MUGEN_STATE_TYPE_AIR) return MUGEN_HIT_STATE_TYPE_FLAG_AIR;
+	else return 0;
+}
+
+uint32_t getHitDefAttributeAttackFlag(MugenAttackClass tClass, MugenAttackType tType)
+{
+	if (tClass < MUGEN_ATTACK_CLASS_NORMAL || tClass > MUGEN_ATTACK_CLASS_HYPER) return 0;
+	if (tType < MUGEN_ATTACK_TYPE_ATTACK || tType > MUGEN_ATTACK_TYPE_PROJECTILE) return 0;
+	return 1u << (tClass * 3 + tType);
+}
+
+uint32_t parseHitDefAttributeStateTypeFlags(const char* tFlag)
+{
+	uint32_t ret = 0;
+	for (; *tFlag; tFlag++) {
+		const char c = char(tolower((unsigned char)*tFlag));
+		if (c == 's') ret |= MUGEN_HIT_STATE_TYPE_FLAG_STANDING;
+		else if (c == 'c') ret |= MUGEN_HIT_STATE_TYPE_FLAG_CROUCHING;
+		else if (c == 'a') ret |= MUGEN_HIT_STATE_TYPE_FLAG_AIR;
 	}
+	return ret;
+}
+
+static int parseHitDefAttributeAttackClass(char tLetter, MugenAttackClass* oClass) {
+	if (tLetter == 'n') *oClass = MUGEN_ATTACK_CLASS_NORMAL;
+	else if (tLetter == 's') *oClass = MUGEN_ATTACK_CLASS_SPECIAL;
+	else if (tLetter == 'h') *oClass = MUGEN_ATTACK_CLASS_HYPER;
+	else return 0;
+	return 1;
+}
+
+static int parseHitDefAttributeAttackType(char tLetter, MugenAttackType* oType) {
+	if (tLetter == 'a') *oType = MUGEN_ATTACK_TYPE_ATTACK;
+	else if (tLetter == 't') *oType = MUGEN_ATTACK_TYPE_THROW;
+	else if (tLetter == 'p') *oType = MUGEN_ATTACK_TYPE_PROJECTILE;
+	else return 0;
+	return 1;
+}
 
-	strcpy(e->mReversalDef.mFlag2[e->mReversalDef.mFlag2Amount], nFlag);
-	e->mReversalDef.mFlag2Amount++;
+int parseHitDefAttributeAttackFlag(const char* tFlag, uint32_t* oFlag)
+{
+	char letters[2];
+	int amount = 0;
+	for (; *tFlag; tFlag++) {
+		if (*tFlag == ' ') continue;
+		if (amount == 2) return 0;
+		letters[amount++] = char(tolower((unsigned char)*tFlag));
+	}
+	if (amount != 2) return 0;
 
-	freeMemory(nFlag);
+	// well-formed but unknown flags like "xa" are kept as matching nothing
+	MugenAttackClass attackClass;
+	MugenAttackType attackType;
+	if (!parseHitDefAttributeAttackClass(letters[0], &attackClass) || !parseHitDefAttributeAttackType(letters[1], &attackType)) {
+		*oFlag = 0;
+	}
+	else {
+		*oFlag = getHitDefAttributeAttackFlag(attackClass, attackType);
+	}
+	return 1;
 }
 
 void setPlayerHitOverride(DreamPlayer * tPlayer, DreamMugenStateType tStateType, MugenAttackClass tAttackClass, MugenAttackType tAttackType, int tStateNo, int tSlot, int tDuration, int tDoesForceAir)
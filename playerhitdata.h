@@ -1,5 +1,7 @@
 #pragma once
 
+#include <stdint.h>
+
 #include <prism/actorhandler.h>
 
 #include "mugenstatereader.h"
@@ -51,14 +53,24 @@ typedef enum {
 	MUGEN_HIT_PRIORITY_MISS,
 } MugenHitPriorityType;
 
-#define MAXIMUM_HITSLOT_FLAG_2_AMOUNT 10
+typedef enum {
+	MUGEN_HIT_STATE_TYPE_FLAG_STANDING = 1 << 0,
+	MUGEN_HIT_STATE_TYPE_FLAG_CROUCHING = 1 << 1,
+	MUGEN_HIT_STATE_TYPE_FLAG_AIR = 1 << 2,
+} MugenHitStateTypeFlag;
+
+typedef enum {
+	MUGEN_GUARD_FLAG_HIGH = 1 << 0,
+	MUGEN_GUARD_FLAG_LOW = 1 << 1,
+	MUGEN_GUARD_FLAG_AIR = 1 << 2,
+	MUGEN_GUARD_FLAG_MID = 1 << 3,
+} MugenGuardFlag;
 
 typedef struct {
 	int mIsActive;
 
-	char mFlag1[10];
-	char mFlag2[MAXIMUM_HITSLOT_FLAG_2_AMOUNT][10];
-	int mFlag2Amount;
+	uint32_t mStateTypeFlags; // MugenHitStateTypeFlag
+	uint32_t mAttackFlags; // one bit per attack class and type, see getHitDefAttributeAttackFlag
 
 	int mNow;
 	int mTime;
@@ -74,7 +86,7 @@ typedef struct {
 	MugenAttackType mAttackType;
 
 	char mHitFlag[10];
-	char mGuardFlag[10];
+	uint32_t mGuardFlags; // MugenGuardFlag
 
 	MugenAffectTeam mAffectTeam;
 	MugenHitAnimationType mAnimationType;
@@ -255,7 +267,7 @@ MugenAttackType getActiveHitDataAttackType(DreamPlayer* tPlayer);
 void setHitDataAttackType(DreamPlayer* tPlayer, MugenAttackType tType);
 
 void setHitDataHitFlag(DreamPlayer* tPlayer, const char* tFlag);
-char* getActiveHitDataGuardFlag(DreamPlayer* tPlayer);
+uint32_t getActiveHitDataGuardFlags(DreamPlayer* tPlayer);
 void setHitDataGuardFlag(DreamPlayer* tPlayer, const char* tFlag);
 void setHitDataAffectTeam(DreamPlayer* tPlayer, MugenAffectTeam tAffectTeam);
 
@@ -482,6 +494,11 @@ void resetHitDataReversalDef(DreamPlayer* tPlayer);
 void setHitDataReversalDefFlag1(DreamPlayer* tPlayer, char* tFlag);
 void addHitDataReversalDefFlag2(DreamPlayer* tPlayer, char* tFlag);
 
+uint32_t getHitDefAttributeStateTypeFlag(DreamMugenStateType tStateType);
+uint32_t getHitDefAttributeAttackFlag(MugenAttackClass tClass, MugenAttackType tType);
+uint32_t parseHitDefAttributeStateTypeFlags(const char* tFlag);
+int parseHitDefAttributeAttackFlag(const char* tFlag, uint32_t* oFlag);
+
 void setPlayerHitOverride(DreamPlayer* tPlayer, DreamMugenStateType tStateType, MugenAttackClass tAttackClass, MugenAttackType tAttackType, int tStateNo, int tSlot, int tDuration, int tDoesForceAir);
 
 int hasMatchingHitOverride(DreamPlayer* tPlayer, DreamPlayer * tOtherPlayer);
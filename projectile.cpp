@@ -2,9 +2,10 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <vector>
 
-#include <prism/datastructures.h>
 #include <prism/math.h>
+#include <prism/physicshandler.h>
 #include <prism/log.h>
 
 #include "stage.h"
@@ -12,8 +13,6 @@
 using namespace std;
 
 typedef struct {
-	DreamPlayer* mPlayer;
-
 	int mID;
 	int mHitAnimation;
 	int mRemoveAnimation;
@@ -21,17 +20,14 @@ typedef struct {
 
 	Vector3D mScale;
 	int mRemoveAfterHit;
-	int mRemoveTime;
 
 	Vector3D mRemoveVelocity;
-	Vector3D mAcceleration;
 	Vector3D mVelocityMultipliers;
 
 	int mHitAmountBeforeVanishing;
 	int mMissTime;
 	int mPriority;
 	int mSpritePriority;
-	int mEdgeBound;
 	int mStageBound;
 	int mLowerBound;
 	int mUpperBound;
@@ -46,72 +42,131 @@ typedef struct {
 	int mAfterImageTime;
 	int mAfterImageLength;
 	int mAfterImage;
-
-	int mNow;
 } Projectile;
 
 static struct {
-	IntMap mProjectileList;
+	vector<Projectile> mProjectiles;
+
+	vector<DreamPlayer*> mPlayers;
+	vector<Position*> mPositions;
+	vector<Velocity*> mVelocities;
+	vector<Acceleration> mAccelerations;
+	vector<int> mEdgeBounds;
+	vector<int> mRemoveTimes;
+	vector<int> mNows;
+	vector<uint8_t> mIsActive;
+	vector<uint8_t> mIsOver;
+
+	vector<int> mFreeSlots;
+	int mSlotAmount;
 } gProjectileData;
 
+static void resetProjectileStore() {
+	gProjectileData.mProjectiles.clear();
+	gProjectileData.mPlayers.clear();
+	gProjectileData.mPositions.clear();
+	gProjectileData.mVelocities.clear();
+	gProjectileData.mAccelerations.clear();
+	gProjectileData.mEdgeBounds.clear();
+	gProjectileData.mRemoveTimes.clear();
+	gProjectileData.mNows.clear();
+	gProjectileData.mIsActive.clear();
+	gProjectileData.mIsOver.clear();
+	gProjectileData.mFreeSlots.clear();
+	gProjectileData.mSlotAmount = 0;
+}
+
 static void loadProjectileHandler(void* tData) {
 	(void)tData;
-	gProjectileData.mProjectileList = new_int_map();
+	resetProjectileStore();
 }
 
 static void unloadProjectileHandler(void* tData) {
 	(void)tData;
-	delete_int_map(&gProjectileData.mProjectileList);
+	resetProjectileStore();
 }
 
-static int updateProjectileDurationAndReturnIfOver(Projectile* e) {
-	if (e->mRemoveTime == -1) return 0;
+static int isProjectileSlotActive(int tSlot) {
+	return tSlot >= 0 && tSlot < gProjectileData.mSlotAmount && gProjectileData.mIsActive[tSlot];
+}
 
-	if (e->mNow >= e->mRemoveTime) {
-		removeProjectile(e->mPlayer);
-		return 1;
+static int addProjectileSlot() {
+	if (!gProjectileData.mFreeSlots.empty()) {
+		int slot = gProjectileData.mFreeSlots.back();
+		gProjectileData.mFreeSlots.pop_back();
+		return slot;
 	}
-	e->mNow++;
 
-	return 0;
+	int slot = (int)gProjectileData.mProjectiles.size();
+	gProjectileData.mProjectiles.push_back(Projectile());
+	gProjectileData.mPlayers.push_back(NULL);
+	gProjectileData.mPositions.push_back(NULL);
+	gProjectileData.mVelocities.push_back(NULL);
+	gProjectileData.mAccelerations.push_back(makePosition(0, 0, 0));
+	gProjectileData.mEdgeBounds.push_back(0);
+	gProjectileData.mRemoveTimes.push_back(-1);
+	gProjectileData.mNows.push_back(0);
+	gProjectileData.mIsActive.push_back(0);
+	gProjectileData.mIsOver.push_back(0);
+	return slot;
+}
+
+static void updateProjectileScreenEdges(double* oLeft, double* oRight) {
+	int i;
+	for (i = 0; i < 2; i++) {
+		int coordinateP = getPlayerCoordinateP(getRootPlayer(i));
+		oLeft[i] = getDreamStageLeftOfScreenBasedOnPlayer(coordinateP);
+		oRight[i] = getDreamStageRightOfScreenBasedOnPlayer(coordinateP);
+	}
 }
 
-static int updateProjectileScreenBoundAndReturnIfOver(Projectile* e) {
-	double left = getDreamStageLeftOfScreenBasedOnPlayer(getPlayerCoordinateP(e->mPlayer));
-	double right = getDreamStageRightOfScreenBasedOnPlayer(getPlayerCoordinateP(e->mPlayer));
+static void updateProjectileMotionAndBounds() {
+	double left[2], right[2];
+	updateProjectileScreenEdges(left, right);
+
+	const int amount = gProjectileData.mSlotAmount;
+	DreamPlayer** players = gProjectileData.mPlayers.data();
+	Position** positions = gProjectileData.mPositions.data();
+	Velocity** velocities = gProjectileData.mVelocities.data();
+	const Acceleration* accelerations = gProjectileData.mAccelerations.data();
+	const int* edgeBounds = gProjectileData.mEdgeBounds.data();
+	const int* removeTimes = gProjectileData.mRemoveTimes.data();
+	int* nows = gProjectileData.mNows.data();
+	const uint8_t* isActive = gProjectileData.mIsActive.data();
+	uint8_t* isOver = gProjectileData.mIsOver.data();
+
+	int i;
+	for (i = 0; i < amount; i++) {
+		if (!isActive[i]) continue;
+
+		if (!isPlayerPaused(players[i])) {
+			velocities[i]->x += getPlayerIsFacingRight(players[i]) ? accelerations[i].x : -accelerations[i].x;
+			velocities[i]->y += accelerations[i].y;
+		}
 
-	double x = getPlayerPositionX(e->mPlayer, getPlayerCoordinateP(e->mPlayer));
+		const int isTimed = removeTimes[i] != -1;
+		const int isExpired = isTimed && nows[i] >= removeTimes[i];
+		nows[i] += isTimed && !isExpired;
 
-	double overShootLeft = left - x;
-	double overShootRight = x - right;
-	double maxi = max(overShootLeft, overShootRight);
-	
-	if (maxi > e->mEdgeBound) {
-		removeProjectile(e->mPlayer);
-		return 1;
+		const int rootID = players[i]->mRootID;
+		const double x = positions[i]->x;
+		const double overShoot = max(left[rootID] - x, x - right[rootID]);
+		isOver[i] = (uint8_t)(isExpired || overShoot > edgeBounds[i]);
 	}
-
-	return 0;
 }
 
-static void updateProjectilePhysics(Projectile* e) {
-	addPlayerVelocityX(e->mPlayer, e->mAcceleration.x, getPlayerCoordinateP(e->mPlayer));
-	addPlayerVelocityY(e->mPlayer, e->mAcceleration.y, getPlayerCoordinateP(e->mPlayer));
-}
-
-
-static void updateSingleProjectile(void* tCaller, void* tData) {
-	(void)tCaller;
-	Projectile* e = (Projectile*)tData;
-
-	updateProjectilePhysics(e);
-	if (updateProjectileDurationAndReturnIfOver(e)) return;
-	if (updateProjectileScreenBoundAndReturnIfOver(e)) return;
+static void removeOverProjectiles() {
+	int i;
+	for (i = 0; i < gProjectileData.mSlotAmount; i++) {
+		if (!gProjectileData.mIsActive[i] || !gProjectileData.mIsOver[i]) continue;
+		removeProjectile(gProjectileData.mPlayers[i]);
+	}
 }
 
 static void updateProjectileHandler(void* tData) {
 	(void)tData;
-	int_map_map(&gProjectileData.mProjectileList, updateSingleProjectile, NULL);
+	updateProjectileMotionAndBounds();
+	removeOverProjectiles();
 }
 
 ActorBlueprint getProjectileHandler() {
@@ -119,31 +174,52 @@ ActorBlueprint getProjectileHandler() {
 };
 
 void addAdditionalProjectileData(DreamPlayer* tProjectile) {
-	Projectile* e = (Projectile*)allocMemory(sizeof(Projectile));
-	e->mNow = 0;
-	e->mPlayer = tProjectile;
-	tProjectile->mProjectileDataID = int_map_push_back_owned(&gProjectileData.mProjectileList, e);
+	int slot = addProjectileSlot();
+	gProjectileData.mProjectiles[slot] = Projectile();
+	gProjectileData.mPlayers[slot] = tProjectile;
+	gProjectileData.mPositions[slot] = getHandledPhysicsPositionReference(tProjectile->mPhysicsElement);
+	gProjectileData.mVelocities[slot] = getHandledPhysicsVelocityReference(tProjectile->mPhysicsElement);
+	gProjectileData.mAccelerations[slot] = makePosition(0, 0, 0);
+	gProjectileData.mEdgeBounds[slot] = 0;
+	gProjectileData.mRemoveTimes[slot] = -1;
+	gProjectileData.mNows[slot] = 0;
+	gProjectileData.mIsActive[slot] = 1;
+	gProjectileData.mIsOver[slot] = 0;
+	gProjectileData.mSlotAmount = max(gProjectileData.mSlotAmount, slot + 1);
+	tProjectile->mProjectileDataID = slot;
 }
 
 void removeAdditionalProjectileData(DreamPlayer* tProjectile) {
-	if (!int_map_contains(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID)) {
+	if (!isProjectileSlotActive(tProjectile->mProjectileDataID)) {
 		logWarningFormat("Error trying to remove projectile data for player %d %d who has no projectile data.", tProjectile->mRootID, tProjectile->mID);
 		return;
 	}
-	int_map_remove(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID);
+
+	int slot = tProjectile->mProjectileDataID;
+	gProjectileData.mIsActive[slot] = 0;
+	gProjectileData.mIsOver[slot] = 0;
+	gProjectileData.mPlayers[slot] = NULL;
+	gProjectileData.mPositions[slot] = NULL;
+	gProjectileData.mVelocities[slot] = NULL;
+	gProjectileData.mFreeSlots.push_back(slot);
+
+	while (gProjectileData.mSlotAmount > 0 && !gProjectileData.mIsActive[gProjectileData.mSlotAmount - 1]) {
+		gProjectileData.mSlotAmount--;
+	}
 }
 
 static void projectileHitAnimationFinishedCB(void* tCaller) {
-	Projectile* e = (Projectile*)tCaller;
-	e->mNow = 0;
-	e->mRemoveTime = 0;
+	DreamPlayer* p = (DreamPlayer*)tCaller;
+	if (!isProjectileSlotActive(p->mProjectileDataID)) return;
+	gProjectileData.mNows[p->mProjectileDataID] = 0;
+	gProjectileData.mRemoveTimes[p->mProjectileDataID] = 0;
 }
 
 
 void handleProjectileHit(DreamPlayer* tProjectile, int tWasGuarded, int tWasCanceled)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID);
+	assert(isProjectileSlotActive(tProjectile->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[tProjectile->mProjectileDataID];
 	DreamPlayer* owner = tProjectile->mParent;
 	owner->mHasLastContactProjectile = 1;
 	owner->mLastContactProjectileTime = 0;
@@ -155,7 +231,7 @@ void handleProjectileHit(DreamPlayer* tProjectile, int tWasGuarded, int tWasCanc
 	if (e->mHitAnimation != -1) {
 		changePlayerAnimation(tProjectile, e->mHitAnimation);
 		if (e->mRemoveAfterHit) {
-			setPlayerAnimationFinishedCallback(tProjectile, projectileHitAnimationFinishedCB, e);
+			setPlayerAnimationFinishedCallback(tProjectile, projectileHitAnimationFinishedCB, tProjectile);
 			setProjectileVelocity(tProjectile, 0, 0);
 		}
 	} else if (e->mRemoveAfterHit) {
@@ -165,15 +241,15 @@ void handleProjectileHit(DreamPlayer* tProjectile, int tWasGuarded, int tWasCanc
 
 void setProjectileID(DreamPlayer * tProjectile, int tID)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID);
+	assert(isProjectileSlotActive(tProjectile->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[tProjectile->mProjectileDataID];
 	e->mID = tID;
 }
 
 int getProjectileID(DreamPlayer * tProjectile)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, tProjectile->mProjectileDataID);
+	assert(isProjectileSlotActive(tProjectile->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[tProjectile->mProjectileDataID];
 	return e->mID;
 }
 
@@ -184,58 +260,57 @@ void setProjectileAnimation(DreamPlayer * p, int tAnimation)
 
 int getProjectileHitAnimation(DreamPlayer * p)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	return e->mHitAnimation;
 }
 
 void setProjectileHitAnimation(DreamPlayer * p, int tAnimation)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mHitAnimation = tAnimation;
 }
 
 int getProjectileRemoveAnimation(DreamPlayer * p)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	return e->mRemoveAnimation;
 }
 
 void setProjectileRemoveAnimation(DreamPlayer * p, int tAnimation)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mRemoveAnimation = tAnimation;
 }
 
 void setProjectileCancelAnimation(DreamPlayer * p, int tAnimation)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mCancelAnimation = tAnimation;
 }
 
 void setProjectileScale(DreamPlayer * p, double tX, double tY)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mScale = makePosition(tX, tY, 1);
 }
 
 void setProjectileRemoveAfterHit(DreamPlayer * p, int tValue)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mRemoveAfterHit = tValue;
 }
 
 void setProjectileRemoveTime(DreamPlayer * p, int tTime)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
-	e->mRemoveTime = tTime;
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	gProjectileData.mRemoveTimes[p->mProjectileDataID] = tTime;
 }
 
 void setProjectileVelocity(DreamPlayer * p, double tX, double tY)
@@ -246,71 +321,69 @@ void setProjectileVelocity(DreamPlayer * p, double tX, double tY)
 
 void setProjectileRemoveVelocity(DreamPlayer * p, double tX, double tY)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mRemoveVelocity = makePosition(tX, tY, 0);
 }
 
 void setProjectileAcceleration(DreamPlayer * p, double tX, double tY)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
-	e->mAcceleration = makePosition(tX, tY, 0);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	gProjectileData.mAccelerations[p->mProjectileDataID] = makePosition(tX, tY, 0);
 }
 
 void setProjectileVelocityMultipliers(DreamPlayer * p, double tX, double tY)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mVelocityMultipliers = makePosition(tX, tY, 1);
 }
 
 void setProjectileHitAmountBeforeVanishing(DreamPlayer * p, int tHitAmount)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mHitAmountBeforeVanishing = tHitAmount;
 }
 
 void setProjectilMisstime(DreamPlayer * p, int tMissTime)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mMissTime = tMissTime;
 }
 
 void setProjectilePriority(DreamPlayer * p, int tPriority)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mPriority = tPriority;
 }
 
 void setProjectileSpritePriority(DreamPlayer * p, int tSpritePriority)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mSpritePriority = tSpritePriority;
 }
 
 void setProjectileEdgeBound(DreamPlayer * p, int tEdgeBound)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
-	e->mEdgeBound = tEdgeBound;
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	gProjectileData.mEdgeBounds[p->mProjectileDataID] = tEdgeBound;
 }
 
 void setProjectileStageBound(DreamPlayer * p, int tStageBound)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mStageBound = tStageBound;
 }
 
 void setProjectileHeightBoundValues(DreamPlayer * p, int tLowerBound, int tUpperBound)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mLowerBound = tLowerBound;
 	e->mUpperBound = tUpperBound;
 }
@@ -322,57 +395,57 @@ void setProjectilePosition(DreamPlayer * p, Position tPosition)
 
 void setProjectileShadow(DreamPlayer * p, int tShadow)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mShadow = tShadow;
 }
 
 void setProjectileSuperMoveTime(DreamPlayer * p, int tSuperMoveTime)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mSuperMoveTime = tSuperMoveTime;
 }
 
 void setProjectilePauseMoveTime(DreamPlayer * p, int tPauseMoveTime)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mPauseMoveTime = tPauseMoveTime;
 }
 
 void setProjectileHasOwnPalette(DreamPlayer * p, int tValue)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mHasOwnPalette = tValue;
 }
 
 void setProjectileRemapPalette(DreamPlayer * p, int tGroup, int tItem)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mRemapPaletteGroup = tGroup;
 	e->mRemapPaletteItem = tItem;
 }
 
 void setProjectileAfterImageTime(DreamPlayer * p, int tAfterImageTime)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mAfterImageTime = tAfterImageTime;
 }
 
 void setProjectileAfterImageLength(DreamPlayer * p, int tAfterImageLength)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mAfterImageLength = tAfterImageLength;
 }
 
 void setProjectileAfterImage(DreamPlayer * p, int tAfterImage)
 {
-	assert(int_map_contains(&gProjectileData.mProjectileList, p->mProjectileDataID));
-	Projectile* e = (Projectile*)int_map_get(&gProjectileData.mProjectileList, p->mProjectileDataID);
+	assert(isProjectileSlotActive(p->mProjectileDataID));
+	Projectile* e = &gProjectileData.mProjectiles[p->mProjectileDataID];
 	e->mAfterImage = tAfterImage;
 }
@@ -21,6 +21,8 @@
 #include "mugenstagehandler.h"
 #include "mugenbackgroundstatehandler.h"
 #include "mugensound.h"
+#include "fileindex.h"
+#include "fightpreload.h"
 #include "tsf.h"
 
 using namespace std;
@@ -358,7 +360,7 @@ static void loadStageTextures(char* tPath) {
 	getPathToFile(path, tPath);
 	char sffFile[1024];
 	sprintf(sffFile, "%s%s", path, gStageData.mBackgroundDefinition.mSpritePath);
-	if (!isFile(sffFile)) {
+	if (!isIndexedFile(sffFile)) {
 		sprintf(sffFile, "assets/%s", gStageData.mBackgroundDefinition.mSpritePath);
 	}
 
@@ -400,7 +402,7 @@ static void loadStage(void* tData)
 	gStageData.mAnimations = loadMugenAnimationFile(gStageData.mDefinitionPath);
 
 	MugenDefScript s; 
-	loadMugenDefScript(&s, gStageData.mDefinitionPath);
+	loadPreloadedMugenDefScript(&s, gStageData.mDefinitionPath);
 
 	loadStageInfo(&s);
 	loadStageCamera(&s);
@@ -487,6 +489,11 @@ void setDreamStageMugenDefinition(const char * tPath, const char* tCustomMusicPa
 	strcpy(gStageData.mCustomMusicPath, tCustomMusicPath);
 }
 
+void getDreamStageMugenDefinitionPath(char* tDst)
+{
+	strcpy(tDst, gStageData.mDefinitionPath);
+}
+
 MugenAnimations * getStageAnimations()
 {
 	return &gStageData.mAnimations;
@@ -11,6 +11,7 @@
 
 
 void setDreamStageMugenDefinition(const char* tPath, const char* tCustomMusicPath);
+void getDreamStageMugenDefinitionPath(char* tDst);
 ActorBlueprint getDreamStageBP();
 
 MugenAnimations* getStageAnimations();
@@ -14,6 +14,7 @@
 #include "menubackground.h"
 #include "titlescreen.h"
 #include "playerdefinition.h"
+#include "fightpreload.h"
 
 typedef struct {
 	Position mPosition;
@@ -145,6 +146,8 @@ static void loadVersusMusic() {
 static void screenTimeFinishedCB(void* tCaller);
 
 static void loadVersusScreen() {
+	startFightPreload();
+
 	char folder[1024];
 	loadMugenDefScript(&gVersusScreenData.mScript, "assets/data/system.def");
 	gVersusScreenData.mAnimations = loadMugenAnimationFile("assets/data/system.def");